@@ -0,0 +1,151 @@
+#ifndef WLED_MOCK_ARDUINO_H
+#define WLED_MOCK_ARDUINO_H
+/*
+ * Minimal Arduino core for host (native) unit tests
+ * Only what the WLED sources compiled by the tests need. Time is simulated: tests advance mockMicros.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#undef unix // gnu++ predefines it, WLED uses it as a name
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define IRAM_ATTR
+#define PSTR(x) (x)
+#define F(x) (x)
+#define FPSTR(x) (x)
+#define SET_F(x) (x)
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(p)) // also used to read pointers from PROGMEM tables
+#define strcpy_P   strcpy
+#define strncpy_P  strncpy
+#define strcat_P   strcat
+#define strcmp_P   strcmp
+#define strncmp_P  strncmp
+#define strlen_P   strlen
+#define memcpy_P   memcpy
+#define sprintf_P  sprintf
+#define snprintf_P snprintf
+typedef char __FlashStringHelper;
+
+#define LOW    0
+#define HIGH   1
+#define INPUT  0
+#define OUTPUT 1
+
+#ifndef constrain
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#endif
+using std::min;
+using std::max;
+inline uint16_t word(uint8_t h, uint8_t l) { return (h << 8) | l; }
+#ifndef __APPLE__
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t n = strlen(src);
+  if (size) { size_t c = n < size ? n : size - 1; memcpy(dst, src, c); dst[c] = 0; }
+  return n;
+}
+#endif
+
+// simulated clock, tests advance it
+inline uint64_t mockMicros = 0;
+inline unsigned long millis() { return mockMicros / 1000; }
+inline unsigned long micros() { return mockMicros; }
+inline uint64_t micros64() { return mockMicros; }
+inline void delay(unsigned long ms) { mockMicros += ms * 1000ULL; }
+inline void delayMicroseconds(unsigned int us) { mockMicros += us; }
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void analogWrite(uint8_t, int) {}
+inline void analogWriteFreq(uint32_t) {}
+inline void analogWriteRange(uint32_t) {}
+inline double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcDetachPin(uint8_t) {}
+inline void ledcWrite(uint8_t, uint32_t) {}
+
+inline long random(long howbig) { return howbig ? ::rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t len) { size_t n = 0; while (len--) n += write(*buf++); return n; }
+    size_t write(const char *s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { char b[12]; snprintf(b, sizeof(b), "%d", v); return write(b); }
+    size_t println(const char *s = "") { return print(s) + print('\n'); }
+    template<typename... Args> size_t printf(const char *fmt, Args... args) { char b[256]; snprintf(b, sizeof(b), fmt, args...); return write(b); }
+    template<typename... Args> size_t printf_P(const char *fmt, Args... args) { return printf(fmt, args...); }
+};
+
+class String : public std::string {
+  public:
+    String() {}
+    String(const char *s) : std::string(s ? s : "") {}
+    String(const std::string &s) : std::string(s) {}
+    String(char c) : std::string(1, c) {}
+    String(int v) : std::string(std::to_string(v)) {}
+    String(unsigned v) : std::string(std::to_string(v)) {}
+    String(long v) : std::string(std::to_string(v)) {}
+    String(unsigned long v) : std::string(std::to_string(v)) {}
+    int indexOf(char c, size_t from = 0) const { auto p = find(c, from); return p == npos ? -1 : (int)p; }
+    int indexOf(const char *s, size_t from = 0) const { auto p = find(s, from); return p == npos ? -1 : (int)p; }
+    int lastIndexOf(char c) const { auto p = rfind(c); return p == npos ? -1 : (int)p; }
+    String substring(size_t from) const { return from < size() ? String(substr(from)) : String(); }
+    String substring(size_t from, size_t to) const { return from < size() ? String(substr(from, to > from ? to - from : 0)) : String(); }
+    char charAt(size_t i) const { return i < size() ? (*this)[i] : 0; }
+    bool equals(const char *s) const { return *this == s; }
+    bool startsWith(const char *s) const { return rfind(s, 0) == 0; }
+    bool endsWith(const char *s) const { size_t l = strlen(s); return size() >= l && compare(size() - l, l, s) == 0; }
+    long toInt() const { return atol(c_str()); }
+    unsigned length() const { return size(); }
+    void trim() { erase(0, find_first_not_of(" \t\r\n")); erase(find_last_not_of(" \t\r\n") + 1); }
+};
+inline String operator+(const String &a, const String &b) { return String(static_cast<const std::string&>(a) + static_cast<const std::string&>(b)); }
+inline String operator+(const String &a, const char *b)   { return String(static_cast<const std::string&>(a) + b); }
+inline String operator+(const char *a, const String &b)   { return String(a + static_cast<const std::string&>(b)); }
+inline String operator+(char a, const String &b)          { return String(std::string(1, a) + static_cast<const std::string&>(b)); }
+
+class IPAddress {
+  public:
+    IPAddress() : _a(0) {}
+    IPAddress(uint32_t a) : _a(a) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { _b[0] = a; _b[1] = b; _b[2] = c; _b[3] = d; }
+    operator uint32_t() const { return _a; }
+    bool operator==(const IPAddress &o) const { return _a == o._a; }
+    uint8_t operator[](int i) const { return _b[i]; }
+    uint8_t &operator[](int i) { return _b[i]; }
+    String toString() const { char b[16]; snprintf(b, sizeof(b), "%u.%u.%u.%u", _b[0], _b[1], _b[2], _b[3]); return String(b); }
+  private:
+    union { uint32_t _a; uint8_t _b[4]; }; // network byte order (little endian host)
+};
+
+// serial output is discarded
+class HardwareSerial : public Print {
+  public:
+    size_t write(uint8_t c) override { return 1; }
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() {}
+    operator bool() const { return true; }
+};
+inline HardwareSerial Serial;
+
+#endif
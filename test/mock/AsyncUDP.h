@@ -0,0 +1,7 @@
+#ifndef WLED_MOCK_ASYNCUDP_H
+#define WLED_MOCK_ASYNCUDP_H
+// host tests feed packets to the handlers directly, nothing is ever received here
+#include "Arduino.h"
+class AsyncUDPPacket;
+class AsyncUDP {};
+#endif
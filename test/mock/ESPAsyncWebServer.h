@@ -0,0 +1,111 @@
+#ifndef WLED_MOCK_ASYNCWEBSERVER_H
+#define WLED_MOCK_ASYNCWEBSERVER_H
+/*
+ * Host replacement for the WebSocket and response parts of ESPAsyncWebServer
+ * Clients record every message sent to them; tests deliver client messages by calling wsEvent().
+ * A request keeps the response sent to it, chunked responses are read by calling their filler.
+ */
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include "Arduino.h"
+
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+#define WS_CONTINUATION 0x00
+#define WS_TEXT         0x01
+#define WS_BINARY       0x02
+
+typedef struct {
+  uint8_t  message_opcode;
+  uint32_t num;
+  uint8_t  final;
+  uint8_t  masked;
+  uint8_t  opcode;
+  uint64_t len;
+  uint8_t  mask[4];
+  uint64_t index;
+} AwsFrameInfo;
+
+class AsyncWebSocketMessageBuffer {
+  public:
+    std::vector<uint8_t> data;
+    explicit AsyncWebSocketMessageBuffer(size_t len) : data(len) {}
+    uint8_t *get() { return data.data(); }
+    size_t length() const { return data.size(); }
+    void lock() {}
+    void unlock() {}
+};
+
+class AsyncWebSocketClient {
+  public:
+    explicit AsyncWebSocketClient(uint32_t id) : _id(id) {}
+    uint32_t id() const { return _id; }
+    size_t queueLength() const { return queued; }
+    // messages are taken ownership of, like the real client does
+    void binary(AsyncWebSocketMessageBuffer *b) { binaries.push_back(b->data); delete b; }
+    void text(const char *s) { texts.push_back(s); }
+    void text(AsyncWebSocketMessageBuffer *b) { texts.push_back(std::string((const char*)b->get(), b->length())); }
+
+    std::vector<std::vector<uint8_t>> binaries;
+    std::vector<std::string> texts;
+    size_t queued = 0; // messages "in flight", tests raise it to simulate a slow client
+  private:
+    uint32_t _id;
+};
+
+class AsyncWebSocket {
+  public:
+    std::vector<AsyncWebSocketClient*> clients;
+    AsyncWebSocketClient *client(uint32_t id) { for (auto c : clients) if (c->id() == id) return c; return nullptr; }
+    size_t count() const { return clients.size(); }
+    AsyncWebSocketMessageBuffer *makeBuffer(size_t len) { return new AsyncWebSocketMessageBuffer(len); }
+    void textAll(AsyncWebSocketMessageBuffer *b) { for (auto c : clients) c->text(b); }
+    void closeAll(uint16_t code = 0) {}
+    void cleanupClients(uint16_t maxClients = 8) {}
+    void _cleanBuffers() {}
+};
+
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+
+class AsyncWebServerResponse {
+  public:
+    int code = 200;
+    String contentType;
+    size_t contentLength = 0;
+    String content;
+    AwsResponseFiller filler;
+    void addHeader(const String &name, const String &value) {}
+};
+
+class AsyncWebServerRequest {
+  public:
+    std::unique_ptr<AsyncWebServerResponse> response; // last response sent
+    AsyncWebServerResponse *beginResponse(const String &contentType, size_t len, AwsResponseFiller filler) {
+      AsyncWebServerResponse *r = new AsyncWebServerResponse();
+      r->contentType = contentType;
+      r->contentLength = len;
+      r->filler = filler;
+      return r;
+    }
+    void send(AsyncWebServerResponse *r) { response.reset(r); }
+    void send(int code, const String &contentType, const String &content) {
+      send(new AsyncWebServerResponse());
+      response->code = code;
+      response->contentType = contentType;
+      response->content = content;
+      response->contentLength = content.size();
+    }
+    // body of a chunked response, read in chunks of chunkSize like the server does
+    String body(size_t chunkSize = 1460) {
+      if (!response || !response->filler) return response ? response->content : String();
+      String s;
+      std::vector<uint8_t> buf(chunkSize);
+      size_t n;
+      while ((n = response->filler(buf.data(), chunkSize, s.size())) > 0) s.append((const char*)buf.data(), n);
+      return s;
+    }
+};
+
+#endif
@@ -0,0 +1,2 @@
+// host tests have no Ethernet (see WiFi.h)
+#include "WiFi.h"
@@ -0,0 +1,202 @@
+#ifndef WLED_MOCK_FASTLED_H
+#define WLED_MOCK_FASTLED_H
+/*
+ * Host replacement for the subset of FastLED 3.6 used by FX_fcn.cpp and FX_2Dfcn.cpp
+ * lib8tion math, CRGB/CHSV and 16 entry palettes follow FastLED's C implementation (FASTLED_SCALE8_FIXED == 1).
+ * Of the built-in palettes only RainbowColors_p and PartyColors_p carry FastLED's values, the others alias them.
+ */
+
+#include "Arduino.h"
+
+#define FASTLED_SCALE8_FIXED 1
+
+typedef uint8_t  fract8;
+typedef uint16_t fract16;
+typedef uint16_t accum88;
+typedef int16_t  saccum87;
+
+// lib8tion
+inline uint8_t scale8(uint8_t i, fract8 scale) { return (uint16_t(i) * (1 + uint16_t(scale))) >> 8; }
+inline uint8_t scale8_video(uint8_t i, fract8 scale) { return ((uint16_t(i) * scale) >> 8) + ((i && scale) ? 1 : 0); }
+inline uint16_t scale16(uint16_t i, fract16 scale) { return (uint32_t(i) * (1 + uint32_t(scale))) >> 16; }
+inline uint8_t qadd8(uint8_t i, uint8_t j) { unsigned t = i + j; return t > 255 ? 255 : t; }
+inline uint8_t qsub8(uint8_t i, uint8_t j) { int t = i - j; return t < 0 ? 0 : t; }
+inline uint8_t dim8_video(uint8_t x) { return scale8_video(x, x); }
+
+inline uint16_t rand16seed = 1337;
+inline uint8_t random8() { rand16seed = rand16seed * 2053 + 13849; return uint8_t(rand16seed + (rand16seed >> 8)); }
+inline uint8_t random8(uint8_t lim) { return (uint16_t(random8()) * lim) >> 8; }
+inline uint8_t random8(uint8_t min, uint8_t lim) { return random8(lim - min) + min; }
+inline uint16_t random16() { rand16seed = rand16seed * 2053 + 13849; return rand16seed; }
+inline uint16_t random16(uint16_t lim) { return (uint32_t(random16()) * lim) >> 16; }
+inline uint16_t random16(uint16_t min, uint16_t lim) { return random16(lim - min) + min; }
+inline void random16_set_seed(uint16_t seed) { rand16seed = seed; }
+inline uint16_t random16_get_seed() { return rand16seed; }
+
+struct CHSV {
+  uint8_t h, s, v;
+  CHSV() : h(0), s(0), v(0) {}
+  CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+struct CRGB {
+  union {
+    struct { uint8_t r, g, b; };
+    struct { uint8_t red, green, blue; };
+    uint8_t raw[3];
+  };
+  enum HTMLColorCode { Black = 0x000000, White = 0xFFFFFF };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t colorcode) : r(colorcode >> 16), g(colorcode >> 8), b(colorcode) {}
+  CRGB(HTMLColorCode colorcode) : CRGB(uint32_t(colorcode)) {}
+  CRGB(const CHSV &hsv);
+
+  uint8_t &operator[](uint8_t x) { return raw[x]; }
+  const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+  CRGB &nscale8(uint8_t scaledown) { r = scale8(r, scaledown); g = scale8(g, scaledown); b = scale8(b, scaledown); return *this; }
+  CRGB &nscale8_video(uint8_t scaledown) { r = scale8_video(r, scaledown); g = scale8_video(g, scaledown); b = scale8_video(b, scaledown); return *this; }
+  CRGB &fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+  CRGB &operator+=(const CRGB &rhs) { r = qadd8(r, rhs.r); g = qadd8(g, rhs.g); b = qadd8(b, rhs.b); return *this; }
+  CRGB &operator-=(const CRGB &rhs) { r = qsub8(r, rhs.r); g = qsub8(g, rhs.g); b = qsub8(b, rhs.b); return *this; }
+  bool operator==(const CRGB &rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+  bool operator!=(const CRGB &rhs) const { return !(*this == rhs); }
+  explicit operator bool() const { return r || g || b; }
+};
+
+// simple sextant HSV conversion; only used for random palettes, which the tests do not compare against FastLED
+inline CRGB::CRGB(const CHSV &hsv) {
+  uint8_t region = hsv.h / 43, rem = (hsv.h - region * 43) * 6;
+  uint8_t p = scale8(hsv.v, 255 - hsv.s);
+  uint8_t q = scale8(hsv.v, 255 - scale8(hsv.s, rem));
+  uint8_t t = scale8(hsv.v, 255 - scale8(hsv.s, 255 - rem));
+  switch (region) {
+    case 0:  r = hsv.v; g = t; b = p; break;
+    case 1:  r = q; g = hsv.v; b = p; break;
+    case 2:  r = p; g = hsv.v; b = t; break;
+    case 3:  r = p; g = q; b = hsv.v; break;
+    case 4:  r = t; g = p; b = hsv.v; break;
+    default: r = hsv.v; g = p; b = q; break;
+  }
+}
+
+typedef enum { NOBLEND = 0, LINEARBLEND = 1 } TBlendType;
+typedef uint32_t TProgmemRGBPalette16[16];
+typedef const uint8_t *TDynamicRGBGradientPalette_bytes;
+
+inline void fill_solid(CRGB *leds, int numToFill, const CRGB &color) { for (int i = 0; i < numToFill; i++) leds[i] = color; }
+
+inline void fill_gradient_RGB(CRGB *leds, uint16_t startpos, CRGB startcolor, uint16_t endpos, CRGB endcolor) {
+  if (endpos < startpos) { std::swap(endpos, startpos); std::swap(endcolor, startcolor); }
+  saccum87 rdistance87 = (endcolor.r - startcolor.r) << 7;
+  saccum87 gdistance87 = (endcolor.g - startcolor.g) << 7;
+  saccum87 bdistance87 = (endcolor.b - startcolor.b) << 7;
+  uint16_t pixeldistance = endpos - startpos;
+  int16_t divisor = pixeldistance ? pixeldistance : 1;
+  saccum87 rdelta87 = (rdistance87 / divisor) * 2;
+  saccum87 gdelta87 = (gdistance87 / divisor) * 2;
+  saccum87 bdelta87 = (bdistance87 / divisor) * 2;
+  accum88 r88 = startcolor.r << 8, g88 = startcolor.g << 8, b88 = startcolor.b << 8;
+  for (uint16_t i = startpos; i <= endpos; ++i) {
+    leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+    r88 += rdelta87; g88 += gdelta87; b88 += bdelta87;
+  }
+}
+
+class CRGBPalette16 {
+  public:
+    CRGB entries[16];
+    CRGBPalette16() {}
+    CRGBPalette16(const CRGB &c1) { fill_solid(entries, 16, c1); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2) { fill_gradient_RGB(entries, 0, c1, 15, c2); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3) {
+      fill_gradient_RGB(entries, 0, c1, 8, c2);
+      fill_gradient_RGB(entries, 8, c2, 15, c3);
+    }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4) {
+      fill_gradient_RGB(entries, 0, c1, 5, c2);
+      fill_gradient_RGB(entries, 5, c2, 10, c3);
+      fill_gradient_RGB(entries, 10, c3, 15, c4);
+    }
+    CRGBPalette16(const CHSV &c1, const CHSV &c2, const CHSV &c3, const CHSV &c4) : CRGBPalette16(CRGB(c1), CRGB(c2), CRGB(c3), CRGB(c4)) {}
+    CRGBPalette16(const CRGB &c00, const CRGB &c01, const CRGB &c02, const CRGB &c03, const CRGB &c04, const CRGB &c05, const CRGB &c06, const CRGB &c07,
+                  const CRGB &c08, const CRGB &c09, const CRGB &c10, const CRGB &c11, const CRGB &c12, const CRGB &c13, const CRGB &c14, const CRGB &c15) {
+      const CRGB *c[16] = {&c00, &c01, &c02, &c03, &c04, &c05, &c06, &c07, &c08, &c09, &c10, &c11, &c12, &c13, &c14, &c15};
+      for (int i = 0; i < 16; i++) entries[i] = *c[i];
+    }
+    CRGBPalette16(const TProgmemRGBPalette16 &rhs) { for (int i = 0; i < 16; i++) entries[i] = CRGB(rhs[i]); }
+    CRGBPalette16 &operator=(const TProgmemRGBPalette16 &rhs) { for (int i = 0; i < 16; i++) entries[i] = CRGB(rhs[i]); return *this; }
+
+    bool operator==(const CRGBPalette16 &rhs) const { return memcmp(entries, rhs.entries, sizeof(entries)) == 0; }
+    bool operator!=(const CRGBPalette16 &rhs) const { return !(*this == rhs); }
+    CRGB &operator[](uint8_t x) { return entries[x]; }
+    const CRGB &operator[](uint8_t x) const { return entries[x]; }
+
+    CRGBPalette16 &loadDynamicGradientPalette(TDynamicRGBGradientPalette_bytes gpal) {
+      uint16_t count = 0;
+      while (gpal[count * 4] != 255) count++;
+      count++;
+      int lastSlotUsed = -1;
+      CRGB rgbstart(gpal[1], gpal[2], gpal[3]);
+      int indexstart = 0;
+      for (const uint8_t *ent = gpal; indexstart < 255; ) {
+        ent += 4;
+        int indexend = ent[0];
+        CRGB rgbend(ent[1], ent[2], ent[3]);
+        int istart8 = indexstart / 16, iend8 = indexend / 16;
+        if (count < 16) {
+          if (istart8 <= lastSlotUsed && lastSlotUsed < 15) {
+            istart8 = lastSlotUsed + 1;
+            if (iend8 < istart8) iend8 = istart8;
+          }
+          lastSlotUsed = iend8;
+        }
+        fill_gradient_RGB(entries, istart8, rgbstart, iend8, rgbend);
+        indexstart = indexend;
+        rgbstart = rgbend;
+      }
+      return *this;
+    }
+};
+
+inline CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND) {
+  uint8_t hi4 = index >> 4, lo4 = index & 0x0F;
+  CRGB c = pal[hi4];
+  if (lo4 && blendType != NOBLEND) {
+    const CRGB &n = pal[(hi4 + 1) & 0x0F];
+    uint8_t f2 = lo4 << 4, f1 = 255 - f2;
+    for (int i = 0; i < 3; i++) c.raw[i] = scale8(c.raw[i], f1) + scale8(n.raw[i], f2);
+  }
+  if (brightness != 255) {
+    if (brightness) { ++brightness; for (int i = 0; i < 3; i++) if (c.raw[i]) c.raw[i] = scale8(c.raw[i], brightness); }
+    else c = CRGB(0, 0, 0);
+  }
+  return c;
+}
+
+inline uint8_t nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges) {
+  uint8_t *p1 = current.entries[0].raw, *p2 = target.entries[0].raw;
+  uint8_t changes = 0;
+  for (unsigned i = 0; i < sizeof(current.entries); ++i) {
+    if (p1[i] == p2[i]) continue;
+    if (p1[i] < p2[i]) { ++p1[i]; ++changes; }
+    if (p1[i] > p2[i]) { --p1[i]; ++changes; if (p1[i] > p2[i]) --p1[i]; }
+    if (changes >= maxChanges) break;
+  }
+  return changes;
+}
+
+inline const TProgmemRGBPalette16 RainbowColors_p = {
+  0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+  0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B };
+inline const TProgmemRGBPalette16 PartyColors_p = {
+  0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+  0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9 };
+#define CloudColors_p         RainbowColors_p
+#define LavaColors_p          PartyColors_p
+#define OceanColors_p         RainbowColors_p
+#define ForestColors_p        PartyColors_p
+#define RainbowStripeColors_p RainbowColors_p
+
+#endif
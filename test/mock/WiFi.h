@@ -0,0 +1,20 @@
+#ifndef WLED_MOCK_WIFI_H
+#define WLED_MOCK_WIFI_H
+/*
+ * Host replacement for the ESP32 WiFi library: a station with a fixed MAC and IP address
+ */
+
+#include "Arduino.h"
+
+class WiFiClass {
+  public:
+    uint8_t mac[6] = {0x02, 0x00, 0x5E, 0x10, 0x20, 0x30};
+    IPAddress ip = IPAddress(192, 168, 1, 10);
+    uint8_t *macAddress(uint8_t *m) { memcpy(m, mac, 6); return m; }
+    IPAddress localIP() { return ip; }
+    IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+    IPAddress gatewayIP() { return IPAddress(192, 168, 1, 1); }
+};
+inline WiFiClass WiFi;
+
+#endif
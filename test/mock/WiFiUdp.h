@@ -0,0 +1,62 @@
+#ifndef WLED_MOCK_WIFIUDP_H
+#define WLED_MOCK_WIFIUDP_H
+/*
+ * Host replacement for WiFiUDP
+ * Datagrams written with beginPacket()/write()/endPacket() are appended to mockUdpSent,
+ * datagrams pushed to a socket's rx queue are returned by parsePacket()/read().
+ */
+
+#include <vector>
+#include <deque>
+#include "Arduino.h"
+
+struct MockDatagram {
+  IPAddress ip;
+  uint16_t  port;
+  std::vector<uint8_t> data;
+};
+inline std::vector<MockDatagram> mockUdpSent; // every datagram sent by any socket, oldest first
+
+class WiFiUDP : public Print {
+  public:
+    std::deque<MockDatagram> rx;  // datagrams waiting to be received
+    bool listening = false;
+
+    uint8_t begin(uint16_t port) { listening = true; return 1; }
+    uint8_t beginMulticast(IPAddress, uint16_t port) { listening = true; return 1; }
+    void stop() { listening = false; rx.clear(); }
+
+    int beginPacket(IPAddress ip, uint16_t port) { _out = MockDatagram{ip, port, {}}; _open = true; return 1; }
+    int beginMulticastPacket() { return beginPacket(IPAddress(), 0); }
+    size_t write(uint8_t c) override { if (_open) _out.data.push_back(c); return _open; }
+    size_t write(const uint8_t *buf, size_t len) override { if (!_open) return 0; _out.data.insert(_out.data.end(), buf, buf + len); return len; }
+    int endPacket() { if (!_open) return 0; _open = false; mockUdpSent.push_back(std::move(_out)); return 1; }
+
+    int parsePacket() {
+      if (_cur) { rx.pop_front(); _cur = false; }
+      if (rx.empty()) return 0;
+      _cur = true; _pos = 0;
+      return rx.front().data.size();
+    }
+    int available() { return _cur ? rx.front().data.size() - _pos : 0; }
+    int read(uint8_t *buf, size_t len) {
+      if (!_cur) return 0;
+      size_t n = std::min(len, rx.front().data.size() - _pos);
+      memcpy(buf, rx.front().data.data() + _pos, n);
+      _pos += n;
+      return n;
+    }
+    int read(char *buf, size_t len) { return read((uint8_t*)buf, len); }
+    int read() { uint8_t c; return read(&c, 1) ? c : -1; }
+    void flush() { if (_cur) { rx.pop_front(); _cur = false; } }
+    IPAddress remoteIP() { return _cur ? rx.front().ip : IPAddress(); }
+    uint16_t remotePort() { return _cur ? rx.front().port : 0; }
+
+  private:
+    MockDatagram _out;
+    bool   _open = false;
+    bool   _cur  = false;
+    size_t _pos  = 0;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef WLED_MOCK_BUS_H
+#define WLED_MOCK_BUS_H
+/*
+ * Host replacement for bus_wrapper.h (NeoPixelBus) and the few globals bus_manager.cpp needs
+ * Include before bus_manager.cpp. A "hardware" bus stores what NeoPixelBusLg would send:
+ * colors dimmed by the bus luminance when they are set.
+ */
+
+#include <vector>
+#include "Arduino.h"
+
+#ifndef ARDUINO_ARCH_ESP32
+#define ARDUINO_ARCH_ESP32 // ESP32 bus limits (LEDC PWM is a no-op)
+#endif
+
+// FreeRTOS critical sections (tests are single threaded)
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL(mux)
+
+#define BusWrapper_h // replaces bus_wrapper.h
+#define I_NONE 0
+#define I_MOCK 1
+
+struct MockNeoBus {
+  std::vector<uint32_t> pixels;  // dimmed colors as sent to the LEDs
+  std::vector<uint8_t>  order;   // color order used when the pixel was set
+  uint8_t  luminance = 255;
+  unsigned shows = 0;
+};
+inline std::vector<MockNeoBus*> mockNeoBusses; // in order of creation
+
+class PolyBus {
+  public:
+    static void* create(uint8_t busType, uint8_t* pins, uint16_t len, uint8_t channel, uint16_t clock_kHz = 0U) {
+      MockNeoBus *b = new MockNeoBus;
+      b->pixels.assign(len, 0);
+      b->order.assign(len, 0);
+      mockNeoBusses.push_back(b);
+      return b;
+    }
+    static void begin(void* busPtr, uint8_t busType, uint8_t* pins, uint16_t clock_kHz = 0U) {}
+    static void show(void* busPtr, uint8_t busType, bool consistent = true) { if (busPtr) static_cast<MockNeoBus*>(busPtr)->shows++; }
+    static bool canShow(void* busPtr, uint8_t busType) { return true; }
+    static void setBrightness(void* busPtr, uint8_t busType, uint8_t b) { static_cast<MockNeoBus*>(busPtr)->luminance = b; }
+    // NeoPixelBusLg dims on SetPixelColor(): (value * (luminance + 1)) >> 8
+    static void setPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co) {
+      MockNeoBus *b = static_cast<MockNeoBus*>(busPtr);
+      if (pix >= b->pixels.size()) return;
+      uint32_t out = 0;
+      for (unsigned s = 0; s < 32; s += 8) out |= ((((c >> s) & 0xFF) * (b->luminance + 1)) >> 8) << s;
+      b->pixels[pix] = out;
+      b->order[pix]  = co;
+    }
+    static uint32_t getPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint8_t co) {
+      MockNeoBus *b = static_cast<MockNeoBus*>(busPtr);
+      return pix < b->pixels.size() ? b->pixels[pix] : 0;
+    }
+    static void cleanup(void* busPtr, uint8_t busType) {
+      if (!busPtr) return;
+      mockNeoBusses.erase(std::remove(mockNeoBusses.begin(), mockNeoBusses.end(), busPtr), mockNeoBusses.end());
+      delete static_cast<MockNeoBus*>(busPtr);
+    }
+    static uint8_t getI(uint8_t busType, uint8_t* pins, uint8_t num = 0) { return I_MOCK; }
+};
+
+// every pin can be used
+#include "../../wled00/pin_manager.h"
+bool PinManagerClass::allocatePin(byte gpio, bool output, PinOwner tag) { return true; }
+bool PinManagerClass::deallocatePin(byte gpio, PinOwner tag) { return true; }
+bool PinManagerClass::isPinOk(byte gpio, bool output) { return true; }
+#ifdef ARDUINO_ARCH_ESP32
+byte PinManagerClass::allocateLedc(byte channels) { return 0; }
+void PinManagerClass::deallocateLedc(byte pos, byte channels) {}
+#endif
+PinManagerClass pinManager;
+
+bool useGlobalLedBuffer = true;
+
+#ifndef WLED_COLORS_CPP
+// colors.cpp (CCT correction is not exercised by the bus tests)
+uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb) { return rgb; }
+uint16_t approximateKelvinFromRGB(uint32_t rgb) { return 6500; }
+void colorRGBtoRGBW(byte* rgb) {}
+#endif
+
+#ifndef WLED_MOCK_NET_H
+// udp.cpp (network tests compile the real one)
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri, bool isRGBW, uint16_t *packets) { return 0; }
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef WLED_MOCK_COLORS_H
+#define WLED_MOCK_COLORS_H
+/*
+ * Host replacement for the parts of wled.h and fcn_declare.h that colors.cpp needs
+ * Include before colors.cpp (fx_mock.h includes it for the effect engine).
+ */
+
+#include "Arduino.h"
+#include "FastLED.h"
+
+#define WLED_H              // replaces wled.h
+#define WLED_FCN_DECLARE_H  // replaces fcn_declare.h
+#define WLED_COLORS_CPP     // colors.cpp is compiled by the test (bus_mock.h must not stub it)
+
+//color mangling macros
+#define RGBW32(r,g,b,w) (uint32_t((byte(w) << 24) | (byte(r) << 16) | (byte(g) << 8) | (byte(b))))
+#define R(c) (byte((c) >> 16))
+#define G(c) (byte((c) >> 8))
+#define B(c) (byte(c))
+#define W(c) (byte((c) >> 24))
+
+// fcn_declare.h: colors.cpp
+class NeoGammaWLEDMethod {
+  public:
+    static uint8_t Correct(uint8_t value);
+    static uint32_t Correct32(uint32_t color);
+    static void calcGammaTable(float gamma);
+    static inline uint8_t rawGamma8(uint8_t val) { return gammaT[val]; }
+  private:
+    static uint8_t gammaT[];
+};
+#define gamma32(c) NeoGammaWLEDMethod::Correct32(c)
+#define gamma8(c)  NeoGammaWLEDMethod::rawGamma8(c)
+uint32_t color_blend(uint32_t,uint32_t,uint16_t,bool b16=false);
+uint32_t color_add(uint32_t,uint32_t, bool fast=false);
+uint32_t color_fade(uint32_t c1, uint8_t amount, bool video=false);
+void color_fade_span(uint32_t *c, unsigned n, uint8_t amount, bool video=false);
+void color_blend_span(uint32_t *dst, const uint32_t *src, unsigned n, uint16_t blend, bool b16=false);
+void color_add_span(uint32_t *dst, const uint32_t *src, unsigned n, bool fast=false);
+void scale8_copy(uint8_t *dst, const uint8_t *src, size_t len, uint8_t scale);
+void colorHStoRGB(uint16_t hue, byte sat, byte* rgb);
+
+// wled.h globals used by colors.cpp
+bool gammaCorrectCol  = true;
+bool gammaCorrectBri  = false;
+float gammaCorrectVal = 2.8f;
+byte lastRandomIndex  = 0;
+
+// util.cpp
+inline uint8_t get_random_wheel_index(uint8_t pos) {
+  uint8_t r = 0, x = 0, y = 0, d = 0;
+  while (d < 42) {
+    r = random8();
+    x = abs(pos - r);
+    y = 255 - x;
+    d = x < y ? x : y;
+  }
+  return r;
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef WLED_MOCK_ESP_TIMER_H
+#define WLED_MOCK_ESP_TIMER_H
+/*
+ * Host replacement for the ESP-IDF high resolution timer, runs on the simulated clock (Arduino.h)
+ */
+
+#include "Arduino.h"
+
+inline int64_t esp_timer_get_time() { return mockMicros; }
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef WLED_MOCK_FS_H
+#define WLED_MOCK_FS_H
+/*
+ * Host replacement for wled.h as seen by the file system code (presetlog.cpp, ledmap.cpp)
+ * WLED_FS is a directory of the host created by mockFsInit(). Writes can be limited to simulate a
+ * power cut: once mockFsWriteBudget is used up MockPowerCut is thrown and whatever was written so far
+ * stays on "flash". Opening a file for writing, removing and renaming cost one unit, data one per byte.
+ */
+
+#include <memory>
+#include <functional>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Arduino.h"
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 0
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 0
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT  0
+#define ARDUINOJSON_ENABLE_PROGMEM        0
+#include "../../wled00/src/dependencies/json/ArduinoJson-v6.h"
+using namespace ArduinoJson;
+#include "ESPAsyncWebServer.h"
+#include "../../wled00/const.h"
+
+#define WLED_H // replaces wled.h
+
+#define MIN(a,b) ((a)<(b)?(a):(b))
+#define DEBUG_PRINT(x)
+#define DEBUG_PRINTLN(x)
+#define DEBUG_PRINTF(x...)
+#define DEBUGFS_PRINT(x)
+#define DEBUGFS_PRINTLN(x)
+#define DEBUGFS_PRINTF(x...)
+
+struct MockPowerCut {};
+inline std::string mockFsRoot;          // host directory holding the files
+inline long   mockFsWriteBudget = -1;   // units that can still be written, -1 = unlimited
+inline size_t mockFsBytesRead = 0;      // bytes read from files
+
+inline void mockFsSpend(long n) {
+  if (mockFsWriteBudget < 0) return;
+  if (mockFsWriteBudget < n) { mockFsWriteBudget = 0; throw MockPowerCut(); }
+  mockFsWriteBudget -= n;
+}
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Print {
+  public:
+    File() {}
+    File(FILE *fp, const std::string &path) : _fp(fp, fclose), _path(path) {}
+    explicit operator bool() const { return (bool)_fp; }
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t len) override {
+      if (!_fp) return 0;
+      size_t n = (mockFsWriteBudget < 0 || (size_t)mockFsWriteBudget >= len) ? len : mockFsWriteBudget;
+      n = fwrite(buf, 1, n, _fp.get());
+      fflush(_fp.get());
+      mockFsSpend(n);
+      if (n < len) mockFsSpend(1); // power is gone
+      return n;
+    }
+    size_t read(uint8_t *buf, size_t len) {
+      size_t n = _fp ? fread(buf, 1, len, _fp.get()) : 0;
+      mockFsBytesRead += n;
+      return n;
+    }
+    int read() { uint8_t c; return read(&c, 1) ? c : -1; }
+    int available() { return _fp ? size() - position() : 0; }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+      return _fp && !fseek(_fp.get(), pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END);
+    }
+    size_t position() const { return _fp ? ftell(_fp.get()) : 0; }
+    size_t size() const {
+      struct stat st;
+      return _fp && !fstat(fileno(_fp.get()), &st) ? st.st_size : 0;
+    }
+    time_t getLastWrite() const {
+      struct stat st;
+      return _fp && !fstat(fileno(_fp.get()), &st) ? st.st_mtime : 0;
+    }
+    const char *name() const { return _path.c_str(); }
+    void close() { _fp.reset(); }
+
+  private:
+    std::shared_ptr<FILE> _fp;
+    std::string _path;
+};
+
+class MockFS {
+  public:
+    File open(const char *path, const char *mode = "r") {
+      if (mode[0] != 'r') mockFsSpend(1);
+      std::string m = mode[0] == 'r' ? "rb" : mode[0] == 'a' ? "ab" : "wb";
+      FILE *fp = fopen(host(path).c_str(), m.c_str());
+      return fp ? File(fp, path) : File();
+    }
+    File open(const String &path, const char *mode = "r") { return open(path.c_str(), mode); }
+    bool exists(const char *path) { struct stat st; return !stat(host(path).c_str(), &st); }
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path) { mockFsSpend(1); return !::remove(host(path).c_str()); }
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *from, const char *to) { mockFsSpend(1); return !::rename(host(from).c_str(), host(to).c_str()); }
+  private:
+    std::string host(const char *path) { return mockFsRoot + path; }
+};
+inline MockFS WLED_FS;
+
+// creates an empty file system (once per process, later calls remove all files)
+inline void mockFsInit() {
+  if (mockFsRoot.empty()) {
+    char dir[] = "/tmp/wled_fs_XXXXXX";
+    if (mkdtemp(dir)) mockFsRoot = dir;
+  }
+  if (DIR *d = opendir(mockFsRoot.c_str())) {
+    while (struct dirent *e = readdir(d)) if (e->d_name[0] != '.') ::remove((mockFsRoot + "/" + e->d_name).c_str());
+    closedir(d);
+  }
+  mockFsWriteBudget = -1;
+}
+
+// removes the file system directory
+inline void mockFsCleanup() {
+  mockFsInit();
+  rmdir(mockFsRoot.c_str());
+}
+
+// whole file as string ("" if it does not exist)
+inline std::string mockFsRead(const char *path) {
+  std::string s;
+  if (FILE *f = fopen((mockFsRoot + path).c_str(), "rb")) {
+    char buf[1024];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, n);
+    fclose(f);
+  }
+  return s;
+}
+
+inline void mockFsWrite(const char *path, const std::string &content) {
+  if (FILE *f = fopen((mockFsRoot + path).c_str(), "wb")) {
+    fwrite(content.data(), 1, content.size(), f);
+    fclose(f);
+  }
+}
+
+// wled.h globals used by the file system code
+byte   errorFlag    = 0;
+size_t fsBytesUsed  = 0;
+size_t fsBytesTotal = 1 << 26;
+JsonDocument *fileDoc = nullptr;
+
+inline void updateFSInfo() {}
+inline bool requestJSONBufferLock(uint8_t module=255) { return true; }
+inline void releaseJSONBufferLock() {}
+
+// fcn_declare.h: presetlog.cpp, ledmap.cpp
+int16_t presetStoreId(const char *file, const char *key);
+int8_t readPresetFromStore(uint8_t id, JsonDocument *dest);
+bool writePresetToStore(uint8_t id, JsonDocument *content);
+bool servePresetsJson(AsyncWebServerRequest *request, const String &contentType);
+void buildPresetIndex();
+void discardPresetLog();
+void handlePresetLog();
+int8_t readLedmap(uint8_t n, uint16_t* &table, uint16_t &size);
+bool getLedmapName(uint8_t n, char *name, size_t len);
+bool ledmapExists(uint8_t n);
+void removeLedmapCache(const String &fileName);
+
+#endif
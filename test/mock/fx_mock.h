@@ -0,0 +1,71 @@
+#ifndef WLED_MOCK_FX_H
+#define WLED_MOCK_FX_H
+/*
+ * Host replacement for wled.h as seen by FX_fcn.cpp, FX_2Dfcn.cpp and colors.cpp (see colors_mock.h)
+ * Include before those sources. Busses come from bus_mock.h, there is no file system
+ * (custom palettes and ledmaps are never found).
+ */
+
+#include "Arduino.h"
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 0
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 0
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT  0
+#define ARDUINOJSON_ENABLE_PROGMEM        0
+#include "../../wled00/src/dependencies/json/ArduinoJson-v6.h"
+using namespace ArduinoJson;
+inline bool convertToJson(const String &s, JsonVariant v) { return v.set(s.c_str()); } // ARDUINOJSON_ENABLE_ARDUINO_STRING is off
+
+#include "colors_mock.h"
+#include "bus_mock.h"
+#include "../../wled00/const.h"
+#include "../../wled00/bus_manager.h"
+
+#ifndef HALF_PI
+#define HALF_PI 1.5707963267948966
+#endif
+#define pgm_read_byte_near(p) pgm_read_byte(p)
+#define WLED_USE_REAL_MATH
+
+#define DEBUG_PRINT(x)
+#define DEBUG_PRINTLN(x)
+#define DEBUG_PRINTF(x...)
+
+#define sin_t sin
+#define cos_t cos
+
+#include "../../wled00/FX.h"
+
+// wled.h globals used by the effect engine
+bool autoSegments            = false;
+bool correctWB               = false;
+bool cctFromRgb              = false;
+bool fadeTransition          = true;
+bool modeBlending            = true;
+bool modeBlendBuffers        = false;
+uint8_t randomPaletteChangeTime = 5;
+bool stateChanged            = false;
+byte realtimeMode            = REALTIME_MODE_INACTIVE;
+StaticJsonDocument<JSON_BUFFER_SIZE> doc;
+BusManager busses;
+WS2812FX strip;
+
+// FX.cpp is not compiled: every effect id paints the primary color, tests add their own effects with addEffect()
+static uint16_t mode_mock_static(void) { SEGMENT.fill(SEGCOLOR(0)); return 350; }
+void WS2812FX::setupEffectData() {
+  for (size_t i = 0; i < _modeCount; i++) {
+    _mode.push_back(&mode_mock_static);
+    _modeData.push_back("Solid");
+  }
+}
+
+// no file system: custom palettes and ledmaps do not exist
+struct MockFS { bool exists(const char *) { return false; } };
+inline MockFS WLED_FS;
+inline bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest) { return false; }
+inline int8_t readLedmap(uint8_t n, uint16_t* &table, uint16_t &size) { return -1; }
+inline void enumerateLedmaps() {}
+inline bool requestJSONBufferLock(uint8_t module=255) { return true; }
+inline void releaseJSONBufferLock() {}
+inline int16_t extractModeDefaults(uint8_t mode, const char *segVar) { return -1; }
+
+#endif
@@ -0,0 +1 @@
+// host tests: no IGMP
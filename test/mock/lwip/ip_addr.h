@@ -0,0 +1,5 @@
+// host tests: byte order helpers only
+#include <arpa/inet.h>
+#ifndef LWIP_VERSION_MAJOR
+#define LWIP_VERSION_MAJOR 2
+#endif
@@ -0,0 +1,161 @@
+#ifndef WLED_MOCK_NET_H
+#define WLED_MOCK_NET_H
+/*
+ * Host replacement for wled.h as seen by udp.cpp, e131.cpp and telemetry.cpp (on top of fx_mock.h)
+ * Include before those sources. The network is always up; datagrams sent go to mockUdpSent (WiFiUdp.h),
+ * received ones are queued on a socket or handed to the packet handlers directly.
+ */
+
+#ifndef ESP32
+#define ESP32
+#endif
+
+#include "fx_mock.h"
+#include "WiFi.h"
+#include "WiFiUdp.h"
+#include "../../wled00/src/dependencies/toki/Toki.h"
+#include "../../wled00/src/dependencies/e131/ESPAsyncE131.h"
+#include "../../wled00/src/dependencies/network/Network.h"
+#include "../../wled00/NodeStruct.h"
+
+#define VERSION 2405180
+#define WLED_VERSION dev
+#define STRINGIFY(X) #X
+#define TOSTRING(X) STRINGIFY(X)
+
+IPAddress NetworkClass::localIP()    { return WiFi.localIP(); }
+IPAddress NetworkClass::subnetMask() { return WiFi.subnetMask(); }
+IPAddress NetworkClass::gatewayIP()  { return WiFi.gatewayIP(); }
+void NetworkClass::localMAC(uint8_t* MAC) { WiFi.macAddress(MAC); }
+bool NetworkClass::isConnected()     { return true; }
+bool NetworkClass::isEthernet()      { return false; }
+NetworkClass Network;
+
+struct UdpRxStats {
+  uint32_t received;
+  uint32_t coalesced;
+  uint32_t dropped;
+  uint16_t depth;
+  uint16_t maxDepth;
+};
+
+// wled.h globals used by the network code
+bool      apActive                    = false;
+bool      interfacesInited            = true;
+char      serverDescription[33]       = "WLED";
+char      versionString[]             = "dev";
+IPAddress staticIP;
+byte      bri                         = 128;
+byte      briLast                     = 128;
+byte      briT                        = 0;
+uint16_t  transitionDelay             = 750;
+bool      jsonTransitionOnce          = false;
+bool      nightlightActive            = false;
+byte      nightlightDelayMins         = 60;
+byte      currentPreset               = 0;
+byte      presetCycCurr               = 0;
+int16_t   currentPlaylist             = -1;
+bool      nodeListEnabled             = true;
+NodesMap  Nodes;
+Toki      toki;
+
+// sync
+uint16_t  udpPort                     = 21324;
+uint16_t  udpPort2                    = 65506;
+uint8_t   syncGroups                  = 0x01;
+uint8_t   receiveGroups               = 0x01;
+bool      receiveNotificationBrightness = true;
+bool      receiveNotificationColor    = true;
+bool      receiveNotificationEffects  = true;
+bool      receiveSegmentOptions       = false;
+bool      receiveSegmentBounds        = false;
+bool      receiveNotifications        = true;
+bool      notifyDirect                = false;
+bool      notifyButton                = false;
+bool      notifyAlexa                 = false;
+bool      notifyHue                   = true;
+uint8_t   udpNumRetries               = 0;
+bool      notifierDelta               = false;
+bool      clockSyncEnabled            = false;
+unsigned long notificationSentTime    = 0;
+byte      notificationSentCallMode    = CALL_MODE_INIT;
+uint8_t   notificationCount           = 0;
+WiFiUDP   notifierUdp, rgbUdp, notifier2Udp;
+bool      udpConnected = false, udp2Connected = false, udpRgbConnected = false;
+byte      udpRxMaxPackets             = 16;
+byte      udpRxBudgetMs               = 8;
+UdpRxStats udpRxStats;
+
+// realtime
+uint16_t  realtimeTimeoutMs           = 2500;
+bool      receiveDirect               = true;
+int       arlsOffset                  = 0;
+bool      arlsDisableGammaCorrection  = true;
+bool      arlsForceMaxBri             = false;
+uint16_t  e131Universe                = 1;
+byte      DMXMode                     = DMX_MODE_MULTIPLE_RGB;
+uint16_t  DMXAddress                  = 1;
+uint16_t  DMXSegmentSpacing           = 0;
+byte      e131Priority                = 0;
+E131Priority highPriority(3);
+byte      e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT];
+bool      e131SkipOutOfSequence       = false;
+uint16_t  realtimeFrameTimeout        = 25;
+uint32_t  realtimeFramesComplete      = 0;
+uint32_t  realtimeFramesIncomplete    = 0;
+uint32_t  realtimeFramesTorn          = 0;
+uint32_t  realtimeFramesSkipped       = 0;
+bool      realtimeStats               = false;
+uint16_t  e131OutUniverse             = 1;
+byte      e131OutPriority             = 100;
+uint16_t  e131OutSyncUniverse         = 0;
+uint16_t  realtimeOutPacing           = 0;
+uint16_t  pollReplyCount              = 0;
+bool      e131NewData                 = false;
+byte      realtimeOverride            = REALTIME_OVERRIDE_NONE;
+IPAddress realtimeIP;
+unsigned long realtimeTimeout         = 0;
+uint8_t   tpmPacketCount              = 0;
+uint16_t  tpmPayloadFrameSize         = 0;
+bool      useMainSegmentOnly          = false;
+
+// fcn_declare.h, implemented by the sources a test compiles
+class AsyncWebServerRequest;
+void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleArtnetPollReply(IPAddress ipAddress);
+void prepareArtnetPollReply(ArtPollReply* reply);
+void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
+void handleE131Frame();
+void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t i, const byte *data, uint16_t count, uint8_t channels);
+void rtStatsPacket(uint8_t mode);
+void rtStatsFrame(uint8_t mode);
+void rtStatsDrop(uint8_t mode, bool late);
+void handleRtStats();
+
+// the rest of the firmware: state changes are counted, not applied
+inline unsigned mockStateUpdates = 0;
+#ifndef WLED_MOCK_CLOCKSYNC // defined by tests that compile clocksync.cpp
+inline bool clockSyncFollow(IPAddress ip) { return false; }
+inline bool handleClockSyncPacket(const uint8_t *buf, size_t len, IPAddress ip) { return false; }
+inline void handleClockSync() {}
+#else
+bool clockSyncFollow(IPAddress ip);
+bool handleClockSyncPacket(const uint8_t *buf, size_t len, IPAddress ip);
+void handleClockSync();
+#endif
+inline bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0) { mockStateUpdates++; return true; }
+inline void stateUpdated(byte callMode) { mockStateUpdates++; }
+inline void updateInterfaces(uint8_t callMode) {}
+inline byte scaledBri(byte in) { return in; }
+inline void unloadPlaylist() {}
+inline bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE) { return false; }
+inline bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply = true) { return false; }
+
+// ESPAsyncE131 (receiving is done by calling handleE131Packet()): synchronization universe joined last
+inline uint16_t mockE131SyncUniverse = 0;
+ESPAsyncE131::ESPAsyncE131(e131_packet_callback_function callback) { _callback = callback; }
+void ESPAsyncE131::setSyncUniverse(uint16_t universe) { mockE131SyncUniverse = universe; }
+ESPAsyncE131 e131(handleE131Packet);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef WLED_MOCK_WS_H
+#define WLED_MOCK_WS_H
+/*
+ * Host replacement for wled.h as seen by ws.cpp (on top of net_mock.h)
+ * Include before ws.cpp. JSON arenas are never available, so messages are parsed into doc (legacy path).
+ */
+
+#include "net_mock.h"
+#include "ESPAsyncWebServer.h"
+
+#define WLED_ENABLE_WEBSOCKETS
+
+struct EspClass { uint32_t getFreeHeap() { return 200000; } };
+inline EspClass ESP;
+
+AsyncWebSocket ws;
+byte interfaceUpdateCallMode = CALL_MODE_INIT;
+
+void sendDataWs(AsyncWebSocketClient * client = nullptr);
+inline void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false) {}
+inline void serializeInfo(JsonObject root) {}
+inline JsonDocument* acquireJSONArena(uint8_t module = 255) { return nullptr; }
+inline void releaseJSONArena(JsonDocument *arena) {}
+inline bool lockJSONState(uint8_t module, JsonDocument *arena, unsigned waitMs = 1000) { return true; }
+size_t rtStatsBinarySize();
+size_t fillRtStatsBinary(uint8_t *buf);
+
+#endif
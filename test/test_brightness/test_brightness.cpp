@@ -0,0 +1,111 @@
+/*
+ * Brightness is applied from the unscaled frame buffer in WS2812FX::show()
+ * Any number of brightness changes (directly or by the current limiter) must leave the colors untouched.
+ */
+#include <unity.h>
+#include "fx_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+
+#define LEDS_PER_BUS 300
+
+static std::vector<uint32_t> original;   // frame as painted
+static std::vector<std::vector<uint32_t>> reference; // bus data of that frame at full brightness
+
+static std::vector<std::vector<uint32_t>> busData() {
+  std::vector<std::vector<uint32_t>> d;
+  for (auto b : mockNeoBusses) d.push_back(b->pixels);
+  return d;
+}
+
+// RGB, RGBW with auto white and reversed RGB bus, random frame shown at full brightness
+static void setupStrip() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  for (unsigned i = 0; i < 3; i++) {
+    pins[0] = 2 + i;
+    BusConfig bc(i == 1 ? TYPE_SK6812_RGBW : TYPE_WS2812_RGB, pins, i * LEDS_PER_BUS, LEDS_PER_BUS, COL_ORDER_GRB, i == 2, 0,
+                 i == 1 ? RGBW_MODE_AUTO_BRIGHTER : RGBW_MODE_MANUAL_ONLY);
+    busses.add(bc);
+  }
+  strip.isMatrix = false;
+  strip.ablMilliampsMax = 0;
+  strip.finalizeInit();
+  strip.resetSegments();
+
+  original.resize(strip.getLengthTotal());
+  uint32_t seed = 7;
+  for (unsigned i = 0; i < original.size(); i++) {
+    seed = seed * 1664525 + 1013904223;
+    original[i] = seed;
+    strip.setPixelColor(i, original[i]);
+  }
+  strip.setBrightness(255, true);
+  strip.show();
+  reference = busData();
+}
+
+static void assertUnchanged() {
+  strip.ablMilliampsMax = 0;
+  strip.setBrightness(255, true);
+  strip.show();
+  for (unsigned i = 0; i < original.size(); i++) TEST_ASSERT_EQUAL_HEX32(original[i], strip.getPixelColor(i));
+  auto got = busData();
+  TEST_ASSERT_EQUAL(reference.size(), got.size());
+  for (size_t b = 0; b < got.size(); b++) TEST_ASSERT_EQUAL_UINT32_ARRAY(reference[b].data(), got[b].data(), got[b].size());
+}
+
+void test_10000_brightness_changes() {
+  setupStrip();
+  srand(1);
+  for (unsigned n = 0; n < 10000; n++) {
+    strip.setBrightness(rand() & 0xFF, true);
+    strip.show();
+  }
+  assertUnchanged();
+}
+
+void test_10000_limiter_changes() {
+  setupStrip();
+  srand(2);
+  strip.milliampsPerLed = 55;
+  for (unsigned n = 0; n < 10000; n++) {
+    strip.ablMilliampsMax = 150 + rand() % 20000; // limiter dims by varying amounts
+    strip.setBrightness(rand() & 0xFF, true);
+    strip.show();
+  }
+  assertUnchanged();
+}
+
+// a bus whose own supply cannot even cover standby current is dimmed to the minimum, not switched off
+void test_bus_limit_below_standby_current() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  BusConfig limited(TYPE_WS2812_RGB, pins, 0, LEDS_PER_BUS, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY, 0, false, LEDS_PER_BUS / 2);
+  busses.add(limited);
+  pins[0] = 3;
+  BusConfig unlimited(TYPE_WS2812_RGB, pins, LEDS_PER_BUS, LEDS_PER_BUS, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY);
+  busses.add(unlimited);
+  strip.finalizeInit();
+  strip.resetSegments();
+  strip.milliampsPerLed = 55;
+  strip.ablMilliampsMax = 100000;
+  for (unsigned i = 0; i < strip.getLengthTotal(); i++) strip.setPixelColor(i, WHITE);
+  strip.setBrightness(255, true);
+  strip.show();
+  TEST_ASSERT_EQUAL(1, busses.getBus(0)->getBrightness());
+  TEST_ASSERT_EQUAL(255, busses.getBus(1)->getBrightness());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_10000_brightness_changes);
+  RUN_TEST(test_10000_limiter_changes);
+  RUN_TEST(test_bus_limit_below_standby_current);
+  return UNITY_END();
+}
@@ -0,0 +1,129 @@
+/*
+ * Strip frame buffer flush (BusManager::setPixelColors()) against per pixel dispatch (BusManager::setPixelColor())
+ * Both paths must produce identical bus data; µs/frame of both are reported for 1k/4k/8k LEDs.
+ */
+#include <unity.h>
+#include <chrono>
+#include "bus_mock.h"
+#include "../../wled00/bus_manager.cpp"
+
+BusManager busses;
+static std::vector<uint32_t> frame;
+
+// 4 busses: RGB, RGBW with auto white, reversed RGB, RGB with a color order mapping in its middle
+static void setupBusses(unsigned leds) {
+  busses.removeAll();
+  ColorOrderMap com;
+  com.reset();
+  com.add(leds*3/4 + 10, 50, COL_ORDER_BRG);
+  busses.updateColorOrderMap(com);
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  unsigned quarter = leds / 4;
+  for (unsigned i = 0; i < 4; i++) {
+    pins[0] = 2 + i;
+    BusConfig bc(i == 1 ? TYPE_SK6812_RGBW : TYPE_WS2812_RGB, pins, i * quarter, quarter, COL_ORDER_GRB, i == 2, 0,
+                 i == 1 ? RGBW_MODE_AUTO_BRIGHTER : RGBW_MODE_MANUAL_ONLY);
+    busses.add(bc);
+  }
+  busses.show(); // compiles color order map
+  busses.setBuffering(true);
+  frame.resize(leds);
+  uint32_t seed = leds;
+  for (auto &c : frame) { seed = seed * 1664525 + 1013904223; c = seed; }
+}
+
+static std::vector<std::vector<uint32_t>> busData() {
+  std::vector<std::vector<uint32_t>> d;
+  for (auto b : mockNeoBusses) d.push_back(b->pixels);
+  return d;
+}
+
+template<typename F> static double usPerFrame(unsigned frames, F paint) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned f = 0; f < frames; f++) { frame[f % frame.size()] ^= f; paint(); }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / frames;
+}
+
+static void benchmark(unsigned leds) {
+  setupBusses(leds);
+  const unsigned frames = 200;
+  double perPixel = usPerFrame(frames, [&]() { for (unsigned i = 0; i < leds; i++) busses.setPixelColor(i, frame[i]); busses.show(); });
+  auto expected = busData();
+  double bulk = usPerFrame(frames, [&]() { busses.setPixelColors(0, leds, frame.data()); busses.show(); });
+  // same frame painted both ways must give the same bus contents
+  for (unsigned i = 0; i < leds; i++) busses.setPixelColor(i, frame[i]);
+  expected = busData();
+  busses.setPixelColors(0, leds, frame.data());
+  auto got = busData();
+  TEST_ASSERT_EQUAL(expected.size(), got.size());
+  for (size_t b = 0; b < got.size(); b++) {
+    TEST_ASSERT_EQUAL(expected[b].size(), got[b].size());
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected[b].data(), got[b].data(), got[b].size());
+  }
+  char msg[100];
+  snprintf(msg, sizeof(msg), "%u LEDs: per pixel %.1f us/frame, frame buffer flush %.1f us/frame", leds, perPixel, bulk);
+  TEST_MESSAGE(msg);
+}
+
+void test_flush_1k() { benchmark(1024); }
+void test_flush_4k() { benchmark(4096); }
+void test_flush_8k() { benchmark(8192); }
+
+// partial ranges split across bus borders must land on the same pixels as single writes
+void test_flush_partial_ranges() {
+  setupBusses(1000);
+  for (unsigned i = 0; i < 1000; i++) busses.setPixelColor(i, frame[i]);
+  auto expected = busData();
+  for (auto b : mockNeoBusses) std::fill(b->pixels.begin(), b->pixels.end(), 0);
+  for (unsigned s = 0; s < 1000; s += 77) busses.setPixelColors(s, s + 77 > 1000 ? 1000 - s : 77, frame.data() + s);
+  auto got = busData();
+  for (size_t b = 0; b < got.size(); b++) TEST_ASSERT_EQUAL_UINT32_ARRAY(expected[b].data(), got[b].data(), got[b].size());
+}
+
+// without frame buffer (allocation failed or disabled) a brightness change must repaint the bus data
+void test_brightness_without_frame_buffer() {
+  setupBusses(400);
+  busses.setBuffering(false);
+  busses.setPixelColors(0, 400, frame.data());
+  busses.setBrightness(128);
+  for (auto b : mockNeoBusses) TEST_ASSERT_EQUAL(128, b->luminance);
+  Bus *bus = busses.getBus(0);
+  for (unsigned i = 0; i < 100; i++) {
+    uint32_t c = frame[i];
+    uint32_t hw = mockNeoBusses[0]->pixels[i];
+    TEST_ASSERT_UINT32_WITHIN(2, ((R(c) * 129) >> 8), R(hw));
+    TEST_ASSERT_UINT32_WITHIN(2, ((G(c) * 129) >> 8), G(hw));
+    TEST_ASSERT_UINT32_WITHIN(2, ((B(c) * 129) >> 8), B(hw));
+  }
+  TEST_ASSERT_EQUAL(128, bus->getBrightness());
+}
+
+// a bus ending beyond pixel 65535 must still be found (end of its range does not fit 16 bits)
+void test_bus_ending_above_16_bits() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  BusConfig bc(TYPE_WS2812_RGB, pins, 65000, 1000, COL_ORDER_RGB, false, 0, RGBW_MODE_MANUAL_ONLY);
+  busses.add(bc);
+  busses.setBuffering(true);
+  busses.setPixelColor(65500, 0x123456);
+  TEST_ASSERT_EQUAL_HEX32(0x123456, mockNeoBusses[0]->pixels[500]);
+  TEST_ASSERT_EQUAL_HEX32(0x123456, busses.getPixelColor(65500));
+  uint32_t c[3] = {1, 2, 3};
+  busses.setPixelColors(65533, 3, c);
+  TEST_ASSERT_EQUAL_HEX32(3, mockNeoBusses[0]->pixels[535]);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_flush_partial_ranges);
+  RUN_TEST(test_brightness_without_frame_buffer);
+  RUN_TEST(test_bus_ending_above_16_bits);
+  RUN_TEST(test_flush_1k);
+  RUN_TEST(test_flush_4k);
+  RUN_TEST(test_flush_8k);
+  busses.removeAll();
+  return UNITY_END();
+}
@@ -0,0 +1,188 @@
+/*
+ * Effect timebase synchronisation (clock sync)
+ * A leader and a follower with offset and drifting clocks exchange packets over a simulated network with
+ * delay and jitter. The follower gets a notification every 5 s and must track the leader's effect time
+ * closer than the notification timebase does. A leader that never replies (older version) must not be
+ * polled again until CLOCKSYNC_RETRY has passed.
+ */
+#include <unity.h>
+#include <deque>
+#include <random>
+#include <vector>
+#define WLED_MOCK_CLOCKSYNC
+#include "net_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+#include "../../wled00/udp.cpp"
+#include "../../wled00/e131.cpp"
+#include "../../wled00/telemetry.cpp"
+#include "../../wled00/clocksync.cpp"
+
+#define SIM_STEP      1000      // us
+#define SIM_NOTIFY    5000000   // us between notifications of the leader
+#define SIM_SETTLE    120000000 // us before the error is evaluated
+
+struct Node {
+  uint64_t offset;   // us
+  double   ppm;      // clock rate error
+  uint32_t timebase; // strip.timebase of the node
+};
+
+struct InFlight {
+  uint64_t at;
+  bool toFollower;
+  std::vector<uint8_t> data;
+};
+
+struct Link {
+  double delay;       // us, one way
+  double jitter;      // us, mean of the exponentially distributed extra delay
+  double asymmetry;   // us, extra delay from leader to follower
+  bool   replies;     // leader supports clock sync
+};
+
+struct SimResult {
+  double meanErr;     // ms, mean absolute effect time difference after SIM_SETTLE
+  double maxErr;
+  unsigned requests;  // clock sync requests sent by the follower
+};
+
+static const IPAddress followerIP(192, 168, 1, 10);
+static uint64_t simNow = 1000000; // true time (us), never goes backwards between tests
+static std::mt19937 rng(5);
+static std::deque<InFlight> net;
+
+static uint64_t nodeClock(const Node &n) { return n.offset + (uint64_t)(simNow * (1.0 + n.ppm / 1e6)); }
+
+static double latency(const Link &l, bool toFollower) {
+  std::exponential_distribution<double> jit(1.0 / l.jitter);
+  return l.delay + jit(rng) + (toFollower ? l.asymmetry : 0);
+}
+
+// run code "on" a node: its clock and timebase
+static void enter(Node &n) {
+  mockMicros = nodeClock(n);
+  strip.timebase = n.timebase;
+  mockUdpSent.clear();
+}
+
+// datagrams sent while on the node go on the wire
+static void leave(Node &n, const Link &l, bool leader, SimResult &r) {
+  n.timebase = strip.timebase;
+  for (auto &d : mockUdpSent) {
+    if (!leader) r.requests++;
+    if (!leader && !l.replies) continue; // ignored by the leader
+    net.push_back({simNow + (uint64_t)latency(l, leader), leader, d.data});
+  }
+}
+
+// effect time of the follower - effect time of the leader (ms)
+static int32_t effectTimeError(const Node &leader, const Node &follower) {
+  return (uint32_t)(nodeClock(follower) / 1000 + follower.timebase) - (uint32_t)(nodeClock(leader) / 1000 + leader.timebase);
+}
+
+static SimResult simulate(IPAddress leaderIP, const Link &link, unsigned seconds) {
+  Node leader   = { 5ULL * 3600 * 1000000 + 123456, 40.0, 777777 };
+  Node follower = { 0, 0.0, 0 };
+  SimResult r = {0, 0, 0};
+  unsigned samples = 0;
+  const uint64_t start = simNow;
+  net.clear();
+  for (; simNow - start < seconds * 1000000ULL; simNow += SIM_STEP) {
+    if ((simNow - start) % SIM_NOTIFY == 0) {
+      // notification: without clock sync the follower takes the leader's effect time as sent, plus PRESUMED_NETWORK_DELAY
+      uint32_t sent = (uint32_t)((nodeClock(leader) - (uint64_t)latency(link, true)) / 1000) + leader.timebase;
+      enter(follower);
+      if (!clockSyncFollow(leaderIP)) strip.timebase = sent + 3 - millis();
+      leave(follower, link, false, r);
+    }
+    for (auto it = net.begin(); it != net.end();) {
+      if (it->at > simNow) { ++it; continue; }
+      InFlight p = std::move(*it);
+      it = net.erase(it);
+      Node &n = p.toFollower ? follower : leader;
+      enter(n);
+      handleClockSyncPacket(p.data.data(), p.data.size(), p.toFollower ? leaderIP : followerIP);
+      leave(n, link, !p.toFollower, r);
+      it = net.begin();
+    }
+    enter(follower);
+    handleClockSync();
+    leave(follower, link, false, r);
+
+    if (simNow - start > SIM_SETTLE) {
+      double e = abs(effectTimeError(leader, follower));
+      r.meanErr += e;
+      r.maxErr = std::max(r.maxErr, e);
+      samples++;
+    }
+  }
+  if (samples) r.meanErr /= samples;
+  return r;
+}
+
+static void report(const char *name, const SimResult &cs, const SimResult &ntf) {
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%s: clock sync mean %.2f ms max %.0f ms, notifications only mean %.2f ms max %.0f ms",
+           name, cs.meanErr, cs.maxErr, ntf.meanErr, ntf.maxErr);
+  TEST_MESSAGE(msg);
+}
+
+void setUp() { udpConnected = true; clockSyncEnabled = true; }
+void tearDown() {}
+
+// disabled: notifications set the timebase, nothing is sent
+void test_disabled() {
+  clockSyncEnabled = false;
+  Link link = { 1500, 4000, 0, true };
+  SimResult r = simulate(IPAddress(192, 168, 1, 20), link, 30);
+  TEST_ASSERT_EQUAL(0, r.requests);
+}
+
+// 1.5 ms delay with 4 ms mean jitter, leader clock 40 ppm fast and hours ahead
+void test_tracks_leader() {
+  Link link = { 1500, 4000, 0, true };
+  SimResult cs = simulate(IPAddress(192, 168, 1, 21), link, 600);
+  clockSyncEnabled = false;
+  SimResult ntf = simulate(IPAddress(192, 168, 1, 21), link, 600);
+  report("jitter", cs, ntf);
+  TEST_ASSERT_LESS_THAN(2.0, cs.meanErr);
+  TEST_ASSERT_LESS_THAN(10.0, cs.maxErr);
+  TEST_ASSERT_LESS_THAN(ntf.meanErr, cs.meanErr);
+}
+
+// 3 ms more from leader to follower than back: the offset estimate is off by half of it
+void test_asymmetric_path() {
+  Link link = { 1500, 4000, 3000, true };
+  SimResult cs = simulate(IPAddress(192, 168, 1, 22), link, 600);
+  clockSyncEnabled = false;
+  SimResult ntf = simulate(IPAddress(192, 168, 1, 22), link, 600);
+  report("asymmetric", cs, ntf);
+  TEST_ASSERT_LESS_THAN(3.0, cs.meanErr);
+  TEST_ASSERT_LESS_THAN(ntf.meanErr, cs.meanErr);
+}
+
+// a leader without clock sync is dropped after CLOCKSYNC_TIMEOUT and not polled again before CLOCKSYNC_RETRY
+void test_leader_without_clock_sync() {
+  const IPAddress leaderIP(192, 168, 1, 23);
+  Link link = { 1500, 4000, 0, false };
+  SimResult first = simulate(leaderIP, link, CLOCKSYNC_TIMEOUT / 1000 + 5);
+  TEST_ASSERT_GREATER_THAN(0, first.requests);
+  TEST_ASSERT_LESS_OR_EQUAL(CLOCKSYNC_TIMEOUT / CLOCKSYNC_FAST_POLL + 1, first.requests);
+  SimResult later = simulate(leaderIP, link, CLOCKSYNC_RETRY / 1000 - 60);
+  TEST_ASSERT_EQUAL(0, later.requests);
+  TEST_ASSERT_LESS_THAN(20.0, later.maxErr); // notifications keep the timebase
+  SimResult retry = simulate(leaderIP, link, 120);
+  TEST_ASSERT_GREATER_THAN(0, retry.requests);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_disabled);
+  RUN_TEST(test_tracks_leader);
+  RUN_TEST(test_asymmetric_path);
+  RUN_TEST(test_leader_without_clock_sync);
+  return UNITY_END();
+}
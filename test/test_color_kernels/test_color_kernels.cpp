@@ -0,0 +1,302 @@
+/*
+ * Packed (two channels per word) color kernels in colors.cpp against the per-channel reference
+ * they replaced. Results must be bit-exact; ns/pixel of both versions are reported.
+ * The span kernels must stay bit-exact for every length and alignment (the ESP32-S3 PIE build only
+ * vectorizes the 16 byte aligned middle of a span), and the PIE instruction sequences are modelled
+ * lane by lane on the host and checked against the reference as well.
+ */
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include "colors_mock.h"
+#include "../../wled00/colors.cpp"
+
+// per-channel reference implementations (colors.cpp before the packed kernels)
+static uint32_t ref_color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16) {
+  if(blend == 0)   return color1;
+  uint16_t blendmax = b16 ? 0xFFFF : 0xFF;
+  if(blend == blendmax) return color2;
+  uint8_t shift = b16 ? 16 : 8;
+  uint32_t w3 = ((W(color2) * blend) + (W(color1) * (blendmax - blend))) >> shift;
+  uint32_t r3 = ((R(color2) * blend) + (R(color1) * (blendmax - blend))) >> shift;
+  uint32_t g3 = ((G(color2) * blend) + (G(color1) * (blendmax - blend))) >> shift;
+  uint32_t b3 = ((B(color2) * blend) + (B(color1) * (blendmax - blend))) >> shift;
+  return RGBW32(r3, g3, b3, w3);
+}
+
+static uint32_t ref_color_add(uint32_t c1, uint32_t c2) {
+  return RGBW32(qadd8(R(c1), R(c2)), qadd8(G(c1), G(c2)), qadd8(B(c1), B(c2)), qadd8(W(c1), W(c2)));
+}
+
+static uint32_t ref_color_fade(uint32_t c1, uint8_t amount, bool video) {
+  if (video) return RGBW32(scale8_video(R(c1), amount), scale8_video(G(c1), amount), scale8_video(B(c1), amount), scale8_video(W(c1), amount));
+  return RGBW32(scale8(R(c1), amount), scale8(G(c1), amount), scale8(B(c1), amount), scale8(W(c1), amount));
+}
+
+static uint64_t rndState = 0x9E3779B97F4A7C15ULL;
+static uint32_t rnd32() { rndState ^= rndState << 13; rndState ^= rndState >> 7; rndState ^= rndState << 17; return uint32_t(rndState); }
+
+// random colors mixed with channel extremes (0x00, 0x01, 0xFE, 0xFF) where carries and rounding differ
+static uint32_t testColor() {
+  static const uint8_t edge[] = {0x00, 0x01, 0x7F, 0x80, 0xFE, 0xFF};
+  uint32_t c = rnd32();
+  if ((c & 3) == 0) {
+    uint32_t r = rnd32();
+    c = 0;
+    for (int s = 0; s < 32; s += 8, r >>= 3) c |= uint32_t(edge[(r & 7) % sizeof(edge)]) << s;
+  }
+  return c;
+}
+
+#define SAMPLES 2000000
+
+void test_blend_bit_exact() {
+  for (unsigned n = 0; n < SAMPLES; n++) {
+    uint32_t a = testColor(), b = testColor();
+    uint16_t bl8 = rnd32() & 0xFF, bl16 = rnd32() & 0xFFFF;
+    TEST_ASSERT_EQUAL_HEX32(ref_color_blend(a, b, bl8, false), color_blend(a, b, bl8, false));
+    TEST_ASSERT_EQUAL_HEX32(ref_color_blend(a, b, bl16, true), color_blend(a, b, bl16, true));
+  }
+}
+
+void test_add_bit_exact() {
+  for (unsigned n = 0; n < SAMPLES; n++) {
+    uint32_t a = testColor(), b = testColor();
+    TEST_ASSERT_EQUAL_HEX32(ref_color_add(a, b), color_add(a, b, true));
+  }
+}
+
+void test_fade_bit_exact() {
+  // all amounts for every color
+  for (unsigned n = 0; n < SAMPLES / 256; n++) {
+    uint32_t c = testColor();
+    for (unsigned amount = 0; amount < 256; amount++) {
+      TEST_ASSERT_EQUAL_HEX32(ref_color_fade(c, amount, false), color_fade(c, amount, false));
+      TEST_ASSERT_EQUAL_HEX32(ref_color_fade(c, amount, true),  color_fade(c, amount, true));
+    }
+  }
+}
+
+void test_spans_bit_exact() {
+  const unsigned len = 1037; // not a multiple of 4
+  std::vector<uint32_t> a(len), b(len), expected(len);
+  for (unsigned round = 0; round < 200; round++) {
+    for (unsigned i = 0; i < len; i++) { a[i] = testColor(); b[i] = testColor(); }
+    uint8_t amount = round == 0 ? 255 : rnd32();
+    bool video = round & 1;
+    for (unsigned i = 0; i < len; i++) expected[i] = ref_color_fade(a[i], amount, video);
+    std::vector<uint32_t> got = a;
+    color_fade_span(got.data(), len, amount, video);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(expected.data(), got.data(), len);
+
+    uint16_t blend = round == 1 ? 0xFFFF : (round == 2 ? 0 : rnd32());
+    bool b16 = round & 2;
+    if (!b16) blend &= 0xFF;
+    for (unsigned i = 0; i < len; i++) expected[i] = ref_color_blend(a[i], b[i], blend, b16);
+    got = a;
+    color_blend_span(got.data(), b.data(), len, blend, b16);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(expected.data(), got.data(), len);
+
+    for (unsigned i = 0; i < len; i++) expected[i] = ref_color_add(a[i], b[i]);
+    got = a;
+    color_add_span(got.data(), b.data(), len, true);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(expected.data(), got.data(), len);
+
+    // raw channel bytes, odd length and offset
+    const uint8_t *src = reinterpret_cast<const uint8_t*>(a.data()) + 1;
+    std::vector<uint8_t> dst(len * 4 - 3), expB(len * 4 - 3);
+    for (unsigned i = 0; i < expB.size(); i++) expB[i] = scale8(src[i], amount);
+    scale8_copy(dst.data(), src, dst.size(), amount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expB.data(), dst.data(), dst.size());
+  }
+}
+
+// every head/block/tail split a vectorized span can take: lengths 0..19 and all word offsets of dst and src
+void test_spans_all_alignments() {
+  std::vector<uint32_t> a(32), b(32), got(32);
+  for (unsigned round = 0; round < 64; round++) {
+    for (unsigned i = 0; i < a.size(); i++) { a[i] = testColor(); b[i] = testColor(); }
+    uint8_t amount = rnd32();
+    uint16_t blend = rnd32();
+    bool flag = round & 1;
+    for (unsigned dOff = 0; dOff < 4; dOff++) for (unsigned sOff = 0; sOff < 4; sOff++) for (unsigned n = 0; n < 20; n++) {
+      got = a;
+      color_fade_span(got.data() + dOff, n, amount, flag);
+      for (unsigned i = 0; i < n; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_fade(a[dOff + i], amount, flag), got[dOff + i]);
+      got = a;
+      color_blend_span(got.data() + dOff, b.data() + sOff, n, flag ? blend : blend & 0xFF, flag);
+      for (unsigned i = 0; i < n; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_blend(a[dOff + i], b[sOff + i], flag ? blend : blend & 0xFF, flag), got[dOff + i]);
+      got = a;
+      color_add_span(got.data() + dOff, b.data() + sOff, n, true);
+      for (unsigned i = 0; i < n; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_add(a[dOff + i], b[sOff + i]), got[dOff + i]);
+      TEST_ASSERT_EQUAL_HEX32(a[dOff + n], got[dOff + n]); // nothing written past the span
+    }
+  }
+}
+
+/*
+ * Host model of the PIE block kernels in colors.cpp: a 128 bit register is 8 unsigned 16 bit lanes,
+ * every function is one instruction. Sequences below are the asm in pieFadeBlocks(), pieBlendBlocks()
+ * and pieAddBlocks() line by line.
+ */
+struct PieQ { uint16_t l[8]; };
+static unsigned pieSar;
+static PieQ pieLd(const uint32_t *p) { PieQ q; for (int i = 0; i < 4; i++) { q.l[2*i] = p[i]; q.l[2*i+1] = p[i] >> 16; } return q; }
+static void pieSt(uint32_t *p, const PieQ &q) { for (int i = 0; i < 4; i++) p[i] = q.l[2*i] | (uint32_t(q.l[2*i+1]) << 16); }
+static PieQ pieBc(uint32_t v) { uint32_t p[4] = {v, v, v, v}; return pieLd(p); }
+static PieQ pieZero() { return pieBc(0); }
+static PieQ pieAnd(PieQ x, PieQ y) { for (int i = 0; i < 8; i++) x.l[i] &= y.l[i]; return x; }
+static PieQ pieOr(PieQ x, PieQ y)  { for (int i = 0; i < 8; i++) x.l[i] |= y.l[i]; return x; }
+static PieQ pieMulU16(PieQ x, PieQ y) { for (int i = 0; i < 8; i++) x.l[i] = (uint32_t(x.l[i]) * y.l[i]) >> pieSar; return x; }
+static PieQ pieAddsS16(PieQ x, PieQ y) {
+  for (int i = 0; i < 8; i++) {
+    int v = int16_t(x.l[i]) + int16_t(y.l[i]);
+    TEST_ASSERT_TRUE(v >= INT16_MIN && v <= INT16_MAX); // the kernels never rely on saturation
+    x.l[i] = v;
+  }
+  return x;
+}
+static PieQ pieMinS16(PieQ x, PieQ y) { for (int i = 0; i < 8; i++) x.l[i] = std::min(int16_t(x.l[i]), int16_t(y.l[i])); return x; }
+static PieQ pieCmpEqS16(PieQ x, PieQ y) { for (int i = 0; i < 8; i++) x.l[i] = x.l[i] == y.l[i] ? 0xFFFF : 0; return x; }
+
+static void pieFadeModel(uint32_t *c, uint32_t scale, bool video) {
+  PieQ q7 = pieBc(0x00FF00FF), q6 = pieBc(scale | (scale << 16)), q5 = pieBc(0x00010001), q4 = pieBc(0x01000100), q3 = pieZero();
+  PieQ q0 = pieLd(c), q1, q2;
+  pieSar = 8;
+  q1 = pieAnd(q0, q7);
+  q2 = pieMulU16(q0, q5);
+  if (!video) {
+    q1 = pieMulU16(q1, q6);
+    q2 = pieMulU16(q2, q6);
+  } else {
+    q0 = pieCmpEqS16(q1, q3);
+    q1 = pieMulU16(q1, q6);
+    q1 = pieAddsS16(q1, q5);
+    q1 = pieAddsS16(q1, q0);
+    q0 = pieCmpEqS16(q2, q3);
+    q2 = pieMulU16(q2, q6);
+    q2 = pieAddsS16(q2, q5);
+    q2 = pieAddsS16(q2, q0);
+  }
+  pieSar = 0;
+  q2 = pieMulU16(q2, q4);
+  pieSt(c, pieOr(q1, q2));
+}
+
+static void pieBlendModel(uint32_t *d, const uint32_t *s, uint8_t blend) {
+  PieQ q7 = pieBc(0x00FF00FF), q6 = pieBc(blend | (blend << 16)), q5 = pieBc(0x00010001), q4 = pieBc((255 - blend) | ((255 - blend) << 16));
+  PieQ q0, q1, q3;
+  for (int half = 0; half < 2; half++) {
+    q0 = pieLd(d);
+    q1 = pieLd(s);
+    if (!half) { q0 = pieAnd(q0, q7); q1 = pieAnd(q1, q7); }
+    else       { pieSar = 8; q0 = pieMulU16(q0, q5); q1 = pieMulU16(q1, q5); }
+    pieSar = 0;
+    q0 = pieMulU16(q0, q4);
+    q1 = pieMulU16(q1, q6);
+    pieSar = 1;
+    q0 = pieMulU16(q0, q5);
+    q1 = pieMulU16(q1, q5);
+    q0 = pieAddsS16(q0, q1);
+    pieSar = 7;
+    if (!half) q3 = pieMulU16(q0, q5);
+    else       q0 = pieMulU16(q0, q5);
+  }
+  pieSar = 0;
+  q0 = pieMulU16(q0, pieBc(0x01000100));
+  pieSt(d, pieOr(q0, q3));
+}
+
+static void pieAddModel(uint32_t *d, const uint32_t *s) {
+  PieQ q7 = pieBc(0x00FF00FF), q5 = pieBc(0x00010001), q4 = pieBc(0x01000100);
+  PieQ q0 = pieLd(d), q1 = pieLd(s), q2, q3;
+  pieSar = 8;
+  q2 = pieMulU16(q0, q5);
+  q3 = pieMulU16(q1, q5);
+  q0 = pieAnd(q0, q7);
+  q1 = pieAnd(q1, q7);
+  q0 = pieMinS16(pieAddsS16(q0, q1), q7);
+  q2 = pieMinS16(pieAddsS16(q2, q3), q7);
+  pieSar = 0;
+  q2 = pieMulU16(q2, q4);
+  pieSt(d, pieOr(q0, q2));
+}
+
+void test_pie_model_bit_exact() {
+  uint32_t a[4], b[4], got[4];
+  for (unsigned n = 0; n < SAMPLES / 64; n++) {
+    for (int i = 0; i < 4; i++) { a[i] = testColor(); b[i] = testColor(); }
+    uint8_t k = n; // every amount / blend
+    #if FASTLED_SCALE8_FIXED == 1
+    uint32_t scale = k + 1; // color_fade_span() returns early for 255
+    #else
+    uint32_t scale = k;
+    #endif
+    memcpy(got, a, sizeof(got));
+    if (k != 255 || FASTLED_SCALE8_FIXED != 1) {
+      pieFadeModel(got, scale, false);
+      for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_fade(a[i], k, false), got[i]);
+    }
+    memcpy(got, a, sizeof(got));
+    pieFadeModel(got, k, k != 0);
+    for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_fade(a[i], k, true), got[i]);
+    if (k != 0 && k != 255) { // handled before the block kernel
+      memcpy(got, a, sizeof(got));
+      pieBlendModel(got, b, k);
+      for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_blend(a[i], b[i], k, false), got[i]);
+    }
+    memcpy(got, a, sizeof(got));
+    pieAddModel(got, b);
+    for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_HEX32(ref_color_add(a[i], b[i]), got[i]);
+  }
+}
+
+// keeps the optimizer from dropping the benchmark loops
+static volatile uint32_t sink;
+
+template<typename F> static double nsPerPixel(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b, F kernel) {
+  uint32_t acc = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned round = 0; round < 50; round++)
+    for (size_t i = 0; i < a.size(); i++) acc += kernel(a[i], b[i], uint8_t(i + round));
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  sink = acc;
+  return ns / (50.0 * a.size());
+}
+
+void test_benchmark() {
+  std::vector<uint32_t> a(100000), b(100000);
+  for (size_t i = 0; i < a.size(); i++) { a[i] = rnd32(); b[i] = rnd32(); }
+  struct { const char *name; double ref, packed; } r[] = {
+    { "color_blend",      nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return ref_color_blend(x, y, k, false); }),
+                          nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return color_blend(x, y, k, false); }) },
+    { "color_blend b16",  nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return ref_color_blend(x, y, k * 257, true); }),
+                          nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return color_blend(x, y, k * 257, true); }) },
+    { "color_add fast",   nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return ref_color_add(x, y); }),
+                          nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return color_add(x, y, true); }) },
+    { "color_fade",       nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return ref_color_fade(x, k, false); }),
+                          nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return color_fade(x, k, false); }) },
+    { "color_fade video", nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return ref_color_fade(x, k, true); }),
+                          nsPerPixel(a, b, [](uint32_t x, uint32_t y, uint8_t k) { return color_fade(x, k, true); }) },
+  };
+  for (auto &e : r) {
+    char msg[100];
+    snprintf(msg, sizeof(msg), "%-16s per channel %5.2f ns/pixel, packed %5.2f ns/pixel", e.name, e.ref, e.packed);
+    TEST_MESSAGE(msg);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_blend_bit_exact);
+  RUN_TEST(test_add_bit_exact);
+  RUN_TEST(test_fade_bit_exact);
+  RUN_TEST(test_spans_bit_exact);
+  RUN_TEST(test_spans_all_alignments);
+  RUN_TEST(test_pie_model_bit_exact);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,95 @@
+/*
+ * Delta notifier (version 13)
+ * Changes are coalesced and only the changed segment field groups are sent. All fields are resent
+ * every NOTIFIER_DELTA_FULL ms, also while nothing changes, so late joining receivers catch up.
+ */
+#include <unity.h>
+#include <vector>
+#include "net_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+#include "../../wled00/udp.cpp"
+#include "../../wled00/e131.cpp"
+#include "../../wled00/telemetry.cpp"
+
+#define LEDS 60
+
+static void setupStrip() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  BusConfig bc(TYPE_WS2812_RGB, pins, 0, LEDS, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY);
+  busses.add(bc);
+  strip.isMatrix = false;
+  strip.finalizeInit();
+  strip.resetSegments();
+  udpConnected  = true;
+  notifierDelta = true;
+  notifyDirect  = true;
+  udpNumRetries = 0;
+  mockMicros    = 1000000;
+}
+
+static void advanceMs(unsigned ms) { mockMicros += ms * 1000ULL; }
+
+// one loop() pass; returns the delta notifications sent
+static std::vector<MockDatagram> loopOnce(unsigned ms = 10) {
+  advanceMs(ms);
+  mockUdpSent.clear();
+  handleNotifications();
+  std::vector<MockDatagram> sent;
+  for (auto &d : mockUdpSent) if (!d.data.empty() && d.data[0] == UDP_DELTA_PROTOCOL) sent.push_back(d);
+  return sent;
+}
+
+static bool isFull(const MockDatagram &d) { return d.data[21] & 0x01; }
+static uint8_t firstMask(const MockDatagram &d) { return d.data[22] ? d.data[UDP_DELTA_HDR + 1] : 0; }
+
+void setUp() {}
+void tearDown() {}
+
+// the first packet carries every group, a colour change afterwards only the colour group
+void test_changes_are_deltas() {
+  notify(CALL_MODE_DIRECT_CHANGE, false);
+  auto sent = loopOnce(NOTIFIER_DELTA_INTERVAL);
+  TEST_ASSERT_EQUAL(1, sent.size());
+  TEST_ASSERT_TRUE(isFull(sent[0]));
+  TEST_ASSERT_EQUAL(1, sent[0].data[22]);
+
+  strip.getSegment(0).setColor(0, RGBW32(1, 2, 3, 0));
+  notify(CALL_MODE_DIRECT_CHANGE, false);
+  TEST_ASSERT_EQUAL(0, loopOnce(1).size()); // coalesced within NOTIFIER_DELTA_INTERVAL
+  sent = loopOnce(NOTIFIER_DELTA_INTERVAL);
+  TEST_ASSERT_EQUAL(1, sent.size());
+  TEST_ASSERT_FALSE(isFull(sent[0]));
+  TEST_ASSERT_EQUAL_HEX8(SEG_DIFFERS_COL, firstMask(sent[0]));
+}
+
+// without any change the full state is resent once NOTIFIER_DELTA_FULL has passed, then not again before that
+void test_periodic_full_state() {
+  notify(CALL_MODE_DIRECT_CHANGE, false);
+  loopOnce(NOTIFIER_DELTA_INTERVAL);
+  unsigned full = 0;
+  for (unsigned t = 0; t < NOTIFIER_DELTA_FULL - 1000; t += 500) full += loopOnce(500).size();
+  TEST_ASSERT_EQUAL(0, full);
+  for (unsigned t = 0; t < 2000; t += 500) {
+    for (auto &d : loopOnce(500)) {
+      TEST_ASSERT_TRUE(isFull(d));
+      TEST_ASSERT_EQUAL(1, d.data[22]);
+      TEST_ASSERT_EQUAL_HEX8(SEG_DIFFERS_BRI | SEG_DIFFERS_OPT | SEG_DIFFERS_COL | SEG_DIFFERS_FX | SEG_DIFFERS_BOUNDS | SEG_DIFFERS_GSO, firstMask(d));
+      full++;
+    }
+  }
+  TEST_ASSERT_EQUAL(1, full);
+  for (unsigned t = 0; t < NOTIFIER_DELTA_FULL - 2000; t += 500) full += loopOnce(500).size();
+  TEST_ASSERT_EQUAL(1, full);
+}
+
+int main(int argc, char **argv) {
+  setupStrip();
+  UNITY_BEGIN();
+  RUN_TEST(test_changes_are_deltas);
+  RUN_TEST(test_periodic_full_state);
+  return UNITY_END();
+}
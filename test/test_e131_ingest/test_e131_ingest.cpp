@@ -0,0 +1,242 @@
+/*
+ * Realtime ingest of a 4-universe E1.31 frame (680 RGB LEDs, DMX_MODE_MULTIPLE_RGB)
+ * Packets are produced by the E1.31 output and fed to handleE131Packet(), loop() (handleE131Frame()) shows
+ * the frame; the strip must hold it (gamma corrected if enabled) exactly as the former per pixel
+ * setRealtimePixel() path left it. Universes of the next frame must not change a frame waiting to be shown.
+ * A sender using E1.31 synchronization is only waited for while its synchronization packets arrive.
+ * Packets/s (including show()) of the bulk path (setRealtimePixels()) and the per pixel path are reported.
+ */
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include "net_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+#include "../../wled00/udp.cpp"
+#include "../../wled00/e131.cpp"
+#include "../../wled00/telemetry.cpp"
+
+#define LEDS        680  // 4 universes of 170 RGB LEDs
+#define UNIVERSES   4
+#define FRAMES      2000
+
+static const IPAddress sender(192, 168, 1, 60);
+static std::vector<e131_packet_t> packets;
+static std::vector<uint8_t> image;
+static std::vector<e131_packet_t> packets2; // second frame (other image)
+static std::vector<uint8_t> image2;
+
+// packets of a frame (and the synchronization packet if syncUniverse is set)
+static void makeFrame(std::vector<uint8_t> &img, std::vector<e131_packet_t> &pkts, uint32_t seed, uint16_t syncUniverse = 0) {
+  img.resize(LEDS * 3);
+  for (auto &c : img) { seed = seed * 1664525 + 1013904223; c = seed >> 24; }
+  e131OutUniverse = e131Universe;
+  e131OutSyncUniverse = syncUniverse;
+  mockUdpSent.clear();
+  TEST_ASSERT_EQUAL(0, realtimeBroadcast(1, sender, LEDS, img.data(), 255, false, nullptr));
+  e131OutSyncUniverse = 0;
+  TEST_ASSERT_EQUAL(UNIVERSES + (syncUniverse ? 1 : 0), mockUdpSent.size());
+  pkts.assign(mockUdpSent.size(), e131_packet_t());
+  for (unsigned u = 0; u < pkts.size(); u++) memcpy(pkts[u].raw, mockUdpSent[u].data.data(), mockUdpSent[u].data.size());
+}
+
+// one pass of loop() 20 ms later (frames are shown at most every 15 ms)
+static void loop() {
+  mockMicros += 20000;
+  handleE131Frame();
+}
+
+static void ingest(std::vector<e131_packet_t> &pkts) {
+  for (auto &p : pkts) handleE131Packet(&p, sender, P_E131);
+  loop();
+}
+
+static void setupStrip() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  for (unsigned i = 0; i < 2; i++) {
+    pins[0] = 2 + i;
+    BusConfig bc(TYPE_WS2812_RGB, pins, i * LEDS/2, LEDS/2, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY);
+    busses.add(bc);
+  }
+  strip.isMatrix = false;
+  strip.finalizeInit();
+  strip.resetSegments();
+  NeoGammaWLEDMethod::calcGammaTable(gammaCorrectVal);
+
+  DMXMode      = DMX_MODE_MULTIPLE_RGB;
+  DMXAddress   = 1;
+  e131Universe = 1;
+  realtimeTimeoutMs = 65000; // never time out
+
+  // frames as sent by another WLED instance
+  makeFrame(image, packets, 11);
+  makeFrame(image2, packets2, 12);
+
+  // the first packet enters realtime mode, loop() then allocates the frame buffers
+  handleE131Packet(&packets[0], sender, P_E131);
+  loop();
+}
+
+static void clearStrip() {
+  for (unsigned i = 0; i < LEDS; i++) strip.setPixelColor(i, BLACK);
+}
+
+// what handleE131Packet() did before the bulk ingest path: one setRealtimePixel() per LED
+static void ingestPerPixel(const e131_packet_t &p) {
+  const unsigned uni = htons(p.universe) - e131Universe;
+  const unsigned channels = htons(p.property_value_count) - 1;
+  const uint8_t *data = p.property_values + 1;
+  const unsigned first = uni * 170;
+  for (unsigned i = 0; i < channels / 3 && first + i < LEDS; i++)
+    setRealtimePixel(first + i, data[i*3], data[i*3+1], data[i*3+2], 0);
+}
+
+static void assertImage(bool gamma, const std::vector<uint8_t> &img = image, unsigned from = 0, unsigned to = LEDS) {
+  for (unsigned i = from; i < to; i++) {
+    uint8_t r = img[i*3], g = img[i*3+1], b = img[i*3+2];
+    if (gamma) { r = gamma8(r); g = gamma8(g); b = gamma8(b); }
+    TEST_ASSERT_EQUAL_HEX32(RGBW32(r, g, b, 0), strip.getPixelColor(i));
+  }
+}
+
+void setUp() {
+  arlsDisableGammaCorrection = true;
+  arlsOffset = 0;
+  useMainSegmentOnly = false;
+  clearStrip();
+}
+void tearDown() {}
+
+void test_frame_is_complete() {
+  const uint32_t complete = realtimeFramesComplete;
+  for (auto &p : packets) handleE131Packet(&p, sender, P_E131);
+  TEST_ASSERT_EQUAL(complete + 1, realtimeFramesComplete);
+  TEST_ASSERT_EQUAL(REALTIME_MODE_E131, realtimeMode);
+  TEST_ASSERT_EQUAL_HEX32(BLACK, strip.getPixelColor(0)); // not before loop()
+  const unsigned long shown = strip.getLastShow();
+  loop();
+  TEST_ASSERT_NOT_EQUAL(shown, strip.getLastShow());
+  assertImage(false);
+}
+
+// universes of the next frame arriving before loop() ran do not change the frame waiting to be shown
+void test_next_frame_does_not_overwrite() {
+  for (auto &p : packets) handleE131Packet(&p, sender, P_E131);
+  handleE131Packet(&packets2[0], sender, P_E131);
+  handleE131Packet(&packets2[1], sender, P_E131);
+  loop();
+  assertImage(false);
+  handleE131Packet(&packets2[2], sender, P_E131);
+  handleE131Packet(&packets2[3], sender, P_E131);
+  loop();
+  assertImage(false, image2);
+}
+
+// a complete frame replaced before loop() took it is counted as skipped, the newer one is shown
+void test_skipped_frame() {
+  const uint32_t skipped = realtimeFramesSkipped;
+  for (auto &p : packets) handleE131Packet(&p, sender, P_E131);
+  ingest(packets2);
+  TEST_ASSERT_EQUAL(skipped + 1, realtimeFramesSkipped);
+  assertImage(false, image2);
+}
+
+// a missing universe is waited for realtimeFrameTimeout, its LEDs keep the previous frame
+void test_missing_universe() {
+  ingest(packets);
+  const uint32_t incomplete = realtimeFramesIncomplete;
+  for (unsigned u = 0; u < UNIVERSES - 1; u++) handleE131Packet(&packets2[u], sender, P_E131);
+  mockMicros += 20000;
+  handleE131Frame();
+  assertImage(false); // not shown before the timeout
+  mockMicros += realtimeFrameTimeout * 1000;
+  handleE131Frame();
+  TEST_ASSERT_EQUAL(incomplete + 1, realtimeFramesIncomplete);
+  assertImage(false, image2, 0, (UNIVERSES - 1) * 170);
+  assertImage(false, image, (UNIVERSES - 1) * 170, LEDS);
+}
+
+// synchronized sender: a complete frame waits for the synchronization packet, its multicast group is joined
+void test_synchronized_sender() {
+  std::vector<e131_packet_t> a, b;
+  std::vector<uint8_t> imgA, imgB;
+  makeFrame(imgA, a, 21, 7000);
+  makeFrame(imgB, b, 22, 7000);
+  for (auto &p : a) handleE131Packet(&p, sender, P_E131);
+  loop();
+  TEST_ASSERT_EQUAL(7000, mockE131SyncUniverse);
+  assertImage(false, imgA);
+  for (unsigned u = 0; u < UNIVERSES; u++) handleE131Packet(&b[u], sender, P_E131);
+  loop();
+  assertImage(false, imgA); // complete, but not synchronized yet
+  handleE131Packet(&b[UNIVERSES], sender, P_E131);
+  loop();
+  assertImage(false, imgB);
+}
+
+// synchronization packets that do not arrive (not routed, group not joined): frames are shown once complete
+void test_lost_synchronization() {
+  std::vector<e131_packet_t> a;
+  std::vector<uint8_t> imgA;
+  makeFrame(imgA, a, 23, 7001);
+  mockMicros += 4000000; // last synchronization packet (previous test) too old
+  for (unsigned u = 0; u < UNIVERSES; u++) handleE131Packet(&a[u], sender, P_E131);
+  loop();
+  assertImage(false, imgA);
+  TEST_ASSERT_EQUAL(7001, mockE131SyncUniverse);
+}
+
+void test_gamma_corrected() {
+  arlsDisableGammaCorrection = false;
+  ingest(packets);
+  assertImage(true);
+  clearStrip();
+  for (auto &p : packets) ingestPerPixel(p);
+  assertImage(true);
+}
+
+void test_main_segment_only() {
+  useMainSegmentOnly = true;
+  ingest(packets);
+  assertImage(false);
+}
+
+template<typename F> static double packetsPerSecond(F ingestFrame) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned f = 0; f < FRAMES; f++) ingestFrame();
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return FRAMES * UNIVERSES / s;
+}
+
+void test_packets_per_second() {
+  for (int gc = 0; gc < 2; gc++) {
+    arlsDisableGammaCorrection = !gc;
+    double bulk  = packetsPerSecond([]() { ingest(packets); });
+    assertImage(gc);
+    clearStrip();
+    double pixel = packetsPerSecond([]() { for (auto &p : packets) ingestPerPixel(p); strip.show(); });
+    assertImage(gc);
+    char msg[120];
+    snprintf(msg, sizeof(msg), "4 universe frame, gamma %s: handleE131Packet + show %9.0f packets/s, per pixel + show %9.0f packets/s",
+             gc ? "on " : "off", bulk, pixel);
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(int argc, char **argv) {
+  setupStrip();
+  UNITY_BEGIN();
+  RUN_TEST(test_frame_is_complete);
+  RUN_TEST(test_next_frame_does_not_overwrite);
+  RUN_TEST(test_skipped_frame);
+  RUN_TEST(test_missing_universe);
+  RUN_TEST(test_synchronized_sender);
+  RUN_TEST(test_lost_synchronization);
+  RUN_TEST(test_gamma_corrected);
+  RUN_TEST(test_main_segment_only);
+  RUN_TEST(test_packets_per_second);
+  return UNITY_END();
+}
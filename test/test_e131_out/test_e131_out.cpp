@@ -0,0 +1,271 @@
+/*
+ * E1.31 (sACN) network bus output
+ * Every datagram realtimeBroadcast() sends is decoded by an independent reference parser written from
+ * ANSI E1.31-2016 (fixed field offsets, no WLED definitions) and checked layer by layer.
+ * Also covers the cached data packet header and the bounded datagram pacing.
+ */
+#include <unity.h>
+#include <vector>
+#include "net_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+#include "../../wled00/udp.cpp"
+#include "../../wled00/e131.cpp"
+#include "../../wled00/telemetry.cpp"
+
+static const IPAddress target(192, 168, 1, 50);
+
+static uint16_t be16(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+static uint32_t be32(const uint8_t *p) { return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+
+struct SacnPacket {
+  bool     sync;
+  uint8_t  priority;
+  uint16_t syncAddress;
+  uint8_t  sequence;
+  uint16_t universe;
+  std::string source;
+  std::vector<uint8_t> data; // DMX slots after the start code
+};
+
+// reference parser, asserts everything the standard requires of a data or synchronization packet
+static SacnPacket decode(const MockDatagram &d) {
+  SacnPacket s = {};
+  const uint8_t *p = d.data.data();
+  const size_t len = d.data.size();
+  static const uint8_t acnId[12] = {'A','S','C','-','E','1','.','1','7',0,0,0};
+
+  TEST_ASSERT_EQUAL(5568, d.port);
+  TEST_ASSERT_TRUE(target == d.ip);
+  TEST_ASSERT_TRUE(len >= 49);
+  // root layer
+  TEST_ASSERT_EQUAL_HEX16(0x0010, be16(p));
+  TEST_ASSERT_EQUAL_HEX16(0x0000, be16(p + 2));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(acnId, p + 4, 12);
+  TEST_ASSERT_EQUAL_HEX16(0x7000 | (len - 16), be16(p + 16));
+  const uint32_t rootVector = be32(p + 18);
+  uint8_t cid[16] = {'W','L','E','D','-','s','A','C','N','-'};
+  WiFi.macAddress(cid + 10);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(cid, p + 22, 16);
+  // framing layer
+  TEST_ASSERT_EQUAL_HEX16(0x7000 | (len - 38), be16(p + 38));
+  const uint32_t frameVector = be32(p + 40);
+
+  if (rootVector == 0x00000008) { // VECTOR_ROOT_E131_EXTENDED
+    TEST_ASSERT_EQUAL(49, len);
+    TEST_ASSERT_EQUAL_HEX32(0x00000001, frameVector); // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+    s.sync        = true;
+    s.sequence    = p[44];
+    s.syncAddress = be16(p + 45);
+    TEST_ASSERT_EQUAL_HEX16(0, be16(p + 47));          // reserved
+    return s;
+  }
+
+  TEST_ASSERT_EQUAL_HEX32(0x00000004, rootVector);     // VECTOR_ROOT_E131_DATA
+  TEST_ASSERT_EQUAL_HEX32(0x00000002, frameVector);    // VECTOR_E131_DATA_PACKET
+  TEST_ASSERT_TRUE(len >= 126 && len <= 638);
+  TEST_ASSERT_TRUE(memchr(p + 44, 0, 64) != nullptr);  // source name is null terminated
+  s.source      = std::string((const char*)p + 44);
+  s.priority    = p[108];
+  s.syncAddress = be16(p + 109);
+  s.sequence    = p[111];
+  TEST_ASSERT_EQUAL_HEX8(0, p[112]);                   // options: no preview, no stream termination
+  s.universe    = be16(p + 113);
+  TEST_ASSERT_TRUE(s.universe >= 1 && s.universe <= 63999);
+  // DMP layer
+  TEST_ASSERT_EQUAL_HEX16(0x7000 | (len - 115), be16(p + 115));
+  TEST_ASSERT_EQUAL_HEX8(0x02, p[117]);                // VECTOR_DMP_SET_PROPERTY
+  TEST_ASSERT_EQUAL_HEX8(0xA1, p[118]);                // address & data type
+  TEST_ASSERT_EQUAL_HEX16(0x0000, be16(p + 119));      // first property address
+  TEST_ASSERT_EQUAL_HEX16(0x0001, be16(p + 121));      // address increment
+  TEST_ASSERT_EQUAL(len - 125, be16(p + 123));         // property value count (start code + slots)
+  TEST_ASSERT_EQUAL_HEX8(0x00, p[125]);                // DMX start code
+  s.data.assign(p + 126, p + len);
+  return s;
+}
+
+static std::vector<uint8_t> frame(size_t channels, uint32_t seed) {
+  std::vector<uint8_t> buf(channels);
+  for (auto &c : buf) { seed = seed * 1664525 + 1013904223; c = seed >> 24; }
+  return buf;
+}
+
+static std::vector<SacnPacket> send(std::vector<uint8_t> &buf, uint16_t leds, bool rgbw, uint8_t b, uint16_t *packets = nullptr) {
+  mockUdpSent.clear();
+  TEST_ASSERT_EQUAL(0, realtimeBroadcast(1, target, leds, buf.data(), b, rgbw, packets));
+  std::vector<SacnPacket> out;
+  for (const auto &d : mockUdpSent) out.push_back(decode(d));
+  return out;
+}
+
+// channel data of all universes put back together must be the (dimmed) frame
+static void assertFrame(const std::vector<SacnPacket> &pkts, const std::vector<uint8_t> &buf, uint8_t b, size_t perUniverse) {
+  std::vector<uint8_t> expected(buf.size()), received;
+  for (size_t i = 0; i < buf.size(); i++) expected[i] = (buf[i] * (b + 1)) >> 8;
+  for (const auto &s : pkts) {
+    if (s.sync) continue;
+    TEST_ASSERT_TRUE(s.data.size() <= perUniverse);
+    received.insert(received.end(), s.data.begin(), s.data.end());
+  }
+  TEST_ASSERT_EQUAL(expected.size(), received.size());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), received.data(), expected.size());
+}
+
+void setUp() {
+  e131OutUniverse     = 1;
+  e131OutPriority     = 100;
+  e131OutSyncUniverse = 0;
+  realtimeOutPacing   = 0;
+  strcpy(serverDescription, "WLED");
+}
+void tearDown() {}
+
+// 500 RGB LEDs: 1500 channels in 510 + 510 + 480 (whole LEDs per universe)
+void test_rgb_frame() {
+  auto buf = frame(500 * 3, 1);
+  e131OutUniverse = 10;
+  uint16_t packets = 0;
+  auto pkts = send(buf, 500, false, 255, &packets);
+  TEST_ASSERT_EQUAL(3, pkts.size());
+  TEST_ASSERT_EQUAL(3, packets);
+  const size_t sizes[] = {510, 510, 480};
+  for (unsigned i = 0; i < 3; i++) {
+    TEST_ASSERT_FALSE(pkts[i].sync);
+    TEST_ASSERT_EQUAL(10 + i, pkts[i].universe);
+    TEST_ASSERT_EQUAL(sizes[i], pkts[i].data.size());
+    TEST_ASSERT_EQUAL(100, pkts[i].priority);
+    TEST_ASSERT_EQUAL(0, pkts[i].syncAddress);
+    TEST_ASSERT_EQUAL_STRING("WLED", pkts[i].source.c_str());
+  }
+  assertFrame(pkts, buf, 255, 510);
+}
+
+// 300 RGBW LEDs: 1200 channels in 512 + 512 + 176, scaled by brightness
+void test_rgbw_frame_dimmed() {
+  auto buf = frame(300 * 4, 2);
+  strcpy(serverDescription, "Living room");
+  e131OutPriority = 150;
+  auto pkts = send(buf, 300, true, 77);
+  TEST_ASSERT_EQUAL(3, pkts.size());
+  TEST_ASSERT_EQUAL(512, pkts[0].data.size());
+  TEST_ASSERT_EQUAL(176, pkts[2].data.size());
+  for (const auto &s : pkts) {
+    TEST_ASSERT_EQUAL(150, s.priority);
+    TEST_ASSERT_EQUAL_STRING("Living room", s.source.c_str());
+  }
+  assertFrame(pkts, buf, 77, 512);
+}
+
+// sequence numbers count per universe, receivers drop packets that go back in sequence
+void test_sequence_per_universe() {
+  auto buf = frame(200 * 3, 3);
+  auto a = send(buf, 200, false, 255);
+  auto b = send(buf, 200, false, 255);
+  TEST_ASSERT_EQUAL(2, a.size());
+  for (unsigned i = 0; i < 2; i++) TEST_ASSERT_EQUAL_UINT8(uint8_t(a[i].sequence + 1), b[i].sequence);
+  // a universe not sent in between keeps its own count
+  send(buf, 100, false, 255);
+  auto c = send(buf, 200, false, 255);
+  TEST_ASSERT_EQUAL_UINT8(uint8_t(b[0].sequence + 2), c[0].sequence);
+  TEST_ASSERT_EQUAL_UINT8(uint8_t(b[1].sequence + 1), c[1].sequence);
+  // universes 32 apart do not share a count
+  auto big = frame(170 * 3 * 33, 4);
+  auto d = send(big, 170 * 33, false, 255);
+  TEST_ASSERT_EQUAL(33, d.size());
+  auto e = send(buf, 170, false, 255);
+  TEST_ASSERT_EQUAL_UINT8(uint8_t(d[0].sequence + 1), e[0].sequence);
+  auto f = send(big, 170 * 33, false, 255);
+  TEST_ASSERT_EQUAL_UINT8(uint8_t(d[0].sequence + 2), f[0].sequence);
+  TEST_ASSERT_EQUAL_UINT8(uint8_t(d[32].sequence + 1), f[32].sequence);
+  TEST_ASSERT_EQUAL_UINT8(uint8_t(d[31].sequence + 1), f[31].sequence);
+}
+
+// with a synchronization universe every data packet announces it and one sync packet ends the frame
+void test_sync_packet() {
+  auto buf = frame(400 * 3, 4);
+  e131OutSyncUniverse = 7;
+  uint16_t packets = 0;
+  auto a = send(buf, 400, false, 255, &packets);
+  TEST_ASSERT_EQUAL(4, a.size());
+  TEST_ASSERT_EQUAL(4, packets);
+  for (unsigned i = 0; i < 3; i++) {
+    TEST_ASSERT_FALSE(a[i].sync);
+    TEST_ASSERT_EQUAL(7, a[i].syncAddress);
+  }
+  TEST_ASSERT_TRUE(a[3].sync);
+  TEST_ASSERT_EQUAL(7, a[3].syncAddress);
+  auto b = send(buf, 400, false, 255);
+  TEST_ASSERT_EQUAL_UINT8(uint8_t(a[3].sequence + 1), b[3].sequence);
+  assertFrame(b, buf, 255, 510);
+}
+
+// universes above 63999 do not exist: data that would need them is not sent, the rest of the frame is
+void test_universe_limit() {
+  auto buf = frame(500 * 3, 5);
+  e131OutUniverse = 63998;
+  e131OutSyncUniverse = 1;
+  uint16_t packets = 0;
+  auto pkts = send(buf, 500, false, 255, &packets);
+  TEST_ASSERT_EQUAL(3, pkts.size());
+  TEST_ASSERT_EQUAL(3, packets);
+  TEST_ASSERT_EQUAL(63998, pkts[0].universe);
+  TEST_ASSERT_EQUAL(63999, pkts[1].universe);
+  TEST_ASSERT_EQUAL(510, pkts[1].data.size());
+  TEST_ASSERT_TRUE(pkts[2].sync);
+  buf.resize(2 * 510);
+  assertFrame(pkts, buf, 255, 510);
+
+  e131OutUniverse = 63999;
+  pkts = send(buf, 1, false, 255);
+  TEST_ASSERT_EQUAL(2, pkts.size());
+  TEST_ASSERT_EQUAL(63999, pkts[0].universe);
+  TEST_ASSERT_EQUAL(3, pkts[0].data.size());
+}
+
+// the cached header follows every setting it contains
+void test_header_follows_settings() {
+  auto buf = frame(100 * 3, 6);
+  auto a = send(buf, 100, false, 255);
+  e131OutPriority = 42;
+  e131OutSyncUniverse = 9;
+  strcpy(serverDescription, "Porch");
+  auto b = send(buf, 100, false, 255);
+  TEST_ASSERT_EQUAL(100, a[0].priority);
+  TEST_ASSERT_EQUAL(42, b[0].priority);
+  TEST_ASSERT_EQUAL(9, b[0].syncAddress);
+  TEST_ASSERT_EQUAL_STRING("Porch", b[0].source.c_str());
+  strcpy(serverDescription, "Porch 2");
+  auto c = send(buf, 100, false, 255);
+  TEST_ASSERT_EQUAL_STRING("Porch 2", c[0].source.c_str());
+  assertFrame(c, buf, 255, 510);
+}
+
+// datagrams are spaced by realtimeOutPacing, but a frame never waits longer than UDP_OUT_PACING_MAX in total
+void test_pacing_is_bounded() {
+  auto buf = frame(850 * 3, 7); // 5 universes
+  realtimeOutPacing = 100;
+  mockMicros += 10000;
+  uint64_t t0 = mockMicros;
+  TEST_ASSERT_EQUAL(5, send(buf, 850, false, 255).size());
+  TEST_ASSERT_EQUAL(4 * 100, mockMicros - t0);
+
+  realtimeOutPacing = 5000;
+  mockMicros += 10000;
+  t0 = mockMicros;
+  TEST_ASSERT_EQUAL(5, send(buf, 850, false, 255).size());
+  TEST_ASSERT_EQUAL(UDP_OUT_PACING_MAX, mockMicros - t0);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_rgb_frame);
+  RUN_TEST(test_rgbw_frame_dimmed);
+  RUN_TEST(test_sequence_per_universe);
+  RUN_TEST(test_sync_packet);
+  RUN_TEST(test_universe_limit);
+  RUN_TEST(test_header_follows_settings);
+  RUN_TEST(test_pacing_is_bounded);
+  return UNITY_END();
+}
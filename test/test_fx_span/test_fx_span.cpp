@@ -0,0 +1,223 @@
+/*
+ * Segment span/row API on a 64x64 matrix
+ * Spans must paint and read exactly the same physical pixels as per pixel setPixelColorXY()/getPixelColorXY()
+ * for every segment option; µs/frame of the span based helpers and their per pixel equivalents are reported.
+ */
+#include <unity.h>
+#include <chrono>
+#include "fx_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+
+#define MATRIX_W 64
+#define MATRIX_H 64
+
+static uint32_t rnd = 1;
+static uint32_t nextColor() { rnd = rnd * 1664525 + 1013904223; return rnd & 0x00FFFFFF; }
+
+// 64x64 serpentine matrix on 4 busses of 1024 LEDs
+static void setupMatrix() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  for (unsigned i = 0; i < 4; i++) {
+    pins[0] = 2 + i;
+    BusConfig bc(TYPE_WS2812_RGB, pins, i * 1024, 1024, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY);
+    busses.add(bc);
+  }
+  strip.isMatrix = true;
+  strip.panels = 1;
+  strip.panel.clear();
+  WS2812FX::Panel p;
+  p.width = MATRIX_W;
+  p.height = MATRIX_H;
+  p.serpentine = true;
+  strip.panel.push_back(p);
+  strip.finalizeInit();
+  strip.resetSegments();
+}
+
+static Segment &resetSegment(uint16_t options = 0, uint8_t grouping = 1, uint8_t spacing = 0) {
+  Segment &seg = strip.getSegment(0);
+  seg.setUp(0, MATRIX_W, grouping, spacing, 0, 0, MATRIX_H);
+  seg.options = (seg.options & ~(uint16_t)(REVERSE | MIRROR | REVERSE_Y_2D | MIRROR_Y_2D | TRANSPOSED)) | options;
+  strip.fill(BLACK);
+  return seg;
+}
+
+static std::vector<uint32_t> physical() {
+  std::vector<uint32_t> px(MATRIX_W * MATRIX_H);
+  for (unsigned i = 0; i < px.size(); i++) px[i] = strip.getPixelColor(i);
+  return px;
+}
+
+static void assertSame(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
+  TEST_ASSERT_EQUAL(a.size(), b.size());
+  TEST_ASSERT_EQUAL_UINT32_ARRAY(a.data(), b.data(), a.size());
+}
+
+static const struct { uint16_t options; uint8_t grouping, spacing; const char *name; } layouts[] = {
+  { 0,                     1, 0, "plain" },
+  { REVERSE,               1, 0, "reverse" },
+  { MIRROR,                1, 0, "mirror" },
+  { REVERSE_Y_2D,          1, 0, "reverse Y" },
+  { MIRROR_Y_2D,           1, 0, "mirror Y" },
+  { TRANSPOSED,            1, 0, "transpose" },
+  { REVERSE | MIRROR_Y_2D | TRANSPOSED, 1, 0, "reverse, mirror Y, transpose" },
+  { 0,                     2, 1, "grouping 2, spacing 1" },
+  { MIRROR | REVERSE_Y_2D, 3, 0, "grouping 3, mirror, reverse Y" },
+};
+
+// rows and columns written as spans land on the same LEDs as single pixels
+void test_span_write_matches_pixels() {
+  for (const auto &l : layouts) {
+    TEST_MESSAGE(l.name);
+    Segment &seg = resetSegment(l.options, l.grouping, l.spacing);
+    const unsigned cols = seg.virtualWidth(), rows = seg.virtualHeight();
+    std::vector<uint32_t> img(cols * rows);
+    for (auto &c : img) c = nextColor();
+
+    for (unsigned y = 0; y < rows; y++) for (unsigned x = 0; x < cols; x++) seg.setPixelColorXY((int)x, (int)y, img[y * cols + x]);
+    auto expected = physical();
+
+    resetSegment(l.options, l.grouping, l.spacing);
+    for (unsigned y = 0; y < rows; y++) seg.setRow(y, &img[y * cols]);
+    assertSame(expected, physical());
+
+    resetSegment(l.options, l.grouping, l.spacing);
+    std::vector<uint32_t> col(rows);
+    for (unsigned x = 0; x < cols; x++) {
+      for (unsigned y = 0; y < rows; y++) col[y] = img[y * cols + x];
+      seg.setCol(x, col.data());
+    }
+    assertSame(expected, physical());
+
+    // spans running past the segment end are clipped, spans starting outside of it paint nothing
+    resetSegment(l.options, l.grouping, l.spacing);
+    std::vector<uint32_t> line(cols + 5);
+    for (unsigned y = 0; y < rows; y++) {
+      for (unsigned x = 0; x < line.size(); x++) line[x] = x < cols ? img[y * cols + x] : nextColor();
+      seg.setPixelSpanXY(0, y, cols / 2, line.data());
+      seg.setPixelSpanXY(cols / 2, y, line.size() - cols / 2, line.data() + cols / 2);
+      seg.setPixelSpanXY(-1, y, line.size(), line.data() + 1);
+      seg.setPixelSpanXY(cols, y, 5, line.data() + cols);
+    }
+    assertSame(expected, physical());
+
+    // reading back
+    std::vector<uint32_t> row(cols);
+    for (unsigned y = 0; y < rows; y++) {
+      seg.getRow(y, row.data());
+      for (unsigned x = 0; x < cols; x++) TEST_ASSERT_EQUAL_HEX32(seg.getPixelColorXY(x, y), row[x]);
+    }
+    for (unsigned x = 0; x < cols; x++) {
+      seg.getCol(x, col.data());
+      for (unsigned y = 0; y < rows; y++) TEST_ASSERT_EQUAL_HEX32(seg.getPixelColorXY(x, y), col[y]);
+    }
+  }
+}
+
+// per pixel versions of the helpers, as they were before the span API (blur from FastLED colorutils.cpp)
+static void pixelFill(Segment &seg, uint32_t c) {
+  for (int y = 0; y < MATRIX_H; y++) for (int x = 0; x < MATRIX_W; x++) seg.setPixelColorXY(x, y, c);
+}
+static void pixelFade(Segment &seg, uint8_t fadeBy) {
+  for (int y = 0; y < MATRIX_H; y++) for (int x = 0; x < MATRIX_W; x++) seg.setPixelColorXY(x, y, color_fade(seg.getPixelColorXY(x, y), 255-fadeBy));
+}
+static void pixelMoveX(Segment &seg, int delta) {
+  uint32_t line[MATRIX_W];
+  for (int y = 0; y < MATRIX_H; y++) {
+    for (int x = 0; x < MATRIX_W; x++) line[x] = seg.getPixelColorXY(x, y);
+    for (int x = 0; x < MATRIX_W; x++) seg.setPixelColorXY(x, y, line[(x + delta + MATRIX_W) % MATRIX_W]);
+  }
+}
+static void pixelMoveY(Segment &seg, int delta) {
+  uint32_t line[MATRIX_H];
+  for (int x = 0; x < MATRIX_W; x++) {
+    for (int y = 0; y < MATRIX_H; y++) line[y] = seg.getPixelColorXY(x, y);
+    for (int y = 0; y < MATRIX_H; y++) seg.setPixelColorXY(x, y, line[(y + delta + MATRIX_H) % MATRIX_H]);
+  }
+}
+static void pixelBlur(Segment &seg, uint8_t blur_amount) {
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  for (int line = 0; line < MATRIX_H + MATRIX_W; line++) {
+    const bool vertical = line >= MATRIX_H;
+    const int len = vertical ? MATRIX_H : MATRIX_W;
+    CRGB carryover = CRGB::Black;
+    for (int i = 0; i < len; i++) {
+      const int x = vertical ? line - MATRIX_H : i, y = vertical ? i : line;
+      CRGB cur = seg.getPixelColorXY(x, y);
+      CRGB before = cur;
+      CRGB part = cur;
+      part.nscale8(seep);
+      cur.nscale8(keep);
+      cur += carryover;
+      if (i > 0) {
+        const int px = vertical ? x : x-1, py = vertical ? y-1 : y;
+        CRGB prev = CRGB(seg.getPixelColorXY(px, py));
+        prev += part;
+        seg.setPixelColorXY(px, py, prev);
+      }
+      if (before != cur) seg.setPixelColorXY(x, y, cur);
+      carryover = part;
+    }
+  }
+}
+
+static void randomImage(Segment &seg) {
+  for (int y = 0; y < MATRIX_H; y++) for (int x = 0; x < MATRIX_W; x++) seg.setPixelColorXY(x, y, nextColor());
+}
+
+template<typename F> static double usPerFrame(Segment &seg, unsigned frames, F op) {
+  double us = 0;
+  for (unsigned f = 0; f < frames; f++) {
+    randomImage(seg);
+    auto t0 = std::chrono::steady_clock::now();
+    op();
+    us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  }
+  return us / frames;
+}
+
+// span based helper and per pixel version must give identical frames; both are timed
+template<typename S, typename P> static void compare(const char *name, S span, P pixel) {
+  Segment &seg = resetSegment();
+  uint32_t seed = rnd;
+  randomImage(seg);
+  span(seg);
+  auto expected = physical();
+  rnd = seed;
+  randomImage(seg);
+  pixel(seg);
+  assertSame(expected, physical());
+
+  const unsigned frames = 100;
+  double usPixel = usPerFrame(seg, frames, [&]() { pixel(seg); });
+  double usSpan  = usPerFrame(seg, frames, [&]() { span(seg); });
+  char msg[120];
+  snprintf(msg, sizeof(msg), "64x64 %-14s per pixel %7.1f us/frame, spans %7.1f us/frame", name, usPixel, usSpan);
+  TEST_MESSAGE(msg);
+}
+
+void test_fill()    { compare("fill()",          [](Segment &s) { s.fill(0x123456); },     [](Segment &s) { pixelFill(s, 0x123456); }); }
+void test_fade()    { compare("fadeToBlackBy()", [](Segment &s) { s.fadeToBlackBy(40); },  [](Segment &s) { pixelFade(s, 40); }); }
+void test_move_x()  { compare("moveX()",         [](Segment &s) { s.moveX(3, true); },     [](Segment &s) { pixelMoveX(s, 3); }); }
+void test_move_y()  { compare("moveY()",         [](Segment &s) { s.moveY(-2, true); },    [](Segment &s) { pixelMoveY(s, -2); }); }
+void test_blur()    { compare("blur()",          [](Segment &s) { s.blur(96); },           [](Segment &s) { pixelBlur(s, 96); }); }
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv) {
+  setupMatrix();
+  UNITY_BEGIN();
+  RUN_TEST(test_span_write_matches_pixels);
+  RUN_TEST(test_fill);
+  RUN_TEST(test_fade);
+  RUN_TEST(test_move_x);
+  RUN_TEST(test_move_y);
+  RUN_TEST(test_blur);
+  return UNITY_END();
+}
@@ -0,0 +1,171 @@
+/*
+ * Ledmap loading (ledmapN.json and its binary copy ledmapN.bin)
+ * Random maps (arbitrary, serpentine with gaps, sparse) are written as JSON with distracting members,
+ * loaded (which writes the .bin) and loaded again from the .bin; both must equal the map. A damaged,
+ * outdated or orphaned .bin must never be used instead of the JSON file.
+ */
+#include <unity.h>
+#include <random>
+#include <vector>
+#include "fs_mock.h"
+#include "../../wled00/ledmap.cpp"
+
+static std::mt19937 rng(1);
+
+static std::vector<uint16_t> makeMap(size_t n, int kind) {
+  std::vector<uint16_t> m(n);
+  uint16_t w = 1 + rng() % 64;
+  for (size_t i = 0; i < n; i++) {
+    switch (kind) {
+      case 0: m[i] = rng() % 65536; break;                                             // arbitrary
+      case 1: { size_t r = i / w, c = i % w; m[i] = r & 1 ? r*w + (w-1-c) : i;         // serpentine
+                if (rng() % 20 == 0) m[i] = 0xFFFF; break; }
+      default: m[i] = rng() % 4 ? i : 0xFFFF; break;                                   // sparse
+    }
+  }
+  return m;
+}
+
+// ledmap JSON as written by hand or by mapping tools (unused pixels as -1 or null)
+static std::string toJson(const std::vector<uint16_t> &m, const char *name) {
+  std::string js = "{\"x\":{\"map\":[1,2],\"n\":\"no\"}, \"s\":\"a\\\"]}[\" ,\"map\" : [\n";
+  for (size_t i = 0; i < m.size(); i++) {
+    if (i) js += rng() % 2 ? "," : " ,\n ";
+    if (m[i] == 0xFFFF) js += rng() % 2 ? "-1" : "null";
+    else                js += std::to_string(m[i]);
+  }
+  js += "], \"n\":\"";
+  js += name;
+  js += "\", \"w\":[[1],[2]]}";
+  return js;
+}
+
+static int8_t load(uint8_t n, std::vector<uint16_t> &out) {
+  uint16_t *table, size;
+  int8_t r = readLedmap(n, table, size);
+  out.assign(table, table + (table ? size : 0));
+  TEST_ASSERT_EQUAL(size, out.size());
+  delete[] table;
+  return r;
+}
+
+static void assertLoads(uint8_t n, const std::vector<uint16_t> &expected) {
+  std::vector<uint16_t> got;
+  TEST_ASSERT_EQUAL(1, load(n, got));
+  TEST_ASSERT_EQUAL(expected.size(), got.size());
+  if (!expected.empty()) TEST_ASSERT_TRUE(got == expected);
+}
+
+void setUp() { mockFsInit(); }
+void tearDown() {}
+
+void test_round_trip() {
+  for (unsigned trial = 0; trial < 300; trial++) {
+    std::vector<uint16_t> m = makeMap(rng() % 3000, trial % 3);
+    std::string js = toJson(m, "Name \\\" x");
+    mockFsWrite("/ledmap3.json", js);
+    WLED_FS.remove("/ledmap3.bin");
+    assertLoads(3, m);
+    TEST_ASSERT_TRUE(WLED_FS.exists("/ledmap3.bin"));
+    mockFsBytesRead = 0;
+    assertLoads(3, m);
+    TEST_ASSERT_LESS_THAN(js.size() + 64, mockFsBytesRead); // only the size/time check touches the JSON
+    char name[33];
+    TEST_ASSERT_TRUE(getLedmapName(3, name, sizeof(name)));
+    TEST_ASSERT_EQUAL_STRING("Name \" x", name);
+  }
+}
+
+// maps are 16 bit: entries past 65535 are dropped, the same way for JSON and .bin
+void test_large_map() {
+  std::vector<uint16_t> m = makeMap(70000, 1);
+  mockFsWrite("/ledmap1.json", toJson(m, "big"));
+  m.resize(65535);
+  assertLoads(1, m);
+  assertLoads(1, m);
+}
+
+// a damaged .bin is replaced from the JSON file
+void test_truncated_bin() {
+  std::vector<uint16_t> m = makeMap(2000, 0);
+  mockFsWrite("/ledmap2.json", toJson(m, "t"));
+  assertLoads(2, m);
+  std::string bin = mockFsRead("/ledmap2.bin");
+  for (size_t cut : {bin.size() - 1, bin.size() / 2, (size_t)LEDMAP_BIN_HDR, (size_t)3}) {
+    mockFsWrite("/ledmap2.bin", bin.substr(0, cut));
+    assertLoads(2, m);
+    TEST_ASSERT_EQUAL(bin.size(), mockFsRead("/ledmap2.bin").size()); // rewritten
+  }
+  mockFsWrite("/ledmap2.bin", bin + "x"); // trailing data
+  assertLoads(2, m);
+}
+
+// an edited JSON file (other size) is used instead of its old .bin
+void test_changed_json() {
+  std::vector<uint16_t> a = makeMap(500, 1), b = makeMap(900, 1);
+  mockFsWrite("/ledmap4.json", toJson(a, "a"));
+  assertLoads(4, a);
+  mockFsWrite("/ledmap4.json", toJson(b, "b"));
+  assertLoads(4, b);
+  char name[33];
+  getLedmapName(4, name, sizeof(name));
+  TEST_ASSERT_EQUAL_STRING("b", name);
+}
+
+// the .bin of a removed JSON file is not a ledmap, a .bin without source (copied from another device) is
+void test_orphaned_and_standalone_bin() {
+  std::vector<uint16_t> m = makeMap(300, 2), got;
+  mockFsWrite("/ledmap5.json", toJson(m, "solo"));
+  assertLoads(5, m);
+  std::string bin = mockFsRead("/ledmap5.bin");
+  WLED_FS.remove("/ledmap5.json");
+  TEST_ASSERT_EQUAL(-1, load(5, got));
+  TEST_ASSERT_FALSE(ledmapExists(5));
+
+  for (size_t i = 6; i < 14; i++) bin[i] = 0; // source size and time
+  mockFsWrite("/ledmap5.bin", bin);
+  TEST_ASSERT_TRUE(ledmapExists(5));
+  assertLoads(5, m);
+  char name[33];
+  TEST_ASSERT_TRUE(getLedmapName(5, name, sizeof(name)));
+  TEST_ASSERT_EQUAL_STRING("solo", name);
+}
+
+void test_invalid_json() {
+  std::vector<uint16_t> got;
+  mockFsWrite("/ledmap6.json", "{\"map\":[]}");
+  TEST_ASSERT_EQUAL(1, load(6, got));
+  TEST_ASSERT_EQUAL(0, got.size());
+  mockFsWrite("/ledmap7.json", "{\"map\":[1,2");
+  TEST_ASSERT_EQUAL(0, load(7, got));
+  mockFsWrite("/ledmap8.json", "[1,2]");
+  TEST_ASSERT_EQUAL(0, load(8, got));
+  TEST_ASSERT_EQUAL(-1, load(9, got));
+}
+
+// size of the .bin for a 64x128 serpentine matrix
+void test_bin_size() {
+  std::vector<uint16_t> m(8192);
+  for (size_t i = 0; i < m.size(); i++) { size_t r = i / 64, c = i % 64; m[i] = r & 1 ? r*64 + 63-c : i; }
+  std::string js = toJson(m, "serpentine");
+  mockFsWrite("/ledmap10.json", js);
+  assertLoads(10, m);
+  size_t bin = mockFsRead("/ledmap10.bin").size();
+  char msg[100];
+  snprintf(msg, sizeof(msg), "64x128 serpentine: JSON %u bytes, bin %u bytes", (unsigned)js.size(), (unsigned)bin);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(1024, bin);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_large_map);
+  RUN_TEST(test_truncated_bin);
+  RUN_TEST(test_changed_json);
+  RUN_TEST(test_orphaned_and_standalone_bin);
+  RUN_TEST(test_invalid_json);
+  RUN_TEST(test_bin_size);
+  mockFsCleanup();
+  return UNITY_END();
+}
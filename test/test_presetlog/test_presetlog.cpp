@@ -0,0 +1,162 @@
+/*
+ * Preset store (presets.json index and presets.log)
+ * Indexed reads must work for compact and pretty printed presets.json without rescanning the file,
+ * a file replaced behind the index must still be detected. The apply benchmark reports the time to
+ * read a preset against the size of presets.json (bytes read per apply must not depend on it).
+ */
+#include <unity.h>
+#include <chrono>
+#include "fs_mock.h"
+#include "../../wled00/presetlog.cpp"
+
+// presets.json with count presets, the way the UI (compact) or an editor (pretty) writes it
+static std::string makePresetsFile(unsigned count, bool pretty) {
+  DynamicJsonDocument d(count * 2048 + 1024);
+  d.createNestedObject("0");
+  for (unsigned id = 1; id <= count; id++) {
+    JsonObject p = d.createNestedObject(std::to_string(id));
+    p["n"] = "Preset " + std::to_string(id) + (id % 7 ? "" : " {\"}");
+    p["on"] = true;
+    p["bri"] = id & 0xFF;
+    JsonArray seg = p.createNestedArray("seg");
+    for (unsigned s = 0; s <= id % 4; s++) {
+      JsonObject o = seg.createNestedObject();
+      o["id"] = s;
+      o["fx"] = (id + s) % 100;
+      JsonArray col = o.createNestedArray("col");
+      for (unsigned c = 0; c < 3; c++) { JsonArray rgb = col.createNestedArray(); rgb.add(id); rgb.add(c); rgb.add(s); }
+    }
+  }
+  TEST_ASSERT_FALSE(d.overflowed());
+  std::string out;
+  if (pretty) serializeJsonPretty(d, out);
+  else        serializeJson(d, out);
+  return out;
+}
+
+// preset id as stored in presets.json, "" if it does not exist
+static std::string expected(const std::string &file, unsigned id) {
+  DynamicJsonDocument d(file.size() * 10 + 1024);
+  deserializeJson(d, file);
+  std::string s;
+  if (!d[std::to_string(id)].isNull()) serializeJson(d[std::to_string(id)], s);
+  return s;
+}
+
+static std::string readPreset(uint8_t id, int8_t *result = nullptr) {
+  DynamicJsonDocument d(4096);
+  int8_t r = readPresetFromStore(id, &d);
+  if (result) *result = r;
+  std::string s;
+  if (r == 1) serializeJson(d, s);
+  return s;
+}
+
+static void installPresets(const std::string &file) {
+  mockFsInit();
+  mockFsWrite(PRESETS_FILE, file);
+  buildPresetIndex();
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_compact_file() {
+  std::string file = makePresetsFile(40, false);
+  installPresets(file);
+  for (unsigned id = 1; id <= 41; id++) TEST_ASSERT_EQUAL_STRING(expected(file, id).c_str(), readPreset(id).c_str());
+}
+
+// indexed reads of a pretty printed file only read the preset, never the whole file
+void test_pretty_file_is_not_rescanned() {
+  std::string file = makePresetsFile(120, true);
+  installPresets(file);
+  for (unsigned id = 1; id <= 120; id++) {
+    mockFsBytesRead = 0;
+    int8_t r;
+    TEST_ASSERT_EQUAL_STRING(expected(file, id).c_str(), readPreset(id, &r).c_str());
+    TEST_ASSERT_EQUAL(1, r);
+    TEST_ASSERT_LESS_THAN(4096, mockFsBytesRead);
+  }
+  TEST_ASSERT_GREATER_THAN(40000, file.size());
+}
+
+// any JSON whitespace between key, colon and object
+void test_whitespace_variants() {
+  const std::string file = "{\"0\":{},\"1\" :{\"n\":\"a\"},\n\t\"2\":\t{\"n\":\"b\"} , \"3\"\r\n:\r\n{\"n\":\"c\"},\"004\": {\"n\":\"d\"}}";
+  installPresets(file);
+  int8_t r;
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"a\"}", readPreset(1, &r).c_str());
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"b\"}", readPreset(2, &r).c_str());
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"c\"}", readPreset(3, &r).c_str());
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"d\"}", readPreset(4, &r).c_str());
+  TEST_ASSERT_EQUAL(1, r);
+}
+
+// presets.json replaced by a file of the same size with other ids: the stale index is not used
+void test_replaced_file_is_detected() {
+  installPresets("{\"0\":{},\"1\":{\"n\":\"a\"},\"2\":{\"n\":\"b\"}}");
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"b\"}", readPreset(2).c_str());
+  mockFsWrite(PRESETS_FILE, "{\"0\":{},\"2\":{\"n\":\"a\"},\"1\":{\"n\":\"b\"}}");
+  int8_t r;
+  readPreset(2, &r);
+  TEST_ASSERT_EQUAL(-1, r); // caller searches presets.json
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"a\"}", readPreset(2, &r).c_str());
+  TEST_ASSERT_EQUAL(1, r);
+}
+
+// presets saved after the file was indexed come from presets.log until compaction
+void test_log_and_compaction() {
+  std::string file = makePresetsFile(10, true);
+  installPresets(file);
+  DynamicJsonDocument d(256);
+  d["n"] = "saved";
+  TEST_ASSERT_TRUE(writePresetToStore(3, &d));
+  d.clear();
+  TEST_ASSERT_TRUE(writePresetToStore(4, &d)); // deleted
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"saved\"}", readPreset(3).c_str());
+  TEST_ASSERT_EQUAL_STRING("", readPreset(4).c_str());
+  mockMicros += (PRESET_LOG_IDLE + 1000) * 1000ULL;
+  for (unsigned i = 0; i < 20; i++) handlePresetLog();
+  TEST_ASSERT_FALSE(WLED_FS.exists(PRESETS_LOG));
+  TEST_ASSERT_EQUAL_STRING("{\"n\":\"saved\"}", readPreset(3).c_str());
+  TEST_ASSERT_EQUAL_STRING("", readPreset(4).c_str());
+  TEST_ASSERT_EQUAL_STRING(expected(file, 9).c_str(), readPreset(9).c_str());
+}
+
+// time to read a preset for applying it against the size of presets.json (last preset, worst case for a search)
+void test_apply_latency() {
+  const unsigned counts[] = {10, 50, 100, 250};
+  const unsigned reads = 200;
+  for (int pretty = 0; pretty < 2; pretty++) {
+    for (unsigned count : counts) {
+      std::string file = makePresetsFile(count, pretty);
+      installPresets(file);
+      auto t0 = std::chrono::steady_clock::now();
+      buildPresetIndex();
+      double scanUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+      mockFsBytesRead = 0;
+      t0 = std::chrono::steady_clock::now();
+      for (unsigned i = 0; i < reads; i++) readPreset(count);
+      double readUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / reads;
+      size_t bytes = mockFsBytesRead / reads;
+      TEST_ASSERT_LESS_THAN(4096, bytes); // the preset (and its key), not the file
+      char msg[160];
+      snprintf(msg, sizeof(msg), "%s presets.json, %3u presets, %6u bytes: apply read %6.1f us (%4u bytes), index build %7.1f us",
+               pretty ? "pretty " : "compact", count, (unsigned)file.size(), readUs, (unsigned)bytes, scanUs);
+      TEST_MESSAGE(msg);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_compact_file);
+  RUN_TEST(test_pretty_file_is_not_rescanned);
+  RUN_TEST(test_whitespace_variants);
+  RUN_TEST(test_replaced_file_is_detected);
+  RUN_TEST(test_log_and_compaction);
+  RUN_TEST(test_apply_latency);
+  mockFsCleanup();
+  return UNITY_END();
+}
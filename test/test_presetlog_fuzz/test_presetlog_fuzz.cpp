@@ -0,0 +1,180 @@
+/*
+ * Preset store power cut fuzzing
+ * Every trial runs a random session of preset saves, deletes and compactions in a child process and cuts
+ * the power (the file system stops accepting writes) at a random point. A second child then boots from
+ * what is on "flash" and checks that every preset is either as before or as after the interrupted
+ * operation, that /presets.json (merged view) is valid and matches, and that the store keeps working.
+ * Needs fork(), so POSIX hosts only.
+ */
+#include <unity.h>
+#include <map>
+#include <random>
+#include <vector>
+#include <sys/wait.h>
+#include "fs_mock.h"
+#include "../../wled00/presetlog.cpp"
+
+#define TRIALS     250
+#define PRESET_IDS 25
+
+struct Op {
+  uint8_t     id;
+  std::string value;   // "" = delete
+  bool        compact; // let handlePresetLog() run after the write
+  long        budget;  // write budget set before the operation, -1 = none (power stays on)
+};
+typedef std::map<uint8_t, std::string> Model; // expected presets
+
+static std::string makePreset(std::mt19937 &r, unsigned id) {
+  DynamicJsonDocument d(4096);
+  d["n"] = "P" + std::to_string(id) + (r() % 3 ? "" : " {\"}");
+  d["on"] = bool(r() % 2);
+  d["bri"] = r() % 256;
+  JsonArray seg = d.createNestedArray("seg");
+  for (unsigned k = r() % 6; k > 0; k--) {
+    JsonObject o = seg.createNestedObject();
+    o["fx"] = r() % 100;
+    o["pal"] = r() % 50;
+  }
+  std::string out;
+  serializeJson(d, out);
+  return out;
+}
+
+static std::vector<Op> makeSession(unsigned trial) {
+  std::mt19937 r(trial * 7919 + 1);
+  std::vector<Op> ops(20 + r() % 60);
+  unsigned cutAt = r() % ops.size();
+  for (unsigned i = 0; i < ops.size(); i++) {
+    Op &op = ops[i];
+    op.id = 1 + r() % PRESET_IDS;
+    op.value = r() % 5 ? makePreset(r, op.id) : "";
+    op.compact = r() % 4 == 0;
+    op.budget = i == cutAt ? r() % (op.value.size() + 40) + (r() % 3 ? 0 : r() % 3000) : -1;
+  }
+  return ops;
+}
+
+static Model modelAfter(const std::vector<Op> &ops, int count) {
+  Model m;
+  for (int i = 0; i < count && i < (int)ops.size(); i++) {
+    if (ops[i].value.empty()) m.erase(ops[i].id);
+    else                      m[ops[i].id] = ops[i].value;
+  }
+  return m;
+}
+
+static std::string readPreset(uint8_t id) {
+  DynamicJsonDocument d(8192);
+  int8_t r = readPresetFromStore(id, &d);
+  if (r < 0) return "ERR";
+  std::string s;
+  if (r) serializeJson(d, s);
+  return s;
+}
+
+// /presets.json as served to the UI, in small chunks
+static std::string exportView() {
+  AsyncWebServerRequest req;
+  if (!servePresetsJson(&req, "application/json")) return mockFsRead(PRESETS_FILE);
+  std::string s = req.body(37);
+  return s.size() == req.response->contentLength ? s : "length mismatch";
+}
+
+// child: session until the power is cut; exit code 1 + 2*operation + (cut during compaction), 0 = no cut
+static int runSession(const std::vector<Op> &ops) {
+  buildPresetIndex();
+  for (unsigned i = 0; i < ops.size(); i++) {
+    const Op &op = ops[i];
+    int phase = 0;
+    if (op.budget >= 0) mockFsWriteBudget = op.budget;
+    try {
+      DynamicJsonDocument d(8192);
+      if (!op.value.empty()) deserializeJson(d, op.value);
+      if (!writePresetToStore(op.id, &d)) { fprintf(stderr, "write of preset %u failed\n", op.id); return 255; }
+      if (op.compact) {
+        phase = 1;
+        mockMicros += (PRESET_LOG_IDLE + 1000) * 1000ULL;
+        for (unsigned k = 0; k < 40; k++) handlePresetLog();
+      }
+    } catch (MockPowerCut&) {
+      return 1 + 2*i + phase;
+    }
+  }
+  return 0;
+}
+
+// child: boot and check, returns the number of problems
+static int verifyAfterBoot(unsigned trial, const Model &before, const Model &after) {
+  int bad = 0;
+  buildPresetIndex();
+  for (unsigned id = 1; id <= PRESET_IDS; id++) {
+    std::string got = readPreset(id);
+    std::string a = before.count(id) ? before.at(id) : "", b = after.count(id) ? after.at(id) : "";
+    if (got != a && got != b) { bad++; fprintf(stderr, "trial %u: preset %u is '%s', expected '%s' or '%s'\n", trial, id, got.c_str(), a.c_str(), b.c_str()); }
+  }
+  std::string view = exportView();
+  DynamicJsonDocument e(65536);
+  if (deserializeJson(e, view)) { bad++; fprintf(stderr, "trial %u: invalid /presets.json: %s\n", trial, view.c_str()); }
+  else for (unsigned id = 1; id <= PRESET_IDS; id++) {
+    std::string s;
+    if (!e[std::to_string(id)].isNull()) serializeJson(e[std::to_string(id)], s);
+    if (s != readPreset(id)) { bad++; fprintf(stderr, "trial %u: /presets.json differs for preset %u\n", trial, id); }
+  }
+  DynamicJsonDocument d(256);
+  d["n"] = "after";
+  if (!writePresetToStore(7, &d)) bad++;
+  mockMicros += (PRESET_LOG_IDLE + 1000) * 1000ULL;
+  for (unsigned k = 0; k < 40; k++) handlePresetLog();
+  if (readPreset(7) != "{\"n\":\"after\"}") { bad++; fprintf(stderr, "trial %u: write after recovery lost\n", trial); }
+  DynamicJsonDocument x(65536);
+  if (deserializeJson(x, mockFsRead(PRESETS_FILE))) { bad++; fprintf(stderr, "trial %u: compacted presets.json invalid\n", trial); }
+  return bad;
+}
+
+static int runChild(std::function<int()> f) {
+  fflush(stdout);
+  pid_t pid = fork();
+  if (!pid) _exit(f());
+  int status;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 256;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_power_cuts() {
+  unsigned failed = 0, cutsInWrite = 0, cutsInCompaction = 0;
+  for (unsigned trial = 0; trial < TRIALS; trial++) {
+    mockFsInit();
+    mockFsWrite(PRESETS_FILE, "{\"0\":{}}");
+    std::vector<Op> ops = makeSession(trial);
+    int res = runChild([&]() { return runSession(ops); });
+    TEST_ASSERT_TRUE_MESSAGE(res < 255, "session failed without power cut");
+    Model before, after;
+    if (!res) before = after = modelAfter(ops, ops.size());
+    else {
+      int op = (res - 1) / 2;
+      bool inCompaction = (res - 1) & 1;
+      after = modelAfter(ops, op + 1);
+      before = inCompaction ? after : modelAfter(ops, op);
+      inCompaction ? cutsInCompaction++ : cutsInWrite++;
+    }
+    if (runChild([&]() { return verifyAfterBoot(trial, before, after); })) failed++;
+  }
+  mockFsCleanup();
+  char msg[120];
+  snprintf(msg, sizeof(msg), "%u trials: power cut while writing %u, while compacting %u, failed %u",
+           TRIALS, cutsInWrite, cutsInCompaction, failed);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(0, failed);
+  TEST_ASSERT_GREATER_THAN(TRIALS / 2, cutsInWrite);
+  TEST_ASSERT_GREATER_THAN(0, cutsInCompaction);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_power_cuts);
+  return UNITY_END();
+}
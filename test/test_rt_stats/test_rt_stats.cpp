@@ -0,0 +1,147 @@
+/*
+ * Realtime input telemetry
+ * Ingest to show() latency must never be reported lower than it was, and the telemetry hooks must
+ * cost less than 1% of the frame they instrument (ingest and show() of a 4-universe E1.31 frame).
+ */
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include "net_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+#include "../../wled00/udp.cpp"
+#include "../../wled00/e131.cpp"
+#include "../../wled00/telemetry.cpp"
+
+#define LEDS      680  // 4 universes of 170 RGB LEDs
+#define UNIVERSES 4
+
+static const IPAddress sender(192, 168, 1, 60);
+static std::vector<e131_packet_t> packets;
+
+static void setupStrip() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  BusConfig bc(TYPE_WS2812_RGB, pins, 0, LEDS, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY);
+  busses.add(bc);
+  strip.isMatrix = false;
+  strip.finalizeInit();
+  strip.resetSegments();
+  DMXMode = DMX_MODE_MULTIPLE_RGB;
+  realtimeTimeoutMs = 65000;
+
+  std::vector<uint8_t> image(LEDS * 3);
+  for (unsigned i = 0; i < image.size(); i++) image[i] = i * 7;
+  mockUdpSent.clear();
+  realtimeBroadcast(1, sender, LEDS, image.data(), 255, false, nullptr);
+  TEST_ASSERT_EQUAL(UNIVERSES, mockUdpSent.size());
+  packets.resize(UNIVERSES);
+  for (unsigned u = 0; u < UNIVERSES; u++) memcpy(packets[u].raw, mockUdpSent[u].data.data(), mockUdpSent[u].data.size());
+  handleE131Packet(&packets[0], sender, P_E131); // realtime mode, loop() allocates the frame buffers
+  handleE131Frame();
+}
+
+// [pps, fps, packets, frames, oos, late, latency avg, latency max, [jitter]]
+static JsonArray e131Stats() {
+  doc.clear();
+  serializeRtStats(doc.to<JsonObject>());
+  return doc["rt"]["e131"];
+}
+
+static void advanceMs(unsigned ms) { mockMicros += ms * 1000ULL; }
+
+void setUp() {
+  realtimeStats = true;
+  resetRtStats();
+  mockMicros = 1000000;
+}
+void tearDown() {}
+
+// a show() in the same millisecond as the packet may have happened before it and does not count
+void test_latency_same_millisecond() {
+  strip.show();
+  rtStatsPacket(REALTIME_MODE_E131);
+  handleRtStats();
+  TEST_ASSERT_EQUAL(0, e131Stats()[6].as<int>());
+  advanceMs(7);
+  strip.show();
+  handleRtStats();
+  JsonArray s = e131Stats();
+  TEST_ASSERT_EQUAL(7, s[6].as<int>());
+  TEST_ASSERT_EQUAL(7, s[7].as<int>());
+}
+
+// a packet arriving after the last show() waits for the next one
+void test_latency_packet_after_show() {
+  strip.show();
+  advanceMs(1);
+  rtStatsPacket(REALTIME_MODE_E131);
+  handleRtStats();
+  advanceMs(3);
+  handleRtStats();
+  TEST_ASSERT_EQUAL(0, e131Stats()[7].as<int>());
+  advanceMs(2);
+  strip.show();
+  handleRtStats();
+  TEST_ASSERT_EQUAL(5, e131Stats()[7].as<int>());
+}
+
+// counters follow the packets of a multi-universe frame
+void test_frame_counters() {
+  for (unsigned f = 0; f < 3; f++) {
+    for (auto &p : packets) handleE131Packet(&p, sender, P_E131);
+    advanceMs(25);
+    handleE131Frame();
+  }
+  JsonArray s = e131Stats();
+  TEST_ASSERT_EQUAL(3 * UNIVERSES, s[2].as<int>());
+  TEST_ASSERT_EQUAL(3, s[3].as<int>());
+}
+
+template<typename F> static double nsPerFrame(unsigned frames, F op) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned f = 0; f < frames; f++) op();
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / frames;
+}
+
+// telemetry cost of one frame (a packet hook per universe, the frame hook and the loop() pass that sees
+// the frame shown) against the work of the frame it measures: ingest of all universes and show() by loop()
+void test_cpu_overhead() {
+  const unsigned frames = 20000;
+  auto frame = [&]() { for (auto &p : packets) handleE131Packet(&p, sender, P_E131); mockMicros += 25000; handleE131Frame(); };
+  auto hooks = [&]() {
+    for (unsigned u = 0; u < UNIVERSES; u++) rtStatsPacket(REALTIME_MODE_E131);
+    rtStatsFrame(REALTIME_MODE_E131);
+    mockMicros += 25000;
+    handleRtStats();
+  };
+  auto idle  = [&]() { handleRtStats(); };
+  double best = 1e9;
+  for (int run = 0; run < 5; run++) { // best of 5 against scheduling noise
+    realtimeStats = false;
+    double base = nsPerFrame(frames, frame);
+    realtimeStats = true;
+    double cost = nsPerFrame(frames, hooks);
+    double loop = nsPerFrame(frames, idle);
+    best = std::min(best, 100.0 * cost / base);
+    if (run == 0) {
+      char msg[160];
+      snprintf(msg, sizeof(msg), "4 universe frame: ingest + show() %.0f ns, telemetry %.1f ns (%.2f%%), idle loop() pass %.1f ns",
+               base, cost, 100.0 * cost / base, loop);
+      TEST_MESSAGE(msg);
+    }
+  }
+  TEST_ASSERT_LESS_THAN(1.0, best);
+}
+
+int main(int argc, char **argv) {
+  setupStrip();
+  UNITY_BEGIN();
+  RUN_TEST(test_latency_same_millisecond);
+  RUN_TEST(test_latency_packet_after_show);
+  RUN_TEST(test_frame_counters);
+  RUN_TEST(test_cpu_overhead);
+  return UNITY_END();
+}
@@ -0,0 +1,180 @@
+/*
+ * WebSocket live view, protocol version 3 (XOR/RLE deltas against the last acknowledged frame)
+ * Every frame sent is decoded like liveview.htm does and must equal the strip. The live view buffers
+ * must only be freed or swapped by handleWs() (loop), never from wsEvent() (async_tcp task).
+ */
+#include <unity.h>
+#include <vector>
+#include "ws_mock.h"
+#include "../../wled00/bus_manager.cpp"
+#include "../../wled00/colors.cpp"
+#include "../../wled00/FX_fcn.cpp"
+#include "../../wled00/FX_2Dfcn.cpp"
+#include "../../wled00/udp.cpp"
+#include "../../wled00/e131.cpp"
+#include "../../wled00/telemetry.cpp"
+#include "../../wled00/ws.cpp"
+
+#define LEDS 600
+
+static AsyncWebSocketClient viewer(7);
+static std::vector<uint8_t> view; // frame as decoded by the client
+static uint32_t rnd = 1;
+static uint32_t next() { rnd = rnd * 1664525 + 1013904223; return rnd; }
+
+static void setupStrip() {
+  busses.removeAll();
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  BusConfig bc(TYPE_SK6812_RGBW, pins, 0, LEDS, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY);
+  busses.add(bc);
+  strip.isMatrix = false;
+  strip.finalizeInit();
+  strip.resetSegments();
+  ws.clients.push_back(&viewer);
+}
+
+static void clientText(const char *msg) {
+  std::vector<uint8_t> data(msg, msg + strlen(msg)); // parsed in place
+  AwsFrameInfo info = {};
+  info.final = 1; info.opcode = WS_TEXT; info.len = data.size();
+  wsEvent(&ws, &viewer, WS_EVT_DATA, &info, data.data(), data.size());
+}
+
+static void clientAck(uint8_t seq) {
+  uint8_t msg[2] = {'A', seq};
+  AwsFrameInfo info = {};
+  info.final = 1; info.opcode = WS_BINARY; info.len = 2;
+  wsEvent(&ws, &viewer, WS_EVT_DATA, &info, msg, 2);
+}
+
+// lvDecode() of liveview.htm; returns false if the frame cannot be decoded (delta without keyframe)
+static bool decode(const std::vector<uint8_t> &d) {
+  TEST_ASSERT_TRUE(d.size() >= 8);
+  TEST_ASSERT_EQUAL('L', d[0]);
+  TEST_ASSERT_EQUAL(3, d[1]);
+  const size_t n = (d[4] | d[5] << 8) * (d[6] | d[7] << 8);
+  if (d[2] & 1) view.assign(n*3, 0);
+  else if (view.size() != n*3) return false;
+  size_t i = 8, p = 0;
+  while (i < d.size() && p < n*3) {
+    uint8_t c = d[i++];
+    if (c < 128) p += (c+1)*3;
+    else for (unsigned k = ((c&127)+1)*3; k > 0; k--) { TEST_ASSERT_TRUE(i < d.size() && p < n*3); view[p++] ^= d[i++]; }
+  }
+  TEST_ASSERT_EQUAL(d.size(), i); // no trailing bytes
+  return true;
+}
+
+static void assertView() {
+  TEST_ASSERT_EQUAL(LEDS * 3, view.size());
+  const uint8_t b = strip.getBrightness();
+  for (unsigned i = 0; i < LEDS; i++) {
+    uint32_t c = strip.getPixelColor(i);
+    const uint8_t exp[3] = { scale8(qadd8(W(c), R(c)), b), scale8(qadd8(W(c), G(c)), b), scale8(qadd8(W(c), B(c)), b) };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(exp, &view[i*3], 3);
+  }
+}
+
+// one loop() pass some time later; returns the frame sent, if any
+static const std::vector<uint8_t> *loopOnce(unsigned ms = 50) {
+  mockMicros += ms * 1000ULL;
+  const size_t before = viewer.binaries.size();
+  handleWs();
+  return viewer.binaries.size() > before ? &viewer.binaries.back() : nullptr;
+}
+
+static void changePixels(unsigned count) {
+  for (unsigned k = 0; k < count; k++) strip.setPixelColor(next() % LEDS, next() & 0x3FFFFFFF);
+}
+
+void setUp() {
+  clientText("{\"lv\":3}");
+  handleWs();
+  viewer.binaries.clear();
+  view.clear();
+}
+void tearDown() {
+  clientText("{\"lv\":false}");
+  handleWs();
+}
+
+// keyframe, then deltas of a few changed pixels, each acknowledged before the next is sent
+void test_round_trip() {
+  changePixels(LEDS);
+  unsigned keyframes = 0, deltas = 0;
+  for (unsigned f = 0; f < 200; f++) {
+    const auto *m = loopOnce();
+    TEST_ASSERT_NOT_NULL(m);
+    TEST_ASSERT_TRUE(decode(*m));
+    assertView();
+    ((*m)[2] & 1) ? keyframes++ : deltas++;
+    if (!((*m)[2] & 1)) TEST_ASSERT_TRUE(m->size() < 8 + 60 * 5); // a few pixels changed: small delta
+    TEST_ASSERT_NULL(loopOnce());                    // nothing until acknowledged
+    clientAck((*m)[3]);
+    changePixels(f % 12);
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(3, keyframes);        // initial and every WS_LIVE_KEYFRAME deltas
+  TEST_ASSERT_GREATER_THAN(180, deltas);
+}
+
+// a lost acknowledgement leads to a keyframe once WS_LIVE_ACK_TIMEOUT has passed
+void test_lost_ack() {
+  changePixels(LEDS);
+  const auto *m = loopOnce();
+  TEST_ASSERT_TRUE(decode(*m));
+  clientAck((*m)[3]);
+  changePixels(5);
+  m = loopOnce();
+  TEST_ASSERT_FALSE((*m)[2] & 1);
+  view.clear(); // client missed it and did not acknowledge
+  changePixels(5);
+  TEST_ASSERT_NULL(loopOnce(WS_LIVE_ACK_TIMEOUT / 2));
+  m = loopOnce(WS_LIVE_ACK_TIMEOUT);
+  TEST_ASSERT_NOT_NULL(m);
+  TEST_ASSERT_TRUE((*m)[2] & 1);
+  TEST_ASSERT_TRUE(decode(*m));
+  assertView();
+}
+
+// wsEvent() only flags disconnects and acknowledgements, handleWs() frees and swaps the buffers
+void test_async_side_does_not_touch_buffers() {
+  changePixels(LEDS);
+  const auto *m = loopOnce();
+  const uint8_t seq = (*m)[3];
+  uint8_t *ref = wsLiveRef, *pending = wsLivePending;
+  TEST_ASSERT_NOT_NULL(ref);
+  clientAck(seq);
+  TEST_ASSERT_EQUAL_PTR(ref, wsLiveRef);
+  TEST_ASSERT_EQUAL_PTR(pending, wsLivePending);
+  TEST_ASSERT_TRUE(wsLiveAwaitAck);
+  handleWs();
+  TEST_ASSERT_FALSE(wsLiveAwaitAck);
+  TEST_ASSERT_EQUAL_PTR(pending, wsLiveRef);
+
+  wsEvent(&ws, &viewer, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+  TEST_ASSERT_EQUAL(0, wsLiveClientId);
+  TEST_ASSERT_NOT_NULL(wsLiveRef);
+  TEST_ASSERT_NOT_NULL(wsLivePending);
+  handleWs();
+  TEST_ASSERT_NULL(wsLiveRef);
+  TEST_ASSERT_NULL(wsLivePending);
+
+  // re-subscribing starts over with a keyframe, an acknowledgement of the old stream is ignored
+  clientText("{\"lv\":3}");
+  clientAck(seq);
+  view.clear();
+  m = loopOnce();
+  TEST_ASSERT_NOT_NULL(m);
+  TEST_ASSERT_TRUE((*m)[2] & 1);
+  TEST_ASSERT_TRUE(decode(*m));
+  assertView();
+}
+
+int main(int argc, char **argv) {
+  setupStrip();
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_lost_ack);
+  RUN_TEST(test_async_side_does_not_touch_buffers);
+  return UNITY_END();
+}
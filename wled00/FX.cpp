@@ -4951,7 +4951,11 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
 
   //copy previous leds (save previous generation)
   //NOTE: using lossy getPixelColor() is a benefit as endlessly repeating patterns will eventually fade out causing a reset
-  for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) prevLeds[XY(x,y)] = SEGMENT.getPixelColorXY(x,y);
+  uint32_t line[cols];
+  for (int y = 0; y < rows; y++) {
+    SEGMENT.getRow(y, line);
+    for (int x = 0; x < cols; x++) prevLeds[XY(x,y)] = line[x];
+  }
 
   //calculate new leds
   for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) {
@@ -5227,18 +5231,25 @@ uint16_t mode_2Dmatrix(void) {                  // Matrix2D. By Jeremy Williams.
     if ((oldSpawnColor == CRGB::Black) || (oldSpawnColor == trailColor)) oldSpawnColor = spawnColor; // reject "black", as it would mean that ALL pixels create trails
 
     // move pixels one row down. Falling codes keep color and add trail pixels; all others pixels are faded
+    // rows are processed bottom-up; the row below is held back until the current row may have spawned into it
+    uint32_t line[cols];
+    uint32_t below[cols];
     for (int row=rows-1; row>=0; row--) {
+      SEGMENT.getRow(row, line);
       for (int col=0; col<cols; col++) {
-        CRGB pix = SEGMENT.getPixelColorXY(col, row);
+        CRGB pix = line[col];
         if (pix == oldSpawnColor) {  // this comparison may still fail due to overlays changing pixels, or due to gaps (2d-gaps.json)
-          SEGMENT.setPixelColorXY(col, row, trailColor);  // create trail
-          if (row < rows-1) SEGMENT.setPixelColorXY(col, row+1, spawnColor);
+          line[col] = RGBW32(trailColor.r, trailColor.g, trailColor.b, 0);  // create trail
+          if (row < rows-1) below[col] = RGBW32(spawnColor.r, spawnColor.g, spawnColor.b, 0);
         } else {
           // fade other pixels
-          if (pix != CRGB::Black) SEGMENT.setPixelColorXY(col, row, pix.nscale8(fade)); // optimization: don't fade black pixels
+          if (pix != CRGB::Black) { pix.nscale8(fade); line[col] = RGBW32(pix.r, pix.g, pix.b, 0); } // optimization: don't fade black pixels
         }
       }
+      if (row < rows-1) SEGMENT.setRow(row+1, below);
+      memcpy(below, line, sizeof(line));
     }
+    SEGMENT.setRow(0, below);
 
     // check for empty screen to ensure code spawn
     bool emptyScreen = (SEGENV.aux1 >= rows); // empty screen means that the last falling code has moved out of screen area
@@ -79,6 +79,38 @@
   #endif
 #endif
 
+/* How much of MAX_SEGMENT_DATA precomputed 1D pixel index maps may use (rest is left for effect data) */
+#ifndef MAX_SEGMENT_MAP_DATA
+  #define MAX_SEGMENT_MAP_DATA (MAX_SEGMENT_DATA/2)
+#endif
+
+/* How much RAM expanded (256 entry) per-segment palettes may use (768 bytes each); segments without one use ColorFromPalette() */
+#ifndef MAX_PALETTE_LUT_DATA
+  #ifdef ESP8266
+    #define MAX_PALETTE_LUT_DATA 2560
+  #else
+    #define MAX_PALETTE_LUT_DATA 13312
+  #endif
+#endif
+
+/* Off-screen render buffers for effect blending (two per segment in transition, kept in a bounded pool) */
+#ifndef MAX_BLEND_BUFFERS
+  #ifdef ESP8266
+    #define MAX_BLEND_BUFFERS 4
+  #else
+    #define MAX_BLEND_BUFFERS 8
+  #endif
+#endif
+#ifndef MAX_BLEND_BUFFER_DATA
+  #ifdef ESP8266
+    #define MAX_BLEND_BUFFER_DATA 4096
+  #elif defined(ARDUINO_ARCH_ESP32S2)
+    #define MAX_BLEND_BUFFER_DATA 16384
+  #else
+    #define MAX_BLEND_BUFFER_DATA 32768
+  #endif
+#endif
+
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
@@ -413,6 +445,31 @@ typedef struct Segment {
     uint16_t        _dataLen;
     static uint16_t _usedSegmentData;
 
+    // precomputed physical pixel indices for 1D segments (grouping, spacing, reverse, mirror, offset & ledmap resolved)
+    uint16_t        *_pixelMap;       // _pixelMapStride entries per virtual pixel, 0xFFFF if unused; nullptr if not built or not fitting
+    uint16_t        _pixelMapLen;     // number of entries in _pixelMap
+    uint8_t         _pixelMapStride;  // grouping (x2 if mirrored)
+    uint8_t         _pixelMapOpts;    // reverse & mirror options the map was built for
+    bool            _pixelMapValid;   // false if map needs to be rebuilt (it is rebuilt from WS2812FX::service() only)
+    static uint16_t _usedPixelMapData;
+
+    // current palette expanded to 256 entries (rebuilt by setCurrentPalette() only if source palette or blend type changed)
+    typedef struct PaletteLUT {
+      CRGB    entry[256];
+      CRGB    source[16];                 // palette the table was expanded from
+      uint8_t blendType;                  // TBlendType used for expansion
+    } palettelut_t;
+    palettelut_t    *_paletteLUT;     // nullptr if not allocated or not fitting into MAX_PALETTE_LUT_DATA
+    static uint16_t _usedPaletteLUTData;
+
+    // pixel map may only be used if it is up to date and was built for current reverse & mirror options (mode blending swaps options)
+    inline bool hasPixelMap(void) const { return _pixelMap && _pixelMapValid && (options & (REVERSE | MIRROR)) == _pixelMapOpts; }
+
+  #ifndef WLED_DISABLE_2D
+    void setGroupXY(int x, int y, uint32_t col); // paints group of physical pixels at (already transformed) segment coordinates
+    void setSpanXY(int x, int y, unsigned n, const uint32_t *c, unsigned srcStep, bool vertical);
+  #endif
+
     // perhaps this should be per segment, not static
     static CRGBPalette16 _currentPalette;     // palette used for current effect (includes transition, used in color_from_palette())
     static CRGBPalette16 _randomPalette;      // actual random palette
@@ -420,6 +477,16 @@ typedef struct Segment {
     static unsigned long _lastPaletteChange;  // last random palette change time in millis()
     #ifndef WLED_DISABLE_MODE_BLEND
     static bool          _modeBlend;          // mode/effect blending semaphore
+    static bool          _renderToBuffer;     // effects render into transition's off-screen buffers (set by WS2812FX::service())
+    typedef struct BlendBuffer {
+      uint32_t *data;
+      uint16_t  len;                          // in pixels
+      bool      used;
+    } blendbuf_t;
+    static blendbuf_t    _blendPool[MAX_BLEND_BUFFERS];
+    static size_t        _usedBlendPoolData;  // bytes held by pool (used or idle)
+    static uint32_t     *acquireBlendBuffer(unsigned len);
+    static void          releaseBlendBuffer(uint32_t *buf);
     #endif
 
     // transition data, valid only if transitional==true, holds values during transition (72 bytes)
@@ -427,6 +494,8 @@ typedef struct Segment {
       #ifndef WLED_DISABLE_MODE_BLEND
       tmpsegd_t     _segT;        // previous segment environment
       uint8_t       _modeT;       // previous mode/effect
+      uint32_t     *_buf;         // off-screen buffer of new mode (virtual pixels), nullptr if not rendering off-screen
+      uint32_t     *_bufT;        // off-screen buffer of previous mode
       #else
       uint32_t      _colorT[NUM_COLORS];
       #endif
@@ -441,9 +510,18 @@ typedef struct Segment {
         , _prevPaletteBlends(0)
         , _start(millis())
         , _dur(dur)
-      {}
+      {
+      #ifndef WLED_DISABLE_MODE_BLEND
+        _buf = _bufT = nullptr;
+      #endif
+      }
     } *_t;
 
+    #ifndef WLED_DISABLE_MODE_BLEND
+    // off-screen buffer the running effect renders into (previous mode's buffer while blending), nullptr if rendering to strip
+    inline uint32_t *renderBuffer(void) const { return _renderToBuffer && _t ? (_modeBlend ? _t->_bufT : _t->_buf) : nullptr; }
+    #endif
+
   public:
 
     Segment(uint16_t sStart=0, uint16_t sStop=30) :
@@ -477,6 +555,12 @@ typedef struct Segment {
       data(nullptr),
       _capabilities(0),
       _dataLen(0),
+      _pixelMap(nullptr),
+      _pixelMapLen(0),
+      _pixelMapStride(0),
+      _pixelMapOpts(0),
+      _pixelMapValid(false),
+      _paletteLUT(nullptr),
       _t(nullptr)
     {
       #ifdef WLED_DEBUG
@@ -502,13 +586,15 @@ typedef struct Segment {
       if (name) { delete[] name; name = nullptr; }
       stopTransition();
       deallocateData();
+      deallocatePixelMap();
+      deallocatePaletteLUT();
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
     Segment& operator= (Segment &&orig) noexcept; // move assignment
 
 #ifdef WLED_DEBUG
-    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
+    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0) + (_pixelMap?pixelMapSize():0) + (_paletteLUT?sizeof(palettelut_t):0); }
 #endif
 
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
@@ -529,6 +615,9 @@ typedef struct Segment {
     static void     addUsedSegmentData(int len) { _usedSegmentData += len; }
     #ifndef WLED_DISABLE_MODE_BLEND
     static void     modeBlend(bool blend)       { _modeBlend = blend; }
+    static void     renderToBuffer(bool b)      { _renderToBuffer = b; }
+    static void     purgeBlendBuffers(void);
+    static size_t   getBlendBufferData(void)    { return _usedBlendPoolData; }
     #endif
     static void     handleRandomPalette();
     inline static const CRGBPalette16 &getCurrentPalette(void) { return Segment::_currentPalette; }
@@ -556,6 +645,12 @@ typedef struct Segment {
       */
     inline void markForReset(void) { reset = true; }  // setOption(SEG_OPTION_RESET, true)
 
+    // precomputed 1D pixel map functions
+    inline void   invalidatePixelMap(void) { _pixelMapValid = false; } // safe to call from network requests
+    inline size_t pixelMapSize(void) const { return _pixelMapLen * sizeof(uint16_t); }
+    void updatePixelMap(void);
+    void deallocatePixelMap(void);
+
     // transition functions
     void     startTransition(uint16_t dur); // transition has to start before actual segment values change
     void     stopTransition(void);
@@ -563,6 +658,8 @@ typedef struct Segment {
     #ifndef WLED_DISABLE_MODE_BLEND
     void     swapSegenv(tmpsegd_t &tmpSegD);
     void     restoreSegenv(tmpsegd_t &tmpSegD);
+    bool     allocateRenderBuffers(void);  // off-screen buffers for both blended effects, false if pool is exhausted
+    void     flushRenderBuffer(void);      // paints current render buffer to strip (blended if previous mode)
     #endif
     uint16_t progress(void); //transition progression between 0-65535
     uint8_t  currentBri(bool useCct = false);
@@ -570,6 +667,7 @@ typedef struct Segment {
     uint32_t currentColor(uint8_t slot);
     CRGBPalette16 &loadPalette(CRGBPalette16 &tgt, uint8_t pal);
     void     setCurrentPalette(void);
+    void     deallocatePaletteLUT(void);
 
     // 1D strip
     uint16_t virtualLength(void) const;
@@ -581,6 +679,9 @@ typedef struct Segment {
     void setPixelColor(float i, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0, bool aa = true) { setPixelColor(i, RGBW32(r,g,b,w), aa); }
     void setPixelColor(float i, CRGB c, bool aa = true)                                         { setPixelColor(i, RGBW32(c.r,c.g,c.b,0), aa); }
     uint32_t getPixelColor(int i);
+    // span access (n consecutive virtual pixels, checks and brightness are resolved once per span)
+    void setPixelSpan(int i, unsigned n, const uint32_t *c);
+    void getPixelSpan(int i, unsigned n, uint32_t *c);
     // 1D support functions (some implement 2D as well)
     void blur(uint8_t);
     void fill(uint32_t c);
@@ -609,6 +710,15 @@ typedef struct Segment {
     void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColorXY(x, y, RGBW32(r,g,b,w), aa); }
     void setPixelColorXY(float x, float y, CRGB c, bool aa = true)                             { setPixelColorXY(x, y, RGBW32(c.r,c.g,c.b,0), aa); }
     uint32_t getPixelColorXY(uint16_t x, uint16_t y);
+    // 2D span access (n consecutive virtual pixels to the right or down, geometry is resolved once per span)
+    void setPixelSpanXY(int x, int y, unsigned n, const uint32_t *c, bool vertical = false);
+    void getPixelSpanXY(int x, int y, unsigned n, uint32_t *c, bool vertical = false);
+    inline void setRow(uint16_t y, const uint32_t *c) { setPixelSpanXY(0, y, virtualWidth(), c); }
+    inline void getRow(uint16_t y, uint32_t *c)       { getPixelSpanXY(0, y, virtualWidth(), c); }
+    inline void setCol(uint16_t x, const uint32_t *c) { setPixelSpanXY(x, 0, virtualHeight(), c, true); }
+    inline void getCol(uint16_t x, uint32_t *c)       { getPixelSpanXY(x, 0, virtualHeight(), c, true); }
+    void fillRow(uint16_t y, uint32_t c);
+    void copyRow(uint16_t src, uint16_t dst);
     // 2D support functions
     void blendPixelColorXY(uint16_t x, uint16_t y, uint32_t color, uint8_t blend);
     void blendPixelColorXY(uint16_t x, uint16_t y, CRGB c, uint8_t blend)  { blendPixelColorXY(x, y, RGBW32(c.r,c.g,c.b,0), blend); }
@@ -643,6 +753,14 @@ typedef struct Segment {
     void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColor(x, RGBW32(r,g,b,w), aa); }
     void setPixelColorXY(float x, float y, CRGB c, bool aa = true)         { setPixelColor(x, RGBW32(c.r,c.g,c.b,0), aa); }
     uint32_t getPixelColorXY(uint16_t x, uint16_t y)                       { return getPixelColor(x); }
+    void setPixelSpanXY(int x, int y, unsigned n, const uint32_t *c, bool vertical = false) { if (!vertical) setPixelSpan(x, n, c); }
+    void getPixelSpanXY(int x, int y, unsigned n, uint32_t *c, bool vertical = false)       { if (!vertical) getPixelSpan(x, n, c); }
+    void setRow(uint16_t y, const uint32_t *c) { setPixelSpan(0, virtualLength(), c); }
+    void getRow(uint16_t y, uint32_t *c)       { getPixelSpan(0, virtualLength(), c); }
+    void setCol(uint16_t x, const uint32_t *c) {}
+    void getCol(uint16_t x, uint32_t *c)       {}
+    void fillRow(uint16_t y, uint32_t c)       { fill(c); }
+    void copyRow(uint16_t src, uint16_t dst)   {}
     void blendPixelColorXY(uint16_t x, uint16_t y, uint32_t c, uint8_t blend) { blendPixelColor(x, c, blend); }
     void blendPixelColorXY(uint16_t x, uint16_t y, CRGB c, uint8_t blend)  { blendPixelColor(x, RGBW32(c.r,c.g,c.b,0), blend); }
     void addPixelColorXY(int x, int y, uint32_t color, bool fast = false)  { addPixelColor(x, color, fast); }
@@ -712,6 +830,7 @@ class WS2812FX {  // 96 bytes
       _callback(nullptr),
       customMappingTable(nullptr),
       customMappingSize(0),
+      _pixels(nullptr),
       _lastShow(0),
       _segment_index(0),
       _mainSegment(0),
@@ -733,6 +852,7 @@ class WS2812FX {  // 96 bytes
 
     ~WS2812FX() {
       if (customMappingTable) delete[] customMappingTable;
+      if (_pixels) free(_pixels);
       _mode.clear();
       _modeData.clear();
       _segments.clear();
@@ -764,6 +884,7 @@ class WS2812FX {  // 96 bytes
       makeAutoSegments(bool forceReset = false),
       fixInvalidSegments(),
       setPixelColor(int n, uint32_t c),
+      setPixelColors(unsigned i, unsigned n, const uint32_t *c), // n consecutive (unmapped) pixels starting at i
       show(void),
       setTargetFps(uint8_t fps);
 
@@ -925,6 +1046,8 @@ class WS2812FX {  // 96 bytes
     uint16_t* customMappingTable;
     uint16_t  customMappingSize;
 
+    uint32_t* _pixels; // strip-wide frame buffer (unscaled colors, physical order), nullptr if global buffer is disabled
+
     unsigned long _lastShow;
 
     uint8_t _segment_index;
@@ -934,9 +1057,13 @@ class WS2812FX {  // 96 bytes
     uint8_t _qGrouping, _qSpacing;
     uint16_t _qOffset;
 
-    uint8_t
+    bool
       estimateCurrentAndLimitBri(void);
 
+    // access to physical pixel (customMappingTable already applied), used by Segment pixel maps
+    void     setPixelColorPhysical(unsigned i, uint32_t c);
+    uint32_t getPixelColorPhysical(unsigned i);
+
     void
       setUpSegmentFromQueuedChanges(void);
 };
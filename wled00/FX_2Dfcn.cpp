@@ -40,6 +40,7 @@ void WS2812FX::setUpMatrix() {
   if (customMappingTable != nullptr) delete[] customMappingTable;
   customMappingTable = nullptr;
   customMappingSize = 0;
+  for (segment &seg : _segments) seg.invalidatePixelMap(); // physical indices will change
 
   // isMatrix is set in cfg.cpp or set.cpp
   if (isMatrix) {
@@ -175,6 +176,11 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
   if (!isActive()) return; // not active
   if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return;  // if pixel would fall out of virtual segment just exit
 
+#ifndef WLED_DISABLE_MODE_BLEND
+  uint32_t *buf = renderBuffer();
+  if (buf) { buf[x + y * virtualWidth()] = col; return; } // effect renders off-screen (see WS2812FX::service())
+#endif
+
   uint8_t _bri_t = currentBri();
   if (_bri_t < 255) {
     byte r = scale8(R(col), _bri_t);
@@ -192,6 +198,13 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
   y *= groupLength(); // expand to physical pixels
   if (x >= width() || y >= height()) return;  // if pixel would fall out of segment just exit
 
+  setGroupXY(x, y, col);
+}
+
+// paints all physical pixels of a group (grouping & mirroring) starting at segment coordinates x,y
+// x & y are already reversed, transposed and expanded; col is already brightness scaled
+void IRAM_ATTR_YN Segment::setGroupXY(int x, int y, uint32_t col)
+{
   uint32_t tmpCol = col;
   for (int j = 0; j < grouping; j++) {   // groupping vertically
     for (int g = 0; g < grouping; g++) { // groupping horizontally
@@ -220,6 +233,105 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
   }
 }
 
+// writes n consecutive virtual pixels (starting at x,y going right or down if vertical)
+// bounds, brightness and transformation are resolved once for the whole span
+void Segment::setPixelSpanXY(int x, int y, unsigned n, const uint32_t *c, bool vertical)
+{
+  setSpanXY(x, y, n, c, 1, vertical);
+}
+
+// srcStep==0 paints the same color to all pixels of the span
+void IRAM_ATTR_YN Segment::setSpanXY(int x, int y, unsigned n, const uint32_t *c, unsigned srcStep, bool vertical)
+{
+  if (!isActive()) return; // not active
+  const int vW = virtualWidth();
+  const int vH = virtualHeight();
+  if (x >= vW || y >= vH || x<0 || y<0) return;  // if span would start out of virtual segment just exit
+  if (vertical) n = MIN(n, unsigned(vH - y));
+  else          n = MIN(n, unsigned(vW - x));
+
+#ifndef WLED_DISABLE_MODE_BLEND
+  uint32_t *buf = renderBuffer();
+  if (buf) { // effect renders off-screen
+    const int step = vertical ? vW : 1;
+    buf += x + y * vW;
+    for (unsigned k = 0; k < n; k++, c += srcStep, buf += step) *buf = *c;
+    return;
+  }
+#endif
+
+  const uint8_t  _bri_t = currentBri();
+  const int      groupLen = groupLength();
+  const int      w = width();
+  const int      h = height();
+  // transform start of span and per pixel step in physical coordinates
+  int dx = vertical ? 0 : 1;
+  int dy = vertical ? 1 : 0;
+  if (reverse  ) { x = vW - x - 1; dx = -dx; }
+  if (reverse_y) { y = vH - y - 1; dy = -dy; }
+  if (transpose) { std::swap(x, y); std::swap(dx, dy); } // swap X & Y if segment transposed
+  x *= groupLen; dx *= groupLen; // expand to physical pixels
+  y *= groupLen; dy *= groupLen; // expand to physical pixels
+
+  uint32_t col = 0;
+  for (unsigned k = 0; k < n; k++, c += srcStep, x += dx, y += dy) {
+    if (x >= w || y >= h) continue; // pixel would fall out of segment (remaining pixels may not, if reversed)
+    if (k == 0 || srcStep) col = _bri_t < 255 ? color_fade(*c, _bri_t) : *c;
+    setGroupXY(x, y, col);
+  }
+}
+
+// reads n consecutive virtual pixels (starting at x,y going right or down if vertical)
+void Segment::getPixelSpanXY(int x, int y, unsigned n, uint32_t *c, bool vertical)
+{
+  memset(c, 0, n * sizeof(uint32_t)); // pixels outside of segment read as black
+  if (!isActive()) return; // not active
+  const int vW = virtualWidth();
+  const int vH = virtualHeight();
+  if (x >= vW || y >= vH || x<0 || y<0) return;
+  if (vertical) n = MIN(n, unsigned(vH - y));
+  else          n = MIN(n, unsigned(vW - x));
+
+#ifndef WLED_DISABLE_MODE_BLEND
+  const uint32_t *buf = renderBuffer();
+  if (buf) {
+    const int step = vertical ? vW : 1;
+    buf += x + y * vW;
+    for (unsigned k = 0; k < n; k++, buf += step) c[k] = *buf;
+    return;
+  }
+#endif
+
+  const int groupLen = groupLength();
+  const int w = width();
+  const int h = height();
+  int dx = vertical ? 0 : 1;
+  int dy = vertical ? 1 : 0;
+  if (reverse  ) { x = vW - x - 1; dx = -dx; }
+  if (reverse_y) { y = vH - y - 1; dy = -dy; }
+  if (transpose) { std::swap(x, y); std::swap(dx, dy); } // swap X & Y if segment transposed
+  x *= groupLen; dx *= groupLen; // expand to physical pixels
+  y *= groupLen; dy *= groupLen; // expand to physical pixels
+
+  for (unsigned k = 0; k < n; k++, x += dx, y += dy) {
+    if (x < w && y < h) c[k] = strip.getPixelColorXY(start + x, startY + y);
+  }
+}
+
+// fills virtual row with a single color
+void Segment::fillRow(uint16_t y, uint32_t c) {
+  setSpanXY(0, y, virtualWidth(), &c, 0, false);
+}
+
+// copies virtual row src to row dst (row is read before writing, so it is safe for mirrored segments)
+void Segment::copyRow(uint16_t src, uint16_t dst) {
+  const unsigned cols = virtualWidth();
+  if (!isActive() || src == dst || src >= virtualHeight() || dst >= virtualHeight()) return;
+  uint32_t row[cols];
+  getRow(src, row);
+  setRow(dst, row);
+}
+
 // anti-aliased version of setPixelColorXY()
 void Segment::setPixelColorXY(float x, float y, uint32_t col, bool aa)
 {
@@ -268,6 +380,10 @@ void Segment::setPixelColorXY(float x, float y, uint32_t col, bool aa)
 uint32_t Segment::getPixelColorXY(uint16_t x, uint16_t y) {
   if (!isActive()) return 0; // not active
   if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return 0;  // if pixel would fall out of virtual segment just exit
+#ifndef WLED_DISABLE_MODE_BLEND
+  const uint32_t *buf = renderBuffer();
+  if (buf) return buf[x + y * virtualWidth()];
+#endif
   if (reverse  ) x = virtualWidth()  - x - 1;
   if (reverse_y) y = virtualHeight() - y - 1;
   if (transpose) { uint16_t t = x; x = y; y = t; } // swap X & Y if segment transposed
@@ -304,22 +420,17 @@ void Segment::blurRow(uint16_t row, fract8 blur_amount) {
   // blur one row
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
-  CRGB carryover = CRGB::Black;
+  uint32_t carryover = BLACK;
+  uint32_t pixels[cols];
+  getRow(row, pixels);
   for (unsigned x = 0; x < cols; x++) {
-    CRGB cur = getPixelColorXY(x, row);
-    CRGB before = cur;     // remember color before blur
-    CRGB part = cur;
-    part.nscale8(seep);
-    cur.nscale8(keep);
-    cur += carryover;
-    if (x>0) {
-      CRGB prev = CRGB(getPixelColorXY(x-1, row)) + part;
-      setPixelColorXY(x-1, row, prev);
-    }
-    if (before != cur)         // optimization: only set pixel if color has changed
-      setPixelColorXY(x, row, cur);
+    uint32_t cur  = pixels[x];
+    uint32_t part = color_fade(cur, seep);
+    pixels[x] = color_add(color_fade(cur, keep), carryover, true);
+    if (x>0) pixels[x-1] = color_add(pixels[x-1], part, true);
     carryover = part;
   }
+  setRow(row, pixels);
 }
 
 // blurCol: perform a blur on a column of a rectangular matrix
@@ -332,22 +443,17 @@ void Segment::blurCol(uint16_t col, fract8 blur_amount) {
   // blur one column
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
-  CRGB carryover = CRGB::Black;
+  uint32_t carryover = BLACK;
+  uint32_t pixels[rows];
+  getCol(col, pixels);
   for (unsigned y = 0; y < rows; y++) {
-    CRGB cur = getPixelColorXY(col, y);
-    CRGB part = cur;
-    CRGB before = cur;     // remember color before blur
-    part.nscale8(seep);
-    cur.nscale8(keep);
-    cur += carryover;
-    if (y>0) {
-      CRGB prev = CRGB(getPixelColorXY(col, y-1)) + part;
-      setPixelColorXY(col, y-1, prev);
-    }
-    if (before != cur)         // optimization: only set pixel if color has changed
-      setPixelColorXY(col, y, cur);
+    uint32_t cur  = pixels[y];
+    uint32_t part = color_fade(cur, seep);
+    pixels[y] = color_add(color_fade(cur, keep), carryover, true);
+    if (y>0) pixels[y-1] = color_add(pixels[y-1], part, true);
     carryover = part;
   }
+  setCol(col, pixels);
 }
 
 // 1D Box blur (with added weight - blur_amount: [0=no blur, 255=max blur])
@@ -361,28 +467,20 @@ void Segment::box_blur(uint16_t i, bool vertical, fract8 blur_amount) {
   const float seep = blur_amount/255.f;
   const float keep = 3.f - 2.f*seep;
   // 1D box blur
-  CRGB tmp[dim1];
+  uint32_t line[dim1];
+  uint32_t tmp[dim1];
+  getPixelSpanXY(vertical ? i : 0, vertical ? 0 : i, dim1, line, vertical);
   for (int j = 0; j < dim1; j++) {
-    uint16_t x = vertical ? i : j;
-    uint16_t y = vertical ? j : i;
-    int16_t xp = vertical ? x : x-1;  // "signed" to prevent underflow
-    int16_t yp = vertical ? y-1 : y;  // "signed" to prevent underflow
-    uint16_t xn = vertical ? x : x+1;
-    uint16_t yn = vertical ? y+1 : y;
-    CRGB curr = getPixelColorXY(x,y);
-    CRGB prev = (xp<0 || yp<0) ? CRGB::Black : getPixelColorXY(xp,yp);
-    CRGB next = ((vertical && yn>=dim1) || (!vertical && xn>=dim1)) ? CRGB::Black : getPixelColorXY(xn,yn);
+    CRGB curr = line[j];
+    CRGB prev = j > 0      ? CRGB(line[j-1]) : CRGB::Black;
+    CRGB next = j < dim1-1 ? CRGB(line[j+1]) : CRGB::Black;
     uint16_t r, g, b;
     r = (curr.r*keep + (prev.r + next.r)*seep) / 3;
     g = (curr.g*keep + (prev.g + next.g)*seep) / 3;
     b = (curr.b*keep + (prev.b + next.b)*seep) / 3;
-    tmp[j] = CRGB(r,g,b);
-  }
-  for (int j = 0; j < dim1; j++) {
-    uint16_t x = vertical ? i : j;
-    uint16_t y = vertical ? j : i;
-    setPixelColorXY(x, y, tmp[j]);
+    tmp[j] = RGBW32(r, g, b, 0);
   }
+  setPixelSpanXY(vertical ? i : 0, vertical ? 0 : i, dim1, tmp, vertical);
 }
 
 // blur1d: one-dimensional blur filter. Spreads light to 2 line neighbors.
@@ -409,16 +507,18 @@ void Segment::moveX(int8_t delta, bool wrap) {
   const uint16_t cols = virtualWidth();
   const uint16_t rows = virtualHeight();
   if (!delta || abs(delta) >= cols) return;
+  uint32_t oldPxCol[cols];
   uint32_t newPxCol[cols];
   for (int y = 0; y < rows; y++) {
+    getRow(y, oldPxCol);
     if (delta > 0) {
-      for (int x = 0; x < cols-delta; x++)    newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = cols-delta; x < cols; x++) newPxCol[x] = getPixelColorXY(wrap ? (x + delta) - cols : x, y);
+      for (int x = 0; x < cols-delta; x++)    newPxCol[x] = oldPxCol[x + delta];
+      for (int x = cols-delta; x < cols; x++) newPxCol[x] = oldPxCol[wrap ? (x + delta) - cols : x];
     } else {
-      for (int x = cols-1; x >= -delta; x--) newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = -delta-1; x >= 0; x--)    newPxCol[x] = getPixelColorXY(wrap ? (x + delta) + cols : x, y);
+      for (int x = cols-1; x >= -delta; x--) newPxCol[x] = oldPxCol[x + delta];
+      for (int x = -delta-1; x >= 0; x--)    newPxCol[x] = oldPxCol[wrap ? (x + delta) + cols : x];
     }
-    for (int x = 0; x < cols; x++) setPixelColorXY(x, y, newPxCol[x]);
+    setRow(y, newPxCol);
   }
 }
 
@@ -427,16 +527,18 @@ void Segment::moveY(int8_t delta, bool wrap) {
   const uint16_t cols = virtualWidth();
   const uint16_t rows = virtualHeight();
   if (!delta || abs(delta) >= rows) return;
+  uint32_t oldPxCol[rows];
   uint32_t newPxCol[rows];
   for (int x = 0; x < cols; x++) {
+    getCol(x, oldPxCol);
     if (delta > 0) {
-      for (int y = 0; y < rows-delta; y++)    newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = rows-delta; y < rows; y++) newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) - rows : y);
+      for (int y = 0; y < rows-delta; y++)    newPxCol[y] = oldPxCol[y + delta];
+      for (int y = rows-delta; y < rows; y++) newPxCol[y] = oldPxCol[wrap ? (y + delta) - rows : y];
     } else {
-      for (int y = rows-1; y >= -delta; y--) newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = -delta-1; y >= 0; y--)    newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) + rows : y);
+      for (int y = rows-1; y >= -delta; y--) newPxCol[y] = oldPxCol[y + delta];
+      for (int y = -delta-1; y >= 0; y--)    newPxCol[y] = oldPxCol[wrap ? (y + delta) + rows : y];
     }
-    for (int y = 0; y < rows; y++) setPixelColorXY(x, y, newPxCol[y]);
+    setCol(x, newPxCol);
   }
 }
 
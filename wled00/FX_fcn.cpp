@@ -74,6 +74,8 @@
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
 uint16_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
+uint16_t Segment::_usedPixelMapData = 0U; // amount of RAM all segments use for their pixel maps (included in _usedSegmentData)
+uint16_t Segment::_usedPaletteLUTData = 0U; // amount of RAM all segments use for their expanded palettes
 uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
@@ -84,6 +86,9 @@ unsigned long Segment::_lastPaletteChange = 0; // perhaps it should be per segme
 
 #ifndef WLED_DISABLE_MODE_BLEND
 bool Segment::_modeBlend = false;
+bool Segment::_renderToBuffer = false;
+Segment::blendbuf_t Segment::_blendPool[MAX_BLEND_BUFFERS] = {};
+size_t Segment::_usedBlendPoolData = 0;
 #endif
 
 // copy constructor
@@ -94,6 +99,10 @@ Segment::Segment(const Segment &orig) {
   name = nullptr;
   data = nullptr;
   _dataLen = 0;
+  _pixelMap = nullptr; // will be rebuilt
+  _pixelMapLen = 0;
+  _pixelMapValid = false;
+  _paletteLUT = nullptr; // will be rebuilt
   if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
   if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
 }
@@ -106,6 +115,9 @@ Segment::Segment(Segment &&orig) noexcept {
   orig.name = nullptr;
   orig.data = nullptr;
   orig._dataLen = 0;
+  orig._pixelMap = nullptr;
+  orig._pixelMapLen = 0;
+  orig._paletteLUT = nullptr;
 }
 
 // copy assignment
@@ -116,11 +128,17 @@ Segment& Segment::operator= (const Segment &orig) {
     if (name) { delete[] name; name = nullptr; }
     stopTransition();
     deallocateData();
+    deallocatePixelMap();
+    deallocatePaletteLUT();
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
+    _pixelMap = nullptr; // will be rebuilt
+    _pixelMapLen = 0;
+    _pixelMapValid = false;
+    _paletteLUT = nullptr; // will be rebuilt
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
     if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
@@ -135,10 +153,15 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (name) { delete[] name; name = nullptr; } // free old name
     stopTransition();
     deallocateData(); // free old runtime data
+    deallocatePixelMap();
+    deallocatePaletteLUT();
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
+    orig._pixelMap = nullptr;
+    orig._pixelMapLen = 0;
+    orig._paletteLUT = nullptr;
     orig._t   = nullptr; // old segment cannot be in transition
   }
   return *this;
@@ -201,6 +224,81 @@ void Segment::resetIfRequired() {
   reset = false;
 }
 
+/**
+  * (Re)builds table of physical pixel indices for a 1D segment if it was invalidated.
+  * Each virtual pixel gets _pixelMapStride entries (grouping, doubled if mirrored) which
+  * already include start, spacing, reverse, mirror, offset wrap and custom ledmap.
+  * If the table does not fit into MAX_SEGMENT_MAP_DATA setPixelColor() uses arithmetic.
+  * Must only be called from WS2812FX::service() (table is not freed while in use).
+  */
+void Segment::updatePixelMap() {
+  if (_pixelMapValid) return;
+  deallocatePixelMap();
+  _pixelMapValid = true; // do not retry until invalidated (even if map could not be built)
+  if (!isActive() || is2D()) return;
+  if (Segment::maxHeight > 1 && start < Segment::maxWidth*Segment::maxHeight) return; // 1D segment within matrix uses setPixelColorXY()
+
+  const unsigned vLen   = virtualLength();
+  const unsigned stride = grouping * (mirror ? 2 : 1);
+  const size_t   size   = vLen * stride * sizeof(uint16_t);
+  if (vLen * stride > UINT16_MAX
+      || Segment::_usedPixelMapData + size > MAX_SEGMENT_MAP_DATA
+      || Segment::getUsedSegmentData() + size > MAX_SEGMENT_DATA) {
+    DEBUG_PRINTF("Pixel map does not fit (%u/%u).\n", (unsigned)size, (unsigned)Segment::getUsedSegmentData());
+    return;
+  }
+  _pixelMap = (uint16_t*) malloc(size);
+  if (!_pixelMap) return;
+  Segment::addUsedSegmentData(size);
+  Segment::_usedPixelMapData += size;
+  _pixelMapLen    = vLen * stride;
+  _pixelMapStride = stride;
+  _pixelMapOpts   = options & (REVERSE | MIRROR);
+
+  // same expansion as (non-mapped) setPixelColor()
+  const uint16_t len = length();
+  for (unsigned v = 0; v < vLen; v++) {
+    uint16_t *entry = _pixelMap + v * stride;
+    int i = v * groupLength();
+    if (reverse) i = mirror ? (len - 1) / 2 - i : (len - 1) - i;
+    i += start;
+    for (int j = 0; j < grouping; j++) {
+      uint16_t indexSet = i + ((reverse) ? -j : j);
+      uint16_t indexMir = 0xFFFFU;
+      if (indexSet >= start && indexSet < stop) {
+        if (mirror) {
+          indexMir = stop - indexSet + start - 1;
+          indexMir += offset; // offset/phase
+          if (indexMir >= stop) indexMir -= len; // wrap
+        }
+        indexSet += offset; // offset/phase
+        if (indexSet >= stop) indexSet -= len; // wrap
+      } else {
+        indexSet = 0xFFFFU;
+      }
+      // resolve custom ledmap and out of strip pixels (same as WS2812FX::setPixelColor())
+      if (indexSet < strip.customMappingSize) indexSet = strip.customMappingTable[indexSet];
+      if (indexSet >= strip.getLength())      indexSet = 0xFFFFU;
+      *entry++ = indexSet;
+      if (mirror) {
+        if (indexMir < strip.customMappingSize) indexMir = strip.customMappingTable[indexMir];
+        if (indexMir >= strip.getLength())      indexMir = 0xFFFFU;
+        *entry++ = indexMir;
+      }
+    }
+  }
+}
+
+void Segment::deallocatePixelMap() {
+  if (!_pixelMap) return;
+  size_t size = pixelMapSize();
+  free(_pixelMap);
+  _pixelMap = nullptr;
+  _pixelMapLen = 0;
+  Segment::addUsedSegmentData(size <= Segment::getUsedSegmentData() ? -(int)size : -(int)Segment::getUsedSegmentData());
+  Segment::_usedPixelMapData -= (size <= Segment::_usedPixelMapData ? size : Segment::_usedPixelMapData);
+}
+
 CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
   if (pal < 245 && pal > GRADIENT_PALETTE_COUNT+13) pal = 0;
   if (pal > 245 && (strip.customPalettes.size() == 0 || 255U-pal > strip.customPalettes.size()-1)) pal = 0; // TODO remove strip dependency by moving customPalettes out of strip
@@ -325,6 +423,8 @@ void Segment::stopTransition() {
   //DEBUG_PRINTF("-- Stopping transition: %p\n", this);
   if (isInTransition()) {
     #ifndef WLED_DISABLE_MODE_BLEND
+    releaseBlendBuffer(_t->_buf);
+    releaseBlendBuffer(_t->_bufT);
     if (_t->_segT._dataT && _t->_segT._dataLenT > 0) {
       //DEBUG_PRINTF("--  Released duplicate data (%d): %p\n", _t->_segT._dataLenT, _t->_segT._dataT);
       free(_t->_segT._dataT);
@@ -422,6 +522,92 @@ void Segment::restoreSegenv(tmpsegd_t &tmpSeg) {
   _dataLen  = tmpSeg._dataLenT;
   //DEBUG_PRINTF("--   temp seg data: %p (%d,%p)\n", this, _dataLen, data);
 }
+
+// Off-screen render buffers for effect blending
+// Blocks are kept in the pool after release and reused by later transitions so that
+// long playlists do not keep allocating and freeing differently sized chunks of heap.
+uint32_t *Segment::acquireBlendBuffer(unsigned len) {
+  len = (len + 63) & ~63U; // round up so blocks can be reused by segments of similar size
+  if (len > UINT16_MAX) return nullptr;
+  blendbuf_t *slot = nullptr;
+  for (auto &b : _blendPool) {
+    if (b.data && !b.used && b.len >= len) { b.used = true; return b.data; }
+    if (!b.data && !slot) slot = &b;
+  }
+  // nothing to reuse: release idle blocks (too small) if we ran out of slots or budget
+  if (!slot || _usedBlendPoolData + len*sizeof(uint32_t) > MAX_BLEND_BUFFER_DATA) {
+    purgeBlendBuffers();
+    for (auto &b : _blendPool) if (!b.data) { slot = &b; break; }
+  }
+  if (!slot || _usedBlendPoolData + len*sizeof(uint32_t) > MAX_BLEND_BUFFER_DATA) return nullptr;
+  slot->data = (uint32_t *)malloc(len*sizeof(uint32_t));
+  if (!slot->data) return nullptr;
+  slot->len  = len;
+  slot->used = true;
+  _usedBlendPoolData += len*sizeof(uint32_t);
+  //DEBUG_PRINTF("--  Allocated blend buffer (%d): %p\n", len, slot->data);
+  return slot->data;
+}
+
+void Segment::releaseBlendBuffer(uint32_t *buf) {
+  if (!buf) return;
+  for (auto &b : _blendPool) if (b.data == buf) { b.used = false; return; }
+}
+
+// frees all blocks not used by a running transition
+void Segment::purgeBlendBuffers() {
+  for (auto &b : _blendPool) {
+    if (!b.data || b.used) continue;
+    free(b.data);
+    _usedBlendPoolData -= b.len*sizeof(uint32_t);
+    b.data = nullptr;
+    b.len  = 0;
+  }
+}
+
+bool Segment::allocateRenderBuffers() {
+  if (!_t) return false;
+  if (_t->_buf && _t->_bufT) return true;
+  const unsigned len = length(); // virtual size never exceeds physical size
+  if (!_t->_buf)  _t->_buf  = acquireBlendBuffer(len);
+  if (!_t->_bufT) _t->_bufT = acquireBlendBuffer(len);
+  if (!_t->_buf || !_t->_bufT) {
+    releaseBlendBuffer(_t->_buf);
+    releaseBlendBuffer(_t->_bufT);
+    _t->_buf = _t->_bufT = nullptr;
+    return false; // blend directly on strip
+  }
+  // both effects continue from what is currently displayed
+  const bool tmp = _renderToBuffer;
+  _renderToBuffer = false;
+#ifndef WLED_DISABLE_2D
+  if (is2D()) {
+    const unsigned vW = virtualWidth();
+    const unsigned vH = virtualHeight();
+    for (unsigned y = 0; y < vH; y++) getPixelSpanXY(0, y, vW, _t->_buf + y*vW);
+  } else
+#endif
+    getPixelSpan(0, virtualLength(), _t->_buf);
+  _renderToBuffer = tmp;
+  memcpy(_t->_bufT, _t->_buf, len*sizeof(uint32_t));
+  return true;
+}
+
+// paints current render buffer to the strip; previous mode's buffer is blended over new mode's output (see setPixelColor())
+void Segment::flushRenderBuffer() {
+  uint32_t *buf = renderBuffer();
+  if (!buf) return;
+  _renderToBuffer = false;
+#ifndef WLED_DISABLE_2D
+  if (is2D()) {
+    const unsigned vW = virtualWidth();
+    const unsigned vH = virtualHeight();
+    for (unsigned y = 0; y < vH; y++) setPixelSpanXY(0, y, vW, buf + y*vW);
+  } else
+#endif
+    setPixelSpan(0, virtualLength(), buf);
+  _renderToBuffer = true;
+}
 #endif
 
 uint8_t Segment::currentBri(bool useCct) {
@@ -461,6 +647,29 @@ void Segment::setCurrentPalette() {
     for (unsigned i = 0; i < noOfBlends; i++, _t->_prevPaletteBlends++) nblendPaletteTowardPalette(_t->_palT, _currentPalette, 48);
     _currentPalette = _t->_palT; // copy transitioning/temporary palette
   }
+
+  // expand palette into 256 entry table so color_from_palette() is a single lookup
+  // table is rebuilt only if resulting palette (colors, random palette, transition step) or blend type changed
+  if (!_isRGB) { deallocatePaletteLUT(); return; }
+  const uint8_t blendType = (strip.paletteBlend == 3) ? NOBLEND : LINEARBLEND;
+  if (!_paletteLUT) {
+    if (Segment::_usedPaletteLUTData + sizeof(palettelut_t) > MAX_PALETTE_LUT_DATA) return; // use ColorFromPalette()
+    _paletteLUT = (palettelut_t*) malloc(sizeof(palettelut_t));
+    if (!_paletteLUT) return;
+    Segment::_usedPaletteLUTData += sizeof(palettelut_t);
+  } else if (_paletteLUT->blendType == blendType && memcmp(_paletteLUT->source, _currentPalette.entries, sizeof(_paletteLUT->source)) == 0) {
+    return; // up to date
+  }
+  memcpy(_paletteLUT->source, _currentPalette.entries, sizeof(_paletteLUT->source));
+  _paletteLUT->blendType = blendType;
+  for (unsigned i = 0; i < 256; i++) _paletteLUT->entry[i] = ColorFromPalette(_currentPalette, i, 255, (TBlendType)blendType);
+}
+
+void Segment::deallocatePaletteLUT() {
+  if (!_paletteLUT) return;
+  free(_paletteLUT);
+  _paletteLUT = nullptr;
+  Segment::_usedPaletteLUTData -= (sizeof(palettelut_t) <= Segment::_usedPaletteLUTData ? sizeof(palettelut_t) : Segment::_usedPaletteLUTData);
 }
 
 // relies on WS2812FX::service() to call it max every 8ms or more (MIN_SHOW_DELAY)
@@ -492,6 +701,7 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
     spacing = 0;
   }
   if (ofs < UINT16_MAX) offset = ofs;
+  invalidatePixelMap();
 
   DEBUG_PRINT(F("setUp segment: ")); DEBUG_PRINT(i1);
   DEBUG_PRINT(','); DEBUG_PRINT(i2);
@@ -560,6 +770,7 @@ void Segment::setOption(uint8_t n, bool val) {
   if (fadeTransition && n == SEG_OPTION_ON && val != prevOn) startTransition(strip.getTransition()); // start transition prior to change
   if (val) options |=   0x01 << n;
   else     options &= ~(0x01 << n);
+  if (n == SEG_OPTION_REVERSED || n == SEG_OPTION_MIRROR) invalidatePixelMap();
   if (!(n == SEG_OPTION_SELECTED || n == SEG_OPTION_RESET)) stateChanged = true; // send UDP/WS broadcast
 }
 
@@ -589,6 +800,7 @@ void Segment::setMode(uint8_t fx, bool loadDefaults) {
         sOpt = extractModeDefaults(fx, "rY");   if (sOpt >= 0) reverse_y = (bool)sOpt;
         sOpt = extractModeDefaults(fx, "mY");   if (sOpt >= 0) mirror_y  = (bool)sOpt; // NOTE: setting this option is a risky business
         sOpt = extractModeDefaults(fx, "pal");  if (sOpt >= 0) setPalette(sOpt); //else setPalette(0);
+        invalidatePixelMap(); // reverse or mirror may have changed
       }
       markForReset();
       stateChanged = true; // send UDP/WS broadcast
@@ -670,6 +882,11 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col)
 
   if (i >= virtualLength() || i<0) return;  // if pixel would fall out of segment just exit
 
+#ifndef WLED_DISABLE_MODE_BLEND
+  uint32_t *buf = renderBuffer();
+  if (buf && !is2D()) { buf[i] = col; return; } // effect renders off-screen (2D segments are handled in setPixelColorXY())
+#endif
+
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
     uint16_t vH = virtualHeight();  // segment height in logical pixels
@@ -740,6 +957,20 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col)
     col = RGBW32(r, g, b, w);
   }
 
+  // use precomputed physical indices if available (mode blending may have swapped options)
+  if (hasPixelMap() && i * _pixelMapStride < _pixelMapLen) {
+    const uint16_t *entry = _pixelMap + i * _pixelMapStride;
+    for (unsigned j = 0; j < _pixelMapStride; j++) {
+      uint16_t index = entry[j];
+      if (index == 0xFFFFU) continue;
+#ifndef WLED_DISABLE_MODE_BLEND
+      if (_modeBlend) { strip.setPixelColorPhysical(index, color_blend(strip.getPixelColorPhysical(index), col, 0xFFFFU - progress(), true)); continue; }
+#endif
+      strip.setPixelColorPhysical(index, col);
+    }
+    return;
+  }
+
   // expand pixel (taking into account start, grouping, spacing [and offset])
   i = i * groupLength();
   if (reverse) { // is segment reversed?
@@ -838,6 +1069,11 @@ uint32_t Segment::getPixelColor(int i)
   }
 #endif
 
+#ifndef WLED_DISABLE_MODE_BLEND
+  uint32_t *buf = renderBuffer();
+  if (buf) return i < virtualLength() ? buf[i] : 0;
+#endif
+
   if (reverse) i = virtualLength() - i - 1;
   i *= groupLength();
   i += start;
@@ -847,6 +1083,40 @@ uint32_t Segment::getPixelColor(int i)
   return strip.getPixelColor(i);
 }
 
+// writes n consecutive virtual pixels starting at i
+// with a pixel map brightness is resolved once and indices are taken directly from the map
+void Segment::setPixelSpan(int i, unsigned n, const uint32_t *c)
+{
+  if (!isActive() || i < 0) return; // not active
+  const unsigned vLen = virtualLength();
+  if (unsigned(i) >= vLen) return;
+  n = MIN(n, vLen - i);
+  bool useMap = hasPixelMap() && (i + n) * _pixelMapStride <= _pixelMapLen;
+#ifndef WLED_DISABLE_MODE_BLEND
+  uint32_t *buf = renderBuffer();
+  if (buf && !is2D()) { memcpy(buf + i, c, n * sizeof(uint32_t)); return; } // effect renders off-screen
+  useMap &= !_modeBlend;
+#endif
+  if (!useMap) {
+    for (unsigned k = 0; k < n; k++) setPixelColor(i + int(k), c[k]);
+    return;
+  }
+  const uint8_t   _bri_t = currentBri();
+  const uint16_t *entry  = _pixelMap + i * _pixelMapStride;
+  for (unsigned k = 0; k < n; k++) {
+    uint32_t col = _bri_t < 255 ? color_fade(c[k], _bri_t) : c[k];
+    for (unsigned j = 0; j < _pixelMapStride; j++, entry++) {
+      if (*entry != 0xFFFFU) strip.setPixelColorPhysical(*entry, col);
+    }
+  }
+}
+
+// reads n consecutive virtual pixels starting at i
+void Segment::getPixelSpan(int i, unsigned n, uint32_t *c)
+{
+  for (unsigned k = 0; k < n; k++) c[k] = getPixelColor(i + int(k));
+}
+
 uint8_t Segment::differs(Segment& b) const {
   uint8_t d = 0;
   if (start != b.start)         d |= SEG_DIFFERS_BOUNDS;
@@ -875,6 +1145,7 @@ uint8_t Segment::differs(Segment& b) const {
 }
 
 void Segment::refreshLightCapabilities() {
+  invalidatePixelMap(); // called after bounds or bus changes
   uint8_t capabilities = 0;
   uint16_t segStartIdx = 0xFFFFU;
   uint16_t segStopIdx  = 0;
@@ -929,6 +1200,13 @@ void Segment::refreshLightCapabilities() {
  */
 void Segment::fill(uint32_t c) {
   if (!isActive()) return; // not active
+#ifndef WLED_DISABLE_2D
+  if (is2D()) {
+    const unsigned rows = virtualHeight();
+    for (unsigned y = 0; y < rows; y++) fillRow(y, c);
+    return;
+  }
+#endif
   const uint16_t cols = is2D() ? virtualWidth() : virtualLength();
   const uint16_t rows = virtualHeight(); // will be 1 for 1D
   for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
@@ -996,12 +1274,27 @@ void Segment::fade_out(uint8_t rate) {
 // fades all pixels to black using nscale8()
 void Segment::fadeToBlackBy(uint8_t fadeBy) {
   if (!isActive() || fadeBy == 0) return;   // optimization - no scaling to apply
-  const uint16_t cols = is2D() ? virtualWidth() : virtualLength();
-  const uint16_t rows = virtualHeight(); // will be 1 for 1D
-
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    if (is2D()) setPixelColorXY(x, y, color_fade(getPixelColorXY(x,y), 255-fadeBy));
-    else        setPixelColor(x, color_fade(getPixelColor(x), 255-fadeBy));
+#ifndef WLED_DISABLE_2D
+  if (is2D()) {
+    const unsigned cols = virtualWidth();
+    const unsigned rows = virtualHeight();
+    uint32_t pixels[cols];
+    for (unsigned y = 0; y < rows; y++) {
+      getRow(y, pixels);
+      color_fade_span(pixels, cols, 255-fadeBy);
+      setRow(y, pixels);
+    }
+    return;
+  }
+#endif
+  const unsigned vlength = virtualLength();
+  constexpr unsigned spanLen = 32;
+  uint32_t buf[spanLen];
+  for (unsigned i = 0; i < vlength; i += spanLen) {
+    const unsigned n = MIN(spanLen, vlength - i);
+    getPixelSpan(i, n, buf);
+    color_fade_span(buf, n, 255-fadeBy);
+    setPixelSpan(i, n, buf);
   }
 }
 
@@ -1024,18 +1317,25 @@ void Segment::blur(uint8_t blur_amount)
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
   uint32_t carryover = BLACK;
-  unsigned vlength = virtualLength();
-  for (unsigned i = 0; i < vlength; i++) {
-    uint32_t cur = getPixelColor(i);
-    uint32_t part = color_fade(cur, seep);
-    cur = color_add(color_fade(cur, keep), carryover, true);
-    if (i > 0) {
-      uint32_t c = getPixelColor(i-1);
-      setPixelColor(i-1, color_add(c, part, true));
+  const unsigned vlength = virtualLength();
+  // process in spans; last pixel of each span is held back (in buf[0]) as it receives part of the next pixel
+  constexpr unsigned spanLen = 32;
+  uint32_t buf[spanLen+1] = {BLACK};
+  for (unsigned i = 0; i < vlength; i += spanLen) {
+    const unsigned n = MIN(spanLen, vlength - i);
+    getPixelSpan(i, n, buf + 1);
+    for (unsigned k = 1; k <= n; k++) {
+      uint32_t cur  = buf[k];
+      uint32_t part = color_fade(cur, seep);
+      buf[k]   = color_add(color_fade(cur, keep), carryover, true);
+      buf[k-1] = color_add(buf[k-1], part, true);
+      carryover = part;
     }
-    setPixelColor(i, cur);
-    carryover = part;
+    if (i > 0) setPixelSpan(i-1, n, buf);
+    else       setPixelSpan(0, n-1, buf+1);
+    buf[0] = buf[n];
   }
+  if (vlength) setPixelSpan(vlength-1, 1, buf);
 }
 
 /*
@@ -1079,9 +1379,27 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   uint8_t paletteIndex = i;
   if (mapping && virtualLength() > 1) paletteIndex = (i*255)/(virtualLength() -1);
   if (!wrap && strip.paletteBlend != 3) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
-  CRGB fastled_col = ColorFromPalette(_currentPalette, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
-
-  return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, 0);
+  if (!_paletteLUT) {
+    CRGB fastled_col = ColorFromPalette(_currentPalette, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+    return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, 0);
+  }
+
+  // expanded palette; brightness is applied the same way as in ColorFromPalette()
+  const CRGB &c = _paletteLUT->entry[paletteIndex];
+  if (pbri == 255) return RGBW32(c.r, c.g, c.b, 0);
+  if (pbri == 0)   return 0;
+  uint8_t bri = pbri + 1;
+  uint8_t r = c.r, g = c.g, b = c.b;
+#if !(FASTLED_SCALE8_FIXED==1)
+  if (r) r = scale8(r, bri) + 1;
+  if (g) g = scale8(g, bri) + 1;
+  if (b) b = scale8(b, bri) + 1;
+#else
+  r = scale8(r, bri);
+  g = scale8(g, bri);
+  b = scale8(b, bri);
+#endif
+  return RGBW32(r, g, b, 0);
 }
 
 
@@ -1097,6 +1415,9 @@ void WS2812FX::finalizeInit(void)
     seg.markForReset();
     seg.resetIfRequired();
   }
+#ifndef WLED_DISABLE_MODE_BLEND
+  Segment::purgeBlendBuffers(); // segment sizes may change, drop idle render buffers
+#endif
 
   // for the lack of better place enumerate ledmaps here
   // if we do it in json.cpp (serializeInfo()) we are getting flashes on LEDs
@@ -1143,6 +1464,15 @@ void WS2812FX::finalizeInit(void)
     #endif
   }
 
+  // (re)allocate strip-wide frame buffer; busses are painted from it in show()
+  if (_pixels) free(_pixels);
+  _pixels = nullptr;
+  if (useGlobalLedBuffer && _length) {
+    _pixels = (uint32_t*) calloc(_length, sizeof(uint32_t));
+    if (!_pixels) DEBUG_PRINTLN(F("!!! Frame buffer allocation failed. !!!"));
+  }
+  busses.setBuffering(_pixels != nullptr); // without frame buffer busses must keep their own pixel data consistent
+
   if (isMatrix) setUpMatrix();
   else {
     Segment::maxWidth  = _length;
@@ -1172,6 +1502,8 @@ void WS2812FX::service() {
     seg.resetIfRequired();
 
     if (!seg.isActive()) continue;
+    // rebuild 1D pixel map if segment geometry changed
+    seg.updatePixelMap();
 
     // last condition ensures all solid segments are updated at the same time
     if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
@@ -1192,22 +1524,28 @@ void WS2812FX::service() {
         // Effect blending
         // When two effects are being blended, each may have different segment data, this
         // data needs to be saved first and then restored before running previous mode.
-        // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
+        // Without render buffers the blending will largely depend on the effect behaviour since actual
+        // output (LEDs) may be overwritten by later effect. With render buffers (opt-in) each effect
+        // renders into its own off-screen buffer which are then blended together for each pixel.
         [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
+#ifndef WLED_DISABLE_MODE_BLEND
+        Segment::renderToBuffer(modeBlending && modeBlendBuffers && seg.mode != tmpMode && seg.allocateRenderBuffers());
+#endif
         delay = (*_mode[seg.mode])();         // run new/current mode
 #ifndef WLED_DISABLE_MODE_BLEND
         if (modeBlending && seg.mode != tmpMode) {
+          seg.flushRenderBuffer();            // paint new mode (if rendered off-screen)
           Segment::tmpsegd_t _tmpSegData;
           Segment::modeBlend(true);           // set semaphore
           seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
           _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
           uint16_t d2 = (*_mode[tmpMode])();  // run old mode
+          seg.flushRenderBuffer();            // blend old mode over new (if rendered off-screen)
           seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
           delay = MIN(delay,d2);              // use shortest delay
           Segment::modeBlend(false);          // unset semaphore
         }
+        Segment::renderToBuffer(false);
 #endif
         if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
         if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
@@ -1239,14 +1577,39 @@ void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
 {
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return;
-  busses.setPixelColor(i, col);
+  setPixelColorPhysical(i, col);
+}
+
+// writes a range of pixels; without ledmap in that range it goes straight to the frame buffer (or busses)
+void WS2812FX::setPixelColors(unsigned i, unsigned n, const uint32_t *c)
+{
+  if (i >= _length) return;
+  if (n > _length - i) n = _length - i;
+  if (i < customMappingSize) {
+    for (unsigned k = 0; k < n; k++) setPixelColor(i + k, c[k]);
+    return;
+  }
+  if (_pixels) memcpy(_pixels + i, c, n * sizeof(uint32_t));
+  else         busses.setPixelColors(i, n, c);
 }
 
 uint32_t WS2812FX::getPixelColor(uint16_t i)
 {
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return 0;
-  return busses.getPixelColor(i);
+  return getPixelColorPhysical(i);
+}
+
+// i must be a valid physical index (< _length)
+void IRAM_ATTR WS2812FX::setPixelColorPhysical(unsigned i, uint32_t col)
+{
+  if (_pixels) _pixels[i] = col;
+  else         busses.setPixelColor(i, col);
+}
+
+uint32_t IRAM_ATTR WS2812FX::getPixelColorPhysical(unsigned i)
+{
+  return _pixels ? _pixels[i] : busses.getPixelColor(i);
 }
 
 
@@ -1261,42 +1624,57 @@ uint32_t WS2812FX::getPixelColor(uint16_t i)
 #define MA_FOR_ESP        100 //how much mA does the ESP use (Wemos D1 about 80mA, ESP32 about 120mA)
                               //you can set it to 0 if the ESP is powered by USB and the LEDs by external
 
-uint8_t WS2812FX::estimateCurrentAndLimitBri() {
+// sets brightness of each bus, returns true if any bus had to be dimmed compared to previous call
+// with frame buffer channel sums are gathered by busses while painting (no extra pass over pixels),
+// without it every pixel needs to be read back from busses
+bool WS2812FX::estimateCurrentAndLimitBri() {
   //power limit calculation
   //each LED can draw up 195075 "power units" (approx. 53mA)
   //one PU is the power it takes to have 1 channel 1 step brighter per brightness step
   //so A=2,R=255,G=0,B=0 would use 510 PU per LED (1mA is about 3700 PU)
   bool useWackyWS2815PowerModel = false;
   byte actualMilliampsPerLed = milliampsPerLed;
+  bool dimmed = false;
 
   if (ablMilliampsMax < 150 || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
     currentMilliamps = 0;
-    return _brightness;
+    for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
+      Bus *bus = busses.getBus(bNum);
+      if (_brightness < bus->getBrightness()) dimmed = true;
+      bus->setBrightness(_brightness);
+    }
+    return dimmed;
   }
 
   if (milliampsPerLed == 255) {
     useWackyWS2815PowerModel = true;
     actualMilliampsPerLed = 12; // from testing an actual strip
   }
+  Bus::setMaxChannelPower(useWackyWS2815PowerModel);
 
   size_t powerBudget = (ablMilliampsMax - MA_FOR_ESP); //100mA for ESP power
 
   size_t pLen = 0; //getLengthPhysical();
   size_t powerSum = 0;
+  uint32_t busMilliamps[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0}; // at full brightness
   for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
     Bus *bus = busses.getBus(bNum);
-    if (!IS_DIGITAL(bus->getType())) continue; //exclude non-digital network busses
+    if (!IS_DIGITAL(bus->getType()) || bus->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-digital and network busses
     uint16_t len = bus->getLength();
     pLen += len;
     uint32_t busPowerSum = 0;
-    for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
-      uint32_t c = bus->getPixelColor(i); // always returns original or restored color without brightness scaling
-      byte r = R(c), g = G(c), b = B(c), w = W(c);
+    if (_pixels) {
+      busPowerSum = bus->getColorSum(); // summed up when frame buffer was last painted
+    } else {
+      for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
+        uint32_t c = bus->getPixelColor(i); // bus returns restored color without brightness scaling
+        byte r = R(c), g = G(c), b = B(c), w = W(c);
 
-      if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-        busPowerSum += (MAX(MAX(r,g),b)) * 3;
-      } else {
-        busPowerSum += (r + g + b + w);
+        if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
+          busPowerSum += (MAX(MAX(r,g),b)) * 3;
+        } else {
+          busPowerSum += (r + g + b + w);
+        }
       }
     }
 
@@ -1305,6 +1683,7 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
       busPowerSum >>= 2; //same as /= 4
     }
     powerSum += busPowerSum;
+    busMilliamps[bNum] = (uint64_t(busPowerSum) * actualMilliampsPerLed) / 765;
   }
 
   if (powerBudget > pLen) { //each LED uses about 1mA in standby, exclude that from power budget
@@ -1323,10 +1702,25 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
     uint8_t scaleB = (scaleI > 255) ? 255 : scaleI;
     newBri = scale8(_brightness, scaleB) + 1;
   }
-  currentMilliamps = (powerSum * newBri) / 255;
+
+  // busses with their own power supply are limited further if needed
+  currentMilliamps = 0;
+  for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
+    Bus *bus = busses.getBus(bNum);
+    uint8_t busBri = newBri;
+    size_t busBudget = bus->getMaxCurrent();
+    if (busBudget > 0) {
+      uint16_t len = bus->getLength();
+      busBudget = busBudget > len ? busBudget - len : 0; // standby current
+      if (busMilliamps[bNum] * busBri / 255 > busBudget) busBri = MAX(1, (busBudget * 255) / busMilliamps[bNum]); // like global limit never black out completely
+    }
+    currentMilliamps += (busMilliamps[bNum] * busBri) / 255;
+    if (busBri < bus->getBrightness()) dimmed = true;
+    bus->setBrightness(busBri);
+  }
   currentMilliamps += MA_FOR_ESP; //add power of ESP back to estimate
   currentMilliamps += pLen; //add standby power (1mA/LED) back to estimate
-  return newBri;
+  return dimmed;
 }
 
 void WS2812FX::show(void) {
@@ -1334,19 +1728,23 @@ void WS2812FX::show(void) {
   show_callback callback = _callback;
   if (callback) callback();
 
-  uint8_t newBri = estimateCurrentAndLimitBri();
-  busses.setBrightness(newBri); // "repaints" all pixels if brightness changed
+  // brightness (incl. current limiter) is only applied here, busses ignore calls that do not change it
+  // with frame buffer pixels are painted from unscaled colors so brightness changes are lossless,
+  // without it busses need to repaint (lossy) but only when brightness actually changes
+  estimateCurrentAndLimitBri();
+
+  if (_pixels) {
+    // paint frame buffer to busses, one range per bus
+    // limiter used power estimate of previous frame; if this frame draws more, limit again and repaint
+    busses.setPixelColors(0, _length, _pixels);
+    if (estimateCurrentAndLimitBri()) busses.setPixelColors(0, _length, _pixels);
+  }
 
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
   busses.show();
 
-  // restore bus brightness to its original value
-  // this is done right after show, so this is only OK if LED updates are completed before show() returns
-  // or async show has a separate buffer (ESP32 RMT and I2S are ok)
-  if (newBri < _brightness) busses.setBrightness(_brightness);
-
   unsigned long showNow = millis();
   size_t diff = showNow - _lastShow;
   size_t fpsCurr = 200;
@@ -1417,9 +1815,7 @@ void WS2812FX::setBrightness(uint8_t b, bool direct) {
       seg.freeze = false;
     }
   }
-  // setting brightness with NeoPixelBusLg has no effect on already painted pixels,
-  // so we need to force an update to existing buffer
-  busses.setBrightness(b);
+  // busses will receive new brightness in show() (together with current limiter adjustment)
   if (!direct) {
     unsigned long t = millis();
     if (_segments[0].next_time > t + 22 && t - _lastShow > MIN_SHOW_DELAY) trigger(); //apply brightness change immediately if no refresh soon
@@ -1718,8 +2114,10 @@ void WS2812FX::printSize() {
   DEBUG_PRINTF("Modes: %d*%d=%uB\n", sizeof(mode_ptr), _mode.size(), (_mode.capacity()*sizeof(mode_ptr)));
   DEBUG_PRINTF("Data: %d*%d=%uB\n", sizeof(const char *), _modeData.size(), (_modeData.capacity()*sizeof(const char *)));
   DEBUG_PRINTF("Map: %d*%d=%uB\n", sizeof(uint16_t), (int)customMappingSize, customMappingSize*sizeof(uint16_t));
-  size = getLengthTotal();
-  if (useGlobalLedBuffer) DEBUG_PRINTF("Buffer: %d*%u=%uB\n", sizeof(CRGB), size, size*sizeof(CRGB));
+  if (_pixels) DEBUG_PRINTF("Buffer: %d*%u=%uB\n", sizeof(uint32_t), (unsigned)_length, _length*sizeof(uint32_t));
+  #ifndef WLED_DISABLE_MODE_BLEND
+  DEBUG_PRINTF("Blend buffers: %uB\n", Segment::getBlendBufferData());
+  #endif
 }
 #endif
 
@@ -1772,53 +2170,33 @@ void WS2812FX::loadCustomPalettes() {
   }
 }
 
-//load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
+//load custom mapping table from ledmap file (called from finalizeInit() or deserializeState())
 bool WS2812FX::deserializeMap(uint8_t n) {
   // 2D support creates its own ledmap (on the fly) if a ledmap.json exists it will overwrite built one.
+  uint16_t *table;
+  uint16_t  size;
+  int8_t res = readLedmap(n, table, size); // streamed, does not use the JSON buffer
 
-  char fileName[32];
-  strcpy_P(fileName, PSTR("/ledmap"));
-  if (n) sprintf(fileName +7, "%d", n);
-  strcat_P(fileName, PSTR(".json"));
-  bool isFile = WLED_FS.exists(fileName);
-
-  if (!isFile) {
+  if (res < 0) {
     // erase custom mapping if selecting nonexistent ledmap.json (n==0)
     if (!isMatrix && !n && customMappingTable != nullptr) {
       customMappingSize = 0;
       delete[] customMappingTable;
       customMappingTable = nullptr;
+      for (segment &seg : _segments) seg.invalidatePixelMap();
     }
     return false;
   }
+  if (!res) return false;
 
-  if (!requestJSONBufferLock(7)) return false;
-
-  if (!readObjectFromFile(fileName, nullptr, &doc)) {
-    releaseJSONBufferLock();
-    return false; //if file does not exist just exit
-  }
-
-  DEBUG_PRINT(F("Reading LED map from "));
-  DEBUG_PRINTLN(fileName);
-
-  // erase old custom ledmap
-  if (customMappingTable != nullptr) {
-    customMappingSize = 0;
-    delete[] customMappingTable;
-    customMappingTable = nullptr;
-  }
-
-  JsonArray map = doc[F("map")];
-  if (!map.isNull() && map.size()) {  // not an empty map
-    customMappingSize  = map.size();
-    customMappingTable = new uint16_t[customMappingSize];
-    for (unsigned i=0; i<customMappingSize; i++) {
-      customMappingTable[i] = (uint16_t) (map[i]<0 ? 0xFFFFU : map[i]);
-    }
-  }
+  // replace old custom ledmap (size is 0 while the table pointer changes)
+  uint16_t *oldTable = customMappingTable;
+  customMappingSize  = 0;
+  customMappingTable = table;
+  customMappingSize  = size;
+  delete[] oldTable;
+  for (segment &seg : _segments) seg.invalidatePixelMap(); // physical indices changed
 
-  releaseJSONBufferLock();
   return true;
 }
 
@@ -15,7 +15,7 @@ uint16_t approximateKelvinFromRGB(uint32_t rgb);
 void colorRGBtoRGBW(byte* rgb);
 
 //udp.cpp
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false, uint16_t *packets=nullptr);
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -102,6 +102,11 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 , _skip(bc.skipAmount) //sacrificial pixels
 , _colorOrder(bc.colorOrder)
 , _colorOrderMap(com)
+, _colorOrderLUT(nullptr)
+, _colorOrderBus(bc.colorOrder)
+, _milliAmpsMax(bc.milliAmpsMax)
+, _colorSum(0)
+, _buffering(false)
 {
   if (!IS_DIGITAL(bc.type) || !bc.count) return;
   if (!pinManager.allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
@@ -117,42 +122,16 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
   }
   _iType = PolyBus::getI(bc.type, _pins, nr);
   if (_iType == I_NONE) return;
-  if (bc.doubleBuffer && !allocData(bc.count * (Bus::hasWhite(_type) + 3*Bus::hasRGB(_type)))) return; //warning: hardcoded channel count
-  _buffering = bc.doubleBuffer;
   uint16_t lenToCreate = bc.count;
   if (bc.type == TYPE_WS2812_1CH_X3) lenToCreate = NUM_ICS_WS2812_1CH_3X(bc.count); // only needs a third of "RGB" LEDs for NeoPixelBus
   _busPtr = PolyBus::create(_iType, _pins, lenToCreate + _skip, nr, _frequencykHz);
   _valid = (_busPtr != nullptr);
+  if (_valid) compileColorOrderMap();
   DEBUG_PRINTF("%successfully inited strip %u (len %u) with type %u and pins %u,%u (itype %u)\n", _valid?"S":"Uns", nr, bc.count, bc.type, _pins[0], _pins[1], _iType);
 }
 
 void BusDigital::show() {
   if (!_valid) return;
-  if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
-    size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
-    for (size_t i=0; i<_len; i++) {
-      size_t offset = i*channels;
-      uint8_t co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
-      uint32_t c;
-      if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
-        switch (i%3) {
-          case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
-          case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
-          case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
-        }
-      } else {
-        c = RGBW32(_data[offset],_data[offset+1],_data[offset+2],(Bus::hasWhite(_type)?_data[offset+3]:0));
-      }
-      uint16_t pix = i;
-      if (_reversed) pix = _len - pix -1;
-      pix += _skip;
-      PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
-    }
-    #if !defined(STATUSLED) || STATUSLED>=0
-    if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
-    #endif
-    for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
-  }
   PolyBus::show(_busPtr, _iType, !_buffering); // faster if buffer consistency is not important
 }
 
@@ -173,7 +152,7 @@ void BusDigital::setBrightness(uint8_t b) {
   Bus::setBrightness(b);
   PolyBus::setBrightness(_busPtr, _iType, b);
 
-  if (_buffering) return;
+  if (_buffering) return; // all pixels will be repainted from frame buffer before next show
 
   // must update/repaint every LED in the NeoPixelBus buffer to the new brightness
   // the only case where repainting is unnecessary is when all pixels are set after the brightness change but before the next show
@@ -191,7 +170,7 @@ void BusDigital::setBrightness(uint8_t b) {
 //TODO only show if no new show due in the next 50ms
 void BusDigital::setStatusPixel(uint32_t c) {
   if (_valid && _skip) {
-    PolyBus::setPixelColor(_busPtr, _iType, 0, c, _colorOrderMap.getPixelColorOrder(_start, _colorOrder));
+    PolyBus::setPixelColor(_busPtr, _iType, 0, c, getPixelColorOrder(0));
     if (canShow()) PolyBus::show(_busPtr, _iType);
   }
 }
@@ -200,63 +179,70 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   if (!_valid) return;
   if (Bus::hasWhite(_type)) c = autoWhiteCalc(c);
   if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
-  if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
-    size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
-    size_t offset = pix*channels;
-    if (Bus::hasRGB(_type)) {
-      _data[offset++] = R(c);
-      _data[offset++] = G(c);
-      _data[offset++] = B(c);
-    }
-    if (Bus::hasWhite(_type)) _data[offset] = W(c);
-  } else {
-    if (_reversed) pix = _len - pix -1;
-    pix += _skip;
-    uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
-    if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
-      uint16_t pOld = pix;
-      pix = IC_INDEX_WS2812_1CH_3X(pix);
-      uint32_t cOld = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, pix, co),_bri);
-      switch (pOld % 3) { // change only the single channel (TODO: this can cause loss because of get/set)
-        case 0: c = RGBW32(R(cOld), W(c)   , B(cOld), 0); break;
-        case 1: c = RGBW32(W(c)   , G(cOld), B(cOld), 0); break;
-        case 2: c = RGBW32(R(cOld), G(cOld), W(c)   , 0); break;
-      }
+  if (_reversed) pix = _len - pix -1;
+  pix += _skip;
+  uint8_t co = getPixelColorOrder(pix);
+  if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
+    uint16_t pOld = pix;
+    pix = IC_INDEX_WS2812_1CH_3X(pix);
+    uint32_t cOld = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, pix, co),_bri);
+    switch (pOld % 3) { // change only the single channel (TODO: this can cause loss because of get/set)
+      case 0: c = RGBW32(R(cOld), W(c)   , B(cOld), 0); break;
+      case 1: c = RGBW32(W(c)   , G(cOld), B(cOld), 0); break;
+      case 2: c = RGBW32(R(cOld), G(cOld), W(c)   , 0); break;
     }
-    PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
+  }
+  PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
+}
+
+// paints a range of pixels in one go (used when flushing strip's frame buffer)
+// auto white, CCT and reversal decisions are made once per range instead of once per pixel
+// channel sum for current estimation is gathered in the same pass (see WS2812FX::estimateCurrentAndLimitBri())
+void IRAM_ATTR BusDigital::setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) {
+  if (!_valid || pix >= _len) return;
+  if (count > _len - pix) count = _len - pix;
+  uint32_t colorSum = pix ? _colorSum : 0; // a pass over the whole frame starts at pixel 0
+  for (unsigned i = 0; i < count; i++) {
+    uint8_t r = R(c[i]), g = G(c[i]), b = B(c[i]);
+    if (_maxChannelPower) colorSum += (r > g ? (r > b ? r : b) : (g > b ? g : b)) * 3; // brightest RGB channel
+    else                  colorSum += r + g + b + W(c[i]);
+  }
+  _colorSum = colorSum;
+  if (_type == TYPE_WS2812_1CH_X3) { // each IC controls 3 LEDs and needs read-modify-write
+    for (unsigned i = 0; i < count; i++) setPixelColor(pix + i, c[i]);
+    return;
+  }
+  uint8_t aWM = _gAWM != AW_GLOBAL_DISABLED ? _gAWM : _autoWhiteMode;
+  const bool doAW  = Bus::hasWhite(_type) && aWM != RGBW_MODE_MANUAL_ONLY;
+  const bool doCCT = _cct >= 1900;
+  const int  dir   = _reversed ? -1 : 1;
+  int hwPix = (_reversed ? _len - pix - 1 : pix) + _skip;
+  for (unsigned i = 0; i < count; i++, hwPix += dir) {
+    uint32_t col = c[i];
+    if (doAW)  col = autoWhiteCalc(col);
+    if (doCCT) col = colorBalanceFromKelvin(_cct, col); //color correction from CCT
+    PolyBus::setPixelColor(_busPtr, _iType, hwPix, col, getPixelColorOrder(hwPix));
   }
 }
 
-// returns original color if global buffering is enabled, else returns lossly restored color from bus
+// returns lossly restored color from bus (WS2812FX frame buffer holds original color if global buffering is enabled)
 uint32_t BusDigital::getPixelColor(uint16_t pix) {
   if (!_valid) return 0;
-  if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
-    size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
-    size_t offset = pix*channels;
-    uint32_t c;
-    if (!Bus::hasRGB(_type)) {
-      c = RGBW32(_data[offset], _data[offset], _data[offset], _data[offset]);
-    } else {
-      c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], Bus::hasWhite(_type) ? _data[offset+3] : 0);
-    }
-    return c;
-  } else {
-    if (_reversed) pix = _len - pix -1;
-    pix += _skip;
-    uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
-    uint32_t c = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, (_type==TYPE_WS2812_1CH_X3) ? IC_INDEX_WS2812_1CH_3X(pix) : pix, co),_bri);
-    if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
-      uint8_t r = R(c);
-      uint8_t g = _reversed ? B(c) : G(c); // should G and B be switched if _reversed?
-      uint8_t b = _reversed ? G(c) : B(c);
-      switch (pix % 3) { // get only the single channel
-        case 0: c = RGBW32(g, g, g, g); break;
-        case 1: c = RGBW32(r, r, r, r); break;
-        case 2: c = RGBW32(b, b, b, b); break;
-      }
+  if (_reversed) pix = _len - pix -1;
+  pix += _skip;
+  uint8_t co = getPixelColorOrder(pix);
+  uint32_t c = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, (_type==TYPE_WS2812_1CH_X3) ? IC_INDEX_WS2812_1CH_3X(pix) : pix, co),_bri);
+  if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
+    uint8_t r = R(c);
+    uint8_t g = _reversed ? B(c) : G(c); // should G and B be switched if _reversed?
+    uint8_t b = _reversed ? G(c) : B(c);
+    switch (pix % 3) { // get only the single channel
+      case 0: c = RGBW32(g, g, g, g); break;
+      case 1: c = RGBW32(r, r, r, r); break;
+      case 2: c = RGBW32(b, b, b, b); break;
     }
-    return c;
   }
+  return c;
 }
 
 uint8_t BusDigital::getPins(uint8_t* pinArray) {
@@ -269,6 +255,28 @@ void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
   _colorOrder = colorOrder;
+  compileColorOrderMap();
+}
+
+// resolves ColorOrderMap for all hardware pixels of this bus once (instead of searching mappings for every pixel)
+// a lookup table is only allocated if color order changes within the bus
+void BusDigital::compileColorOrderMap() {
+  if (_colorOrderLUT) free(_colorOrderLUT);
+  _colorOrderLUT = nullptr;
+  _colorOrderBus = _colorOrderMap.getPixelColorOrder(_start, _colorOrder);
+  if (!_valid) return;
+  const unsigned hwLen = _len + _skip;
+  bool uniform = true;
+  for (unsigned i = 1; i < hwLen && uniform; i++) uniform = (_colorOrderMap.getPixelColorOrder(i + _start, _colorOrder) == _colorOrderBus);
+  if (uniform) return; // common case: no lookup needed
+  _colorOrderLUT = (uint8_t *)calloc((hwLen + 1) / 2, sizeof(uint8_t));
+  if (!_colorOrderLUT) {
+    DEBUG_PRINTLN(F("Color order LUT alloc error."));
+    return; // bus will use single color order
+  }
+  for (unsigned i = 0; i < hwLen; i++) {
+    _colorOrderLUT[i >> 1] |= (_colorOrderMap.getPixelColorOrder(i + _start, _colorOrder) & 0x0F) << ((i & 1) << 2);
+  }
 }
 
 void BusDigital::reinit() {
@@ -283,6 +291,8 @@ void BusDigital::cleanup() {
   _valid = false;
   _busPtr = nullptr;
   if (_data != nullptr) freeData();
+  if (_colorOrderLUT) free(_colorOrderLUT);
+  _colorOrderLUT = nullptr;
   pinManager.deallocatePin(_pins[1], PinOwner::BusDigital);
   pinManager.deallocatePin(_pins[0], PinOwner::BusDigital);
 }
@@ -467,6 +477,8 @@ uint8_t BusOnOff::getPins(uint8_t* pinArray) {
 BusNetwork::BusNetwork(BusConfig &bc)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count)
 , _broadcastLock(false)
+, _packetsSent(0)
+, _packetsFailed(0)
 {
   switch (bc.type) {
     case TYPE_NET_ARTNET_RGB:
@@ -498,6 +510,22 @@ void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
   if (_rgbw) _data[offset+3] = W(c);
 }
 
+void BusNetwork::setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) {
+  if (!_valid || pix >= _len) return;
+  if (count > _len - pix) count = _len - pix;
+  const bool doCCT = _cct >= 1900;
+  uint8_t *d = _data + pix * _UDPchannels;
+  for (unsigned i = 0; i < count; i++, d += _UDPchannels) {
+    uint32_t col = c[i];
+    if (_rgbw) col = autoWhiteCalc(col);
+    if (doCCT) col = colorBalanceFromKelvin(_cct, col); //color correction from CCT
+    d[0] = R(col);
+    d[1] = G(col);
+    d[2] = B(col);
+    if (_rgbw) d[3] = W(col);
+  }
+}
+
 uint32_t BusNetwork::getPixelColor(uint16_t pix) {
   if (!_valid || pix >= _len) return 0;
   uint16_t offset = pix * _UDPchannels;
@@ -507,7 +535,9 @@ uint32_t BusNetwork::getPixelColor(uint16_t pix) {
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw);
+  uint16_t sent = 0;
+  if (realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw, &sent)) _packetsFailed++;
+  _packetsSent += sent;
   _broadcastLock = false;
 }
 
@@ -558,7 +588,9 @@ int BusManager::add(BusConfig &bc) {
   } else {
     busses[numBusses] = new BusPwm(bc);
   }
-  return numBusses++;
+  numBusses++;
+  rebuildBusRanges();
+  return numBusses - 1;
 }
 
 //do not call this method from system context (network callback)
@@ -568,9 +600,48 @@ void BusManager::removeAll() {
   while (!canAllShow()) yield();
   for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
+  rebuildBusRanges();
+}
+
+void BusManager::rebuildBusRanges() {
+  busOverlap = false;
+  lastBus = 0;
+  for (uint8_t i = 0; i < numBusses; i++) {
+    busStart[i]  = busses[i]->getStart();
+    busEnd[i]    = busStart[i] + busses[i]->getLength();
+    sortedBus[i] = i;
+  }
+  // insertion sort, there are only a few busses
+  for (uint8_t i = 1; i < numBusses; i++) {
+    for (uint8_t j = i; j > 0 && busStart[sortedBus[j-1]] > busStart[sortedBus[j]]; j--) {
+      uint8_t t = sortedBus[j-1]; sortedBus[j-1] = sortedBus[j]; sortedBus[j] = t;
+    }
+  }
+  for (uint8_t i = 1; i < numBusses; i++) {
+    if (busStart[sortedBus[i]] < busEnd[sortedBus[i-1]]) busOverlap = true;
+  }
+}
+
+// returns index of bus containing pixel or -1 (only valid if busses do not overlap)
+int IRAM_ATTR BusManager::findBus(uint16_t pix) {
+  uint8_t b = lastBus;
+  if (b < numBusses && pix >= busStart[b] && pix < busEnd[b]) return b;
+  int lo = 0, hi = numBusses - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    b = sortedBus[mid];
+    if      (pix <  busStart[b]) hi = mid - 1;
+    else if (pix >= busEnd[b])   lo = mid + 1;
+    else { lastBus = b; return b; }
+  }
+  return -1;
 }
 
 void BusManager::show() {
+  if (colorOrderMapChanged) {
+    colorOrderMapChanged = false;
+    for (uint8_t i = 0; i < numBusses; i++) busses[i]->compileColorOrderMap();
+  }
   for (uint8_t i = 0; i < numBusses; i++) {
     busses[i]->show();
   }
@@ -583,11 +654,25 @@ void BusManager::setStatusPixel(uint32_t c) {
 }
 
 void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c) {
+  if (busOverlap) {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (pix < busStart[i] || pix >= busEnd[i]) continue;
+      busses[i]->setPixelColor(pix - busStart[i], c);
+    }
+    return;
+  }
+  int b = findBus(pix);
+  if (b >= 0) busses[b]->setPixelColor(pix - busStart[b], c);
+}
+
+// paints count pixels starting at pix; each bus receives its part of the range in a single call
+void IRAM_ATTR BusManager::setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) {
+  const unsigned end = pix + count;
   for (uint8_t i = 0; i < numBusses; i++) {
-    Bus* b = busses[i];
-    uint16_t bstart = b->getStart();
-    if (pix < bstart || pix >= bstart + b->getLength()) continue;
-    busses[i]->setPixelColor(pix - bstart, c);
+    unsigned s = pix > busStart[i] ? pix : busStart[i];
+    unsigned e = end < busEnd[i] ? end : busEnd[i];
+    if (s >= e) continue;
+    busses[i]->setPixelColors(s - busStart[i], e - s, c + (s - pix));
   }
 }
 
@@ -597,6 +682,12 @@ void BusManager::setBrightness(uint8_t b) {
   }
 }
 
+void BusManager::setBuffering(bool b) {
+  for (uint8_t i = 0; i < numBusses; i++) {
+    busses[i]->setBuffering(b);
+  }
+}
+
 void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
   if (cct > 255) cct = 255;
   if (cct >= 0) {
@@ -607,13 +698,15 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
 }
 
 uint32_t BusManager::getPixelColor(uint16_t pix) {
-  for (uint8_t i = 0; i < numBusses; i++) {
-    Bus* b = busses[i];
-    uint16_t bstart = b->getStart();
-    if (pix < bstart || pix >= bstart + b->getLength()) continue;
-    return b->getPixelColor(pix - bstart);
+  if (busOverlap) {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (pix < busStart[i] || pix >= busEnd[i]) continue;
+      return busses[i]->getPixelColor(pix - busStart[i]);
+    }
+    return 0;
   }
-  return 0;
+  int b = findBus(pix);
+  return b >= 0 ? busses[b]->getPixelColor(pix - busStart[b]) : 0;
 }
 
 bool BusManager::canAllShow() {
@@ -639,3 +732,4 @@ uint16_t BusManager::getTotalLength() {
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
 uint8_t Bus::_gAWM = 255;
+bool    Bus::_maxChannelPower = false;
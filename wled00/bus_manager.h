@@ -18,7 +18,7 @@
 #define IC_INDEX_WS2812_2CH_3X(i)  ((i)*2/3)
 #define WS2812_2CH_3X_SPANS_2_ICS(i) ((i)&0x01)    // every other LED zone is on two different ICs
 
-// flag for using double buffering in BusDigital
+// flag for using strip-wide frame buffer (WS2812FX keeps unscaled pixel data, busses are repainted on every show())
 extern bool useGlobalLedBuffer;
 
 
@@ -34,9 +34,10 @@ struct BusConfig {
   uint8_t autoWhite;
   uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255};
   uint16_t frequency;
-  bool doubleBuffer;
+  bool doubleBuffer; // strip frame buffer requested (busses are switched to buffering in finalizeInit() once it is allocated)
+  uint16_t milliAmpsMax; // current limit of this bus' power supply (0 = only global limit applies)
 
-  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, bool dblBfr=false)
+  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, bool dblBfr=false, uint16_t maMax=0)
   : count(len)
   , start(pstart)
   , colorOrder(pcolorOrder)
@@ -45,6 +46,7 @@ struct BusConfig {
   , autoWhite(aw)
   , frequency(clock_kHz)
   , doubleBuffer(dblBfr)
+  , milliAmpsMax(maMax)
   {
     refreshReq = (bool) GET_BIT(busType,7);
     type = busType & 0x7F;  // bit 7 may be/is hacked to include refresh info (1=refresh in off state, 0=no refresh)
@@ -123,15 +125,21 @@ class Bus {
     virtual bool     canShow()                   { return true; }
     virtual void     setStatusPixel(uint32_t c)  {}
     virtual void     setPixelColor(uint16_t pix, uint32_t c) = 0;
+    virtual void     setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c) { for (unsigned i = 0; i < count; i++) setPixelColor(pix + i, c[i]); }
     virtual uint32_t getPixelColor(uint16_t pix) { return 0; }
     virtual void     setBrightness(uint8_t b)    { _bri = b; };
+    virtual void     setBuffering(bool b)        {}
     virtual void     cleanup() = 0;
     virtual uint8_t  getPins(uint8_t* pinArray)  { return 0; }
     virtual uint16_t getLength()                 { return _len; }
     virtual void     setColorOrder()             {}
+    virtual void     compileColorOrderMap()      {}
     virtual uint8_t  getColorOrder()             { return COL_ORDER_RGB; }
     virtual uint8_t  skippedLeds()               { return 0; }
     virtual uint16_t getFrequency()              { return 0U; }
+    virtual uint16_t getMaxCurrent()             { return 0; }
+    virtual uint32_t getColorSum()               { return 0; }
+    inline  uint8_t  getBrightness()             { return _bri; }
     inline  void     setReversed(bool reversed)  { _reversed = reversed; }
     inline  uint16_t getStart()                  { return _start; }
     inline  void     setStart(uint16_t start)    { _start = start; }
@@ -174,6 +182,7 @@ class Bus {
     inline        uint8_t getAutoWhiteMode()          { return _autoWhiteMode; }
     inline static void    setGlobalAWMode(uint8_t m)  { if (m < 5) _gAWM = m; else _gAWM = AW_GLOBAL_DISABLED; }
     inline static uint8_t getGlobalAWMode()           { return _gAWM; }
+    inline static void    setMaxChannelPower(bool b)  { _maxChannelPower = b; }
 
   protected:
     uint8_t  _type;
@@ -188,6 +197,7 @@ class Bus {
     static uint8_t _gAWM;
     static int16_t _cct;
     static uint8_t _cctBlend;
+    static bool    _maxChannelPower; // WS2815 power model: brightest channel is counted for all 3 channels
 
     uint32_t autoWhiteCalc(uint32_t c);
     uint8_t *allocData(size_t size = 1);
@@ -203,14 +213,19 @@ class BusDigital : public Bus {
     void show();
     bool canShow();
     void setBrightness(uint8_t b);
+    void setBuffering(bool b) { _buffering = b; }
     void setStatusPixel(uint32_t c);
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c);
     void setColorOrder(uint8_t colorOrder);
+    void compileColorOrderMap();
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getColorOrder() { return _colorOrder; }
     uint8_t  getPins(uint8_t* pinArray);
     uint8_t  skippedLeds()   { return _skip; }
     uint16_t getFrequency()  { return _frequencykHz; }
+    uint16_t getMaxCurrent() { return _milliAmpsMax; }
+    uint32_t getColorSum()   { return _colorSum; }
     void reinit();
     void cleanup();
 
@@ -222,7 +237,17 @@ class BusDigital : public Bus {
     uint16_t _frequencykHz;
     void * _busPtr;
     const ColorOrderMap &_colorOrderMap;
-    bool _buffering; // temporary until we figure out why comparison "_data != nullptr" causes severe FPS drop
+    uint8_t *_colorOrderLUT;   // color order (low nibble) of each hardware pixel, 2 pixels per byte; nullptr if the same for all pixels
+    uint8_t _colorOrderBus;    // resolved color order if _colorOrderLUT is not used
+    uint16_t _milliAmpsMax;
+    uint32_t _colorSum;        // sum of all channels (unscaled) of pixels painted by last setPixelColors() pass starting at pixel 0
+    bool _buffering; // pixels are repainted from strip's frame buffer on every show(), no need to keep NeoPixelBus buffer consistent
+
+    // color order of a hardware pixel (incl. skipped pixels) as resolved from ColorOrderMap by compileColorOrderMap()
+    inline uint8_t getPixelColorOrder(uint16_t hwPix) const {
+      if (!_colorOrderLUT) return _colorOrderBus;
+      return (_colorOrder & 0xF0) | ((_colorOrderLUT[hwPix >> 1] >> ((hwPix & 1) << 2)) & 0x0F); // upper nibble contains W swap information
+    }
 
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) {
       if (restoreBri < 255) {
@@ -287,23 +312,29 @@ class BusNetwork : public Bus {
     bool hasWhite() { return _rgbw; }
     bool canShow()  { return !_broadcastLock; } // this should be a return value from UDP routine if it is still sending data out
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c);
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getPins(uint8_t* pinArray);
     void show();
     void cleanup();
 
+    uint32_t getPacketsSent()   const { return _packetsSent; }
+    uint32_t getPacketsFailed() const { return _packetsFailed; } // frames not (completely) sent
+
   private:
     IPAddress _client;
     uint8_t   _UDPtype;
     uint8_t   _UDPchannels;
     bool      _rgbw;
     bool      _broadcastLock;
+    uint32_t  _packetsSent;
+    uint32_t  _packetsFailed;
 };
 
 
 class BusManager {
   public:
-    BusManager() : numBusses(0) {};
+    BusManager() : numBusses(0), colorOrderMapChanged(false), lastBus(0), busOverlap(false) {};
 
     //utility to get the approx. memory usage of a given BusConfig
     static uint32_t memUsage(BusConfig &bc);
@@ -317,7 +348,9 @@ class BusManager {
     bool canAllShow();
     void setStatusPixel(uint32_t c);
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixelColors(uint16_t pix, uint16_t count, const uint32_t *c); // paints a range of pixels, split by bus
     void setBrightness(uint8_t b);
+    void setBuffering(bool b); // busses are repainted from strip's frame buffer before each show()
     void setSegmentCCT(int16_t cct, bool allowWBCorrection = false);
     uint32_t getPixelColor(uint16_t pix);
 
@@ -327,13 +360,25 @@ class BusManager {
     uint16_t getTotalLength();
     inline uint8_t getNumBusses() const { return numBusses; }
 
-    inline void                 updateColorOrderMap(const ColorOrderMap &com) { memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap)); }
+    // may be called from network callback; busses recompile their lookup tables in show()
+    inline void                 updateColorOrderMap(const ColorOrderMap &com) { memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap)); colorOrderMapChanged = true; }
     inline const ColorOrderMap& getColorOrderMap() const { return colorOrderMap; }
 
   private:
     uint8_t numBusses;
     Bus* busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
     ColorOrderMap colorOrderMap;
+    bool colorOrderMapChanged;
+
+    // cached bus ranges (rebuilt in add() & removeAll()) so that pixel lookup needs no virtual calls
+    uint16_t busStart[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+    uint32_t busEnd[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];   // exclusive (start + length may exceed 16 bits)
+    uint8_t  sortedBus[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES]; // bus indices sorted by start
+    uint8_t  lastBus;    // bus of last lookup (pixels are mostly accessed in order)
+    bool     busOverlap; // busses share pixels, every matching bus needs to be updated
+
+    void rebuildBusRanges();
+    int  findBus(uint16_t pix);
 
     inline uint8_t getNumVirtualBusses() {
       int j = 0;
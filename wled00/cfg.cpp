@@ -159,8 +159,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       uint16_t freqkHz = elm[F("freq")] | 0;  // will be in kHz for DotStar and Hz for PWM (not yet implemented fully)
       ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
       uint8_t AWmode = elm[F("rgbwm")] | RGBW_MODE_MANUAL_ONLY;
+      uint16_t maMax = elm[F("maxpwr")] | 0;
       if (fromFS) {
-        BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer);
+        BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maMax);
         mem += BusManager::memUsage(bc);
         if (useGlobalLedBuffer && start + length > maxlen) {
           maxlen = start + length;
@@ -169,7 +170,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
         if (mem + globalBufMem <= MAX_LED_MEMORY) if (busses.add(bc) == -1) break;  // finalization will be done in WLED::beginStrip()
       } else {
         if (busConfigs[s] != nullptr) delete busConfigs[s];
-        busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer);
+        busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maMax);
         busesChanged = true;
       }
       s++;
@@ -359,6 +360,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject light_tr = light["tr"];
   CJSON(fadeTransition, light_tr["mode"]);
   CJSON(modeBlending, light_tr["fx"]);
+  CJSON(modeBlendBuffers, light_tr["fxb"]);
   int tdd = light_tr["dur"] | -1;
   if (tdd >= 0) transitionDelay = transitionDelayDefault = tdd * 100;
   strip.setTransition(fadeTransition ? transitionDelayDefault : 0);
@@ -392,6 +394,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(receiveGroups, if_sync_recv["grp"]);
   CJSON(receiveSegmentOptions, if_sync_recv["seg"]);
   CJSON(receiveSegmentBounds, if_sync_recv["sb"]);
+  CJSON(clockSyncEnabled, if_sync_recv[F("clk")]);
   //! following line might be a problem if called after boot
   receiveNotifications = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects || receiveSegmentOptions);
 
@@ -406,6 +409,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(syncGroups, if_sync_send["grp"]);
   if (if_sync_send[F("twice")]) udpNumRetries = 1; // import setting from 0.13 and earlier
   CJSON(udpNumRetries, if_sync_send["ret"]);
+  CJSON(notifierDelta, if_sync_send[F("delta")]);
 
   JsonObject if_nodes = interfaces["nodes"];
   CJSON(nodeListEnabled, if_nodes[F("list")]);
@@ -428,12 +432,28 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(e131Priority, if_live_dmx[F("e131prio")]);
   if (e131Priority > 200) e131Priority = 200;
   CJSON(DMXMode, if_live_dmx["mode"]);
+  CJSON(realtimeFrameTimeout, if_live_dmx[F("frmto")]);
+  if (realtimeFrameTimeout < 5 || realtimeFrameTimeout > 1000) realtimeFrameTimeout = 25;
+
+  JsonObject if_live_out = if_live[F("e131out")];
+  CJSON(e131OutUniverse, if_live_out[F("uni")]);
+  if (!e131OutUniverse || e131OutUniverse > 63999) e131OutUniverse = 1;
+  CJSON(e131OutPriority, if_live_out[F("prio")]);
+  if (e131OutPriority > 200) e131OutPriority = 200;
+  CJSON(e131OutSyncUniverse, if_live_out[F("sync")]);
+  if (e131OutSyncUniverse > 63999) e131OutSyncUniverse = 0;
+  CJSON(realtimeOutPacing, if_live[F("pace")]);
+  if (realtimeOutPacing > 5000) realtimeOutPacing = 5000;
 
   tdd = if_live[F("timeout")] | -1;
   if (tdd >= 0) realtimeTimeoutMs = tdd * 100;
   CJSON(arlsForceMaxBri, if_live[F("maxbri")]);
   CJSON(arlsDisableGammaCorrection, if_live[F("no-gc")]); // false
   CJSON(arlsOffset, if_live[F("offset")]); // 0
+  CJSON(udpRxMaxPackets, if_live[F("rxpkt")]);
+  if (!udpRxMaxPackets) udpRxMaxPackets = 1;
+  CJSON(udpRxBudgetMs, if_live[F("rxms")]);
+  CJSON(realtimeStats, if_live[F("stats")]);
 
   CJSON(alexaEnabled, interfaces["va"][F("alexa")]); // false
 
@@ -760,6 +780,7 @@ void serializeConfig() {
     ins["ref"] = bus->isOffRefreshRequired();
     ins[F("rgbwm")] = bus->getAutoWhiteMode();
     ins[F("freq")] = bus->getFrequency();
+    ins[F("maxpwr")] = bus->getMaxCurrent();
   }
 
   JsonArray hw_com = hw.createNestedArray(F("com"));
@@ -831,6 +852,7 @@ void serializeConfig() {
   JsonObject light_tr = light.createNestedObject("tr");
   light_tr["mode"] = fadeTransition;
   light_tr["fx"] = modeBlending;
+  light_tr["fxb"] = modeBlendBuffers;
   light_tr["dur"] = transitionDelayDefault / 100;
   light_tr["pal"] = strip.paletteFade;
   light_tr[F("rpc")] = randomPaletteChangeTime;
@@ -859,6 +881,7 @@ void serializeConfig() {
   if_sync_recv["grp"] = receiveGroups;
   if_sync_recv["seg"] = receiveSegmentOptions;
   if_sync_recv["sb"]  = receiveSegmentBounds;
+  if_sync_recv[F("clk")] = clockSyncEnabled;
 
   JsonObject if_sync_send = if_sync.createNestedObject("send");
   if_sync_send[F("dir")] = notifyDirect;
@@ -868,6 +891,7 @@ void serializeConfig() {
   if_sync_send["macro"] = notifyMacro;
   if_sync_send["grp"] = syncGroups;
   if_sync_send["ret"] = udpNumRetries;
+  if_sync_send[F("delta")] = notifierDelta;
 
   JsonObject if_nodes = interfaces.createNestedObject("nodes");
   if_nodes[F("list")] = nodeListEnabled;
@@ -886,11 +910,21 @@ void serializeConfig() {
   if_live_dmx[F("addr")] = DMXAddress;
   if_live_dmx[F("dss")] = DMXSegmentSpacing;
   if_live_dmx["mode"] = DMXMode;
+  if_live_dmx[F("frmto")] = realtimeFrameTimeout;
+
+  JsonObject if_live_out = if_live.createNestedObject(F("e131out"));
+  if_live_out[F("uni")] = e131OutUniverse;
+  if_live_out[F("prio")] = e131OutPriority;
+  if_live_out[F("sync")] = e131OutSyncUniverse;
+  if_live[F("pace")] = realtimeOutPacing;
 
   if_live[F("timeout")] = realtimeTimeoutMs / 100;
   if_live[F("maxbri")] = arlsForceMaxBri;
   if_live[F("no-gc")] = arlsDisableGammaCorrection;
   if_live[F("offset")] = arlsOffset;
+  if_live[F("rxpkt")] = udpRxMaxPackets;
+  if_live[F("rxms")] = udpRxBudgetMs;
+  if_live[F("stats")] = realtimeStats;
 
 #ifndef WLED_DISABLE_ALEXA
   JsonObject if_va = interfaces.createNestedObject("va");
@@ -1013,9 +1047,7 @@ void serializeConfig() {
   JsonObject usermods_settings = doc.createNestedObject("um");
   usermods.addToConfig(usermods_settings);
 
-  File f = WLED_FS.open("/cfg.json", "w");
-  if (f) serializeJson(doc, f);
-  f.close();
+  writeObjectToFileAtomic("/cfg.json", &doc);
   releaseJSONBufferLock();
 
   doSerializeConfig = false;
@@ -1096,8 +1128,6 @@ void serializeConfigSec() {
   ota[F("lock-wifi")] = wifiLock;
   ota[F("aota")] = aOtaEnabled;
 
-  File f = WLED_FS.open("/wsec.json", "w");
-  if (f) serializeJson(doc, f);
-  f.close();
+  writeObjectToFileAtomic("/wsec.json", &doc);
   releaseJSONBufferLock();
 }
@@ -0,0 +1,219 @@
+#include "wled.h"
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_timer.h>
+#endif
+
+/*
+ * Effect timebase synchronisation between WLED nodes
+ * A node that follows another node's effect notifications polls that node over the notifier socket
+ * (NTP style request/reply), estimates clock offset and drift and slews strip.timebase towards the
+ * leader's effect time instead of jumping to the (network delay affected) value of every notification.
+ */
+
+#define CLOCKSYNC_PROTOCOL  14    // first byte of clock sync packets (older nodes ignore it)
+#define CLOCKSYNC_REQ_LEN   11    // protocol, type (0), seq, t1
+#define CLOCKSYNC_REPLY_LEN 31    // protocol, type (1), seq, t1, t2, t3, leader timebase
+#define CLOCKSYNC_FAST_POLL 250   // ms, poll interval until locked
+#define CLOCKSYNC_POLL      1000  // ms
+#define CLOCKSYNC_TIMEOUT   10000 // ms without reply before the leader is dropped
+#define CLOCKSYNC_RETRY     600000 // ms before a dropped leader is polled again (it may have been updated)
+#define CLOCKSYNC_SAMPLES   8     // clock filter window, the sample with the shortest round trip is used
+#define CLOCKSYNC_MAX_PPM   500
+#define CLOCKSYNC_LOCK_ERR  2000  // us, mean residual below which the timebase is tracked
+#define CLOCKSYNC_STEP      250   // ms, larger timebase errors are corrected at once
+#define CLOCKSYNC_SLEW      20    // ms between 1 ms timebase corrections (5% rate change)
+
+typedef struct ClockSyncSample {
+  int64_t  offset;  // leader clock - local clock (us)
+  uint32_t delay;   // round trip (us)
+  uint64_t at;      // local clock at reception
+} clocksyncsample_t;
+
+static IPAddress     csLeader;                 // node whose effect time is followed (0.0.0.0 = none)
+static IPAddress     csDropped;                // last leader that did not reply
+static unsigned long csDroppedAt = 0;
+static uint8_t       csSeq = 0;
+static uint64_t      csSent = 0;               // local clock of pending request (0 = none)
+static unsigned long csLastPoll = 0;
+static unsigned long csLastReply = 0;
+static unsigned long csLastSlew = 0;
+static clocksyncsample_t csSamples[CLOCKSYNC_SAMPLES];
+static uint8_t       csSampleCount = 0;
+static uint8_t       csSampleIdx = 0;
+static int64_t       csOffset = 0;             // filtered offset at csRefTime (us)
+static uint64_t      csRefTime = 0;
+static float         csDrift = 0.0f;           // leader clock rate relative to ours (ppm)
+static uint32_t      csError = 0;              // mean absolute residual (us)
+static uint32_t      csDelay = 0;              // round trip of last used sample (us)
+static uint16_t      csUpdates = 0;
+static uint32_t      csLeaderTimebase = 0;
+
+static inline uint64_t clockMicros()
+{
+  #ifdef ESP8266
+  return micros64();
+  #else
+  return esp_timer_get_time();
+  #endif
+}
+
+static void put64(uint8_t *buf, uint64_t v) { for (size_t i = 0; i < 8; i++) buf[i] = v >> (8*i); }
+static uint64_t get64(const uint8_t *buf)   { uint64_t v = 0; for (size_t i = 0; i < 8; i++) v |= (uint64_t)buf[i] << (8*i); return v; }
+
+static void resetClockSync()
+{
+  csSent = 0;
+  csSampleCount = csSampleIdx = 0;
+  csUpdates = 0;
+  csDrift = 0.0f;
+  csError = csDelay = 0;
+}
+
+static bool clockSyncLocked()
+{
+  return csUpdates >= 4 && csError < CLOCKSYNC_LOCK_ERR;
+}
+
+// predicted leader - local clock offset at local time t
+static int64_t clockSyncOffset(uint64_t t)
+{
+  return csOffset + (int64_t)(csDrift * (float)(int64_t)(t - csRefTime) / 1e6f);
+}
+
+// simple PLL: phase gain 1/2, frequency gain 1/8
+static void clockSyncUpdate(const clocksyncsample_t &s)
+{
+  if (!csUpdates) {
+    csOffset = s.offset;
+    csRefTime = s.at;
+    csError = s.delay / 2;
+    csDelay = s.delay;
+    csUpdates = 1;
+    return;
+  }
+  int64_t dt = s.at - csRefTime;
+  if (dt <= 0) return;
+  int64_t residual = s.offset - clockSyncOffset(s.at);
+  csOffset = clockSyncOffset(s.at) + residual / 2;
+  csDrift += ((float)residual * 1e6f / (float)dt) / 8.0f;
+  csDrift = constrain(csDrift, -CLOCKSYNC_MAX_PPM, CLOCKSYNC_MAX_PPM);
+  csRefTime = s.at;
+  int64_t absResidual = llabs(residual);
+  if (absResidual > UINT32_MAX / 4) absResidual = UINT32_MAX / 4;
+  csError = (csError * 3 + (uint32_t)absResidual) / 4;
+  csDelay = s.delay;
+  if (csUpdates < UINT16_MAX) csUpdates++;
+}
+
+// register ip as source of the effect timebase, returns true if the timebase is tracked by clock sync
+// (notification receivers must then not overwrite strip.timebase)
+bool clockSyncFollow(IPAddress ip)
+{
+  if (!clockSyncEnabled) return false;
+  if (ip == csDropped && millis() - csDroppedAt < CLOCKSYNC_RETRY) return false; // no clock sync support, use its notifications
+  if (!(ip == csLeader)) {
+    csLeader = ip;
+    resetClockSync();
+    csLastReply = millis();
+    csLastPoll = 0;
+  }
+  return clockSyncLocked();
+}
+
+// returns true if the packet was a clock sync packet
+bool handleClockSyncPacket(const uint8_t *buf, size_t len, IPAddress ip)
+{
+  if (len < CLOCKSYNC_REQ_LEN || buf[0] != CLOCKSYNC_PROTOCOL) return false;
+  uint64_t now = clockMicros();
+
+  if (buf[1] == 0) { // request: return receive and transmit time together with our timebase
+    uint8_t out[CLOCKSYNC_REPLY_LEN];
+    out[0] = CLOCKSYNC_PROTOCOL;
+    out[1] = 1;
+    out[2] = buf[2];
+    memcpy(out + 3, buf + 3, 8);
+    put64(out + 11, now);
+    for (size_t i = 0; i < 4; i++) out[27+i] = strip.timebase >> (8*i);
+    put64(out + 19, clockMicros());
+    notifierUdp.beginPacket(ip, udpPort);
+    notifierUdp.write(out, CLOCKSYNC_REPLY_LEN);
+    notifierUdp.endPacket();
+    return true;
+  }
+
+  if (buf[1] != 1 || len < CLOCKSYNC_REPLY_LEN || !(ip == csLeader) || !csSent || buf[2] != csSeq) return true;
+  uint64_t t1 = get64(buf + 3), t2 = get64(buf + 11), t3 = get64(buf + 19);
+  if (t1 != csSent) return true;
+  csSent = 0;
+  csLastReply = millis();
+  csLeaderTimebase = buf[27] | (buf[28] << 8) | (buf[29] << 16) | ((uint32_t)buf[30] << 24);
+
+  int64_t rtt = (int64_t)(now - t1) - (int64_t)(t3 - t2);
+  clocksyncsample_t &s = csSamples[csSampleIdx];
+  s.offset = ((int64_t)(t2 - t1) + (int64_t)(t3 - now)) / 2;
+  s.delay  = rtt < 0 ? 0 : rtt;
+  s.at     = now;
+  csSampleIdx = (csSampleIdx + 1) % CLOCKSYNC_SAMPLES;
+  if (csSampleCount < CLOCKSYNC_SAMPLES) csSampleCount++;
+
+  // clock filter: use the sample with the shortest round trip, each sample only once
+  const clocksyncsample_t *best = &s;
+  for (size_t i = 0; i < csSampleCount; i++) if (csSamples[i].delay < best->delay) best = &csSamples[i];
+  if (best->at > csRefTime || !csUpdates) clockSyncUpdate(*best);
+  return true;
+}
+
+// called once per loop(): polls the leader and slews strip.timebase
+void handleClockSync()
+{
+  if (!clockSyncEnabled || !udpConnected || !uint32_t(csLeader)) return;
+
+  if (millis() - csLastReply > CLOCKSYNC_TIMEOUT) { // leader gone (or an older version)
+    csDropped = csLeader;
+    csDroppedAt = millis();
+    csLeader = IPAddress();
+    resetClockSync();
+    return;
+  }
+
+  if (millis() - csLastPoll > (clockSyncLocked() ? CLOCKSYNC_POLL : CLOCKSYNC_FAST_POLL)) {
+    uint8_t out[CLOCKSYNC_REQ_LEN];
+    out[0] = CLOCKSYNC_PROTOCOL;
+    out[1] = 0;
+    out[2] = ++csSeq;
+    csSent = clockMicros();
+    put64(out + 3, csSent);
+    notifierUdp.beginPacket(csLeader, udpPort);
+    notifierUdp.write(out, CLOCKSYNC_REQ_LEN);
+    notifierUdp.endPacket();
+    csLastPoll = millis();
+  }
+
+  if (!clockSyncLocked()) return;
+  int64_t offset = clockSyncOffset(clockMicros());
+  int64_t offsetMs = offset >= 0 ? (offset + 500) / 1000 : -((-offset + 500) / 1000);
+  uint32_t target = csLeaderTimebase + (uint32_t)offsetMs; // millis() + timebase equals the leader's millis() + timebase
+  int32_t diff = target - strip.timebase;
+  if (abs(diff) > CLOCKSYNC_STEP) strip.timebase = target;
+  else if (diff && millis() - csLastSlew >= CLOCKSYNC_SLEW) {
+    strip.timebase += diff > 0 ? 1 : -1;
+    csLastSlew = millis();
+  }
+}
+
+// info.tsync: {"src":leader,"lock":tracked,"err":mean residual (us),"rtt":round trip (us),"ppm":drift,"tbe":timebase error (ms)}
+void serializeClockSync(JsonObject root)
+{
+  if (!clockSyncEnabled || !uint32_t(csLeader)) return;
+  JsonObject ts = root.createNestedObject(F("tsync"));
+  ts[F("src")]  = csLeader.toString();
+  ts[F("lock")] = clockSyncLocked();
+  ts[F("err")]  = csError;
+  ts[F("rtt")]  = csDelay;
+  ts[F("ppm")]  = roundf(csDrift * 10.0f) / 10.0f;
+  if (clockSyncLocked()) {
+    int64_t offset = clockSyncOffset(clockMicros());
+    uint32_t target = csLeaderTimebase + (uint32_t)(offset / 1000);
+    ts[F("tbe")] = (int32_t)(target - strip.timebase);
+  }
+}
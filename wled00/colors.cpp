@@ -4,6 +4,15 @@
  * Color conversion & utility methods
  */
 
+/*
+ * Color kernels below operate on two channels per 32 bit word (SWAR): R & B in one word
+ * (mask 0x00FF00FF), W & G in the other. Each channel gets 16 bits of headroom so products
+ * with an 8 bit factor never carry into the neighbouring channel. Results are bit-exact with
+ * the per-channel math they replace.
+ */
+#define RB_MASK 0x00FF00FFU
+#define WG_MASK 0xFF00FF00U
+
 /*
  * color blend function
  */
@@ -11,24 +20,23 @@ uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16)
   if(blend == 0)   return color1;
   uint16_t blendmax = b16 ? 0xFFFF : 0xFF;
   if(blend == blendmax) return color2;
-  uint8_t shift = b16 ? 16 : 8;
-
-  uint32_t w1 = W(color1);
-  uint32_t r1 = R(color1);
-  uint32_t g1 = G(color1);
-  uint32_t b1 = B(color1);
-
-  uint32_t w2 = W(color2);
-  uint32_t r2 = R(color2);
-  uint32_t g2 = G(color2);
-  uint32_t b2 = B(color2);
-
-  uint32_t w3 = ((w2 * blend) + (w1 * (blendmax - blend))) >> shift;
-  uint32_t r3 = ((r2 * blend) + (r1 * (blendmax - blend))) >> shift;
-  uint32_t g3 = ((g2 * blend) + (g1 * (blendmax - blend))) >> shift;
-  uint32_t b3 = ((b2 * blend) + (b1 * (blendmax - blend))) >> shift;
 
-  return RGBW32(r3, g3, b3, w3);
+  if (!b16) {
+    // (c2 * blend + c1 * (255 - blend)) >> 8, max 255*255 per channel fits 16 bits
+    uint32_t invBlend = blendmax - blend;
+    uint32_t rb = (((color2 & RB_MASK) * blend) + ((color1 & RB_MASK) * invBlend)) >> 8;
+    uint32_t wg = ((((color2 >> 8) & RB_MASK) * blend) + (((color1 >> 8) & RB_MASK) * invBlend));
+    return (rb & RB_MASK) | (wg & WG_MASK);
+  }
+  // 16 bit blend needs 24 bits per channel, use two channels per 64 bit word
+  uint64_t invBlend = blendmax - blend;
+  uint64_t rb1 = (color1 & 0x000000FFU) | (uint64_t(color1 & 0x00FF0000U) << 16);
+  uint64_t wg1 = ((color1 >> 8) & 0x000000FFU) | (uint64_t((color1 >> 8) & 0x00FF0000U) << 16);
+  uint64_t rb2 = (color2 & 0x000000FFU) | (uint64_t(color2 & 0x00FF0000U) << 16);
+  uint64_t wg2 = ((color2 >> 8) & 0x000000FFU) | (uint64_t((color2 >> 8) & 0x00FF0000U) << 16);
+  uint64_t rb  = ((rb2 * blend) + (rb1 * invBlend)) >> 16;
+  uint64_t wg  = ((wg2 * blend) + (wg1 * invBlend)) >> 16;
+  return uint32_t((rb & 0xFF) | ((rb >> 16) & 0x00FF0000U)) | (uint32_t((wg & 0xFF) | ((wg >> 16) & 0x00FF0000U)) << 8);
 }
 
 /*
@@ -38,15 +46,12 @@ uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16)
 uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
 {
   if (fast) {
-    uint8_t r = R(c1);
-    uint8_t g = G(c1);
-    uint8_t b = B(c1);
-    uint8_t w = W(c1);
-    r = qadd8(r, R(c2));
-    g = qadd8(g, G(c2));
-    b = qadd8(b, B(c2));
-    w = qadd8(w, W(c2));
-    return RGBW32(r,g,b,w);
+    // saturating add (qadd8), overflow of a channel lands in bit 8 of its 16 bit lane
+    uint32_t rb = (c1 & RB_MASK) + (c2 & RB_MASK);
+    uint32_t wg = ((c1 >> 8) & RB_MASK) + ((c2 >> 8) & RB_MASK);
+    rb |= ((rb & 0x01000100U) - ((rb & 0x01000100U) >> 8)); // saturate overflown channels to 0xFF
+    wg |= ((wg & 0x01000100U) - ((wg & 0x01000100U) >> 8));
+    return (rb & RB_MASK) | ((wg & RB_MASK) << 8);
   } else {
     uint32_t r = R(c1) + R(c2);
     uint32_t g = G(c1) + G(c2);
@@ -67,22 +72,252 @@ uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
  */
 uint32_t color_fade(uint32_t c1, uint8_t amount, bool video)
 {
-  uint8_t r = R(c1);
-  uint8_t g = G(c1);
-  uint8_t b = B(c1);
-  uint8_t w = W(c1);
+  uint32_t rb = c1 & RB_MASK;
+  uint32_t wg = (c1 >> 8) & RB_MASK;
   if (video) {
-    r = scale8_video(r, amount);
-    g = scale8_video(g, amount);
-    b = scale8_video(b, amount);
-    w = scale8_video(w, amount);
+    // scale8_video(): (i * scale) >> 8, +1 if neither i nor scale are 0
+    uint32_t rbNZ = amount ? ((rb + RB_MASK) >> 8) & 0x00010001U : 0; // 1 in every non-zero channel
+    uint32_t wgNZ = amount ? ((wg + RB_MASK) >> 8) & 0x00010001U : 0;
+    rb = (((rb * amount) >> 8) & RB_MASK) + rbNZ;
+    wg = (((wg * amount) >> 8) & RB_MASK) + wgNZ;
   } else {
-    r = scale8(r, amount);
-    g = scale8(g, amount);
-    b = scale8(b, amount);
-    w = scale8(w, amount);
+    // scale8()
+    #if FASTLED_SCALE8_FIXED == 1
+    uint32_t scale = uint32_t(amount) + 1;
+    #else
+    uint32_t scale = amount;
+    #endif
+    rb = ((rb * scale) >> 8) & RB_MASK;
+    wg = ((wg * scale) >> 8) & RB_MASK;
   }
-  return RGBW32(r, g, b, w);
+  return rb | (wg << 8);
+}
+
+/*
+ * ESP32-S3 PIE (SIMD) block versions of the span kernels, 4 pixels per 128 bit register
+ * Same split as above: R & B (x & 0x00FF00FF) and W & G (x >> 8) in 16 bit lanes. Shifts are done by
+ * EE.VMUL.U16 (lane product >> SAR), so no lane ever carries into its neighbour; PIE has no unsigned
+ * saturating add, sums stay below 0x8000 and are clamped with EE.VMIN.S16. 16 bit blends stay scalar.
+ * blocks is the number of 4 pixel blocks, pointers must be 16 byte aligned.
+ */
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && defined(WLED_USE_PIE)
+#define WLED_PIE_SPANS
+
+static const uint32_t pieMask = RB_MASK;     // 0xFF in every lane
+static const uint32_t pieOne  = 0x00010001U; // 1 in every lane
+static const uint32_t pie256  = 0x01000100U; // 256 in every lane
+
+static void pieFadeBlocks(uint32_t *c, unsigned blocks, uint32_t scale, bool video)
+{
+  const uint32_t lanes = scale | (scale << 16);
+  if (!video) asm volatile (
+    "ee.vldbc.32   q7, %[mask]      \n"
+    "ee.vldbc.32   q6, %[scale]     \n"
+    "ee.vldbc.32   q5, %[one]       \n"
+    "ee.vldbc.32   q4, %[c256]      \n"
+    "loopnez       %[n], 1f         \n"
+    "ee.vld.128.ip q0, %[c], 0      \n"
+    "ssai          8                \n"
+    "ee.andq       q1, q0, q7       \n" // R, B
+    "ee.vmul.u16   q2, q0, q5       \n" // W, G
+    "ee.vmul.u16   q1, q1, q6       \n" // scale8()
+    "ee.vmul.u16   q2, q2, q6       \n"
+    "ssai          0                \n"
+    "ee.vmul.u16   q2, q2, q4       \n" // W, G back to the high byte
+    "ee.orq        q0, q1, q2       \n"
+    "ee.vst.128.ip q0, %[c], 16     \n"
+    "1:                             \n"
+    : [c] "+r" (c)
+    : [n] "r" (blocks), [mask] "r" (&pieMask), [scale] "r" (&lanes), [one] "r" (&pieOne), [c256] "r" (&pie256)
+    : "sar", "memory"
+  );
+  else asm volatile ( // scale8_video(): +1 in every lane that was not 0
+    "ee.vldbc.32   q7, %[mask]      \n"
+    "ee.vldbc.32   q6, %[scale]     \n"
+    "ee.vldbc.32   q5, %[one]       \n"
+    "ee.zero.q     q3               \n"
+    "loopnez       %[n], 1f         \n"
+    "ee.vld.128.ip q0, %[c], 0      \n"
+    "ssai          8                \n"
+    "ee.andq       q1, q0, q7       \n" // R, B
+    "ee.vmul.u16   q2, q0, q5       \n" // W, G
+    "ee.vcmp.eq.s16 q0, q1, q3      \n" // -1 in zero lanes
+    "ee.vmul.u16   q1, q1, q6       \n"
+    "ee.vadds.s16  q1, q1, q5       \n"
+    "ee.vadds.s16  q1, q1, q0       \n"
+    "ee.vcmp.eq.s16 q0, q2, q3      \n"
+    "ee.vmul.u16   q2, q2, q6       \n"
+    "ee.vadds.s16  q2, q2, q5       \n"
+    "ee.vadds.s16  q2, q2, q0       \n"
+    "ssai          0                \n"
+    "ee.vldbc.32   q0, %[c256]      \n"
+    "ee.vmul.u16   q2, q2, q0       \n"
+    "ee.orq        q0, q1, q2       \n"
+    "ee.vst.128.ip q0, %[c], 16     \n"
+    "1:                             \n"
+    : [c] "+r" (c)
+    : [n] "r" (blocks), [mask] "r" (&pieMask), [scale] "r" (&lanes), [one] "r" (&pieOne), [c256] "r" (&pie256)
+    : "sar", "memory"
+  );
+}
+
+// (c2 * blend + c1 * (255 - blend)) >> 8 as ((p >> 1) + (q >> 1)) >> 7 so lane sums stay below 0x8000
+// (exact: blend and 255 - blend differ in parity, one of the products is even)
+static void pieBlendBlocks(uint32_t *dst, const uint32_t *src, unsigned blocks, uint8_t blend)
+{
+  const uint32_t b = blend | (blend << 16), ib = (255 - blend) | ((255 - blend) << 16);
+  asm volatile (
+    "ee.vldbc.32   q7, %[mask]      \n"
+    "ee.vldbc.32   q6, %[b]         \n"
+    "ee.vldbc.32   q5, %[one]       \n"
+    "ee.vldbc.32   q4, %[ib]        \n"
+    "loopnez       %[n], 1f         \n"
+    "ee.vld.128.ip q0, %[d], 0      \n" // R, B
+    "ee.vld.128.ip q1, %[s], 0      \n"
+    "ee.andq       q0, q0, q7       \n"
+    "ee.andq       q1, q1, q7       \n"
+    "ssai          0                \n"
+    "ee.vmul.u16   q0, q0, q4       \n"
+    "ee.vmul.u16   q1, q1, q6       \n"
+    "ssai          1                \n"
+    "ee.vmul.u16   q0, q0, q5       \n"
+    "ee.vmul.u16   q1, q1, q5       \n"
+    "ee.vadds.s16  q0, q0, q1       \n"
+    "ssai          7                \n"
+    "ee.vmul.u16   q3, q0, q5       \n"
+    "ee.vld.128.ip q0, %[d], 0      \n" // W, G
+    "ee.vld.128.ip q1, %[s], 16     \n"
+    "ssai          8                \n"
+    "ee.vmul.u16   q0, q0, q5       \n"
+    "ee.vmul.u16   q1, q1, q5       \n"
+    "ssai          0                \n"
+    "ee.vmul.u16   q0, q0, q4       \n"
+    "ee.vmul.u16   q1, q1, q6       \n"
+    "ssai          1                \n"
+    "ee.vmul.u16   q0, q0, q5       \n"
+    "ee.vmul.u16   q1, q1, q5       \n"
+    "ee.vadds.s16  q0, q0, q1       \n"
+    "ssai          7                \n"
+    "ee.vmul.u16   q0, q0, q5       \n"
+    "ssai          0                \n"
+    "ee.vldbc.32   q1, %[c256]      \n"
+    "ee.vmul.u16   q0, q0, q1       \n"
+    "ee.orq        q0, q0, q3       \n"
+    "ee.vst.128.ip q0, %[d], 16     \n"
+    "1:                             \n"
+    : [d] "+r" (dst), [s] "+r" (src)
+    : [n] "r" (blocks), [mask] "r" (&pieMask), [b] "r" (&b), [ib] "r" (&ib), [one] "r" (&pieOne), [c256] "r" (&pie256)
+    : "sar", "memory"
+  );
+}
+
+// qadd8() per channel: lane sums are at most 0x1FE
+static void pieAddBlocks(uint32_t *dst, const uint32_t *src, unsigned blocks)
+{
+  asm volatile (
+    "ee.vldbc.32   q7, %[mask]      \n"
+    "ee.vldbc.32   q5, %[one]       \n"
+    "ee.vldbc.32   q4, %[c256]      \n"
+    "loopnez       %[n], 1f         \n"
+    "ee.vld.128.ip q0, %[d], 0      \n"
+    "ee.vld.128.ip q1, %[s], 16     \n"
+    "ssai          8                \n"
+    "ee.vmul.u16   q2, q0, q5       \n" // W, G
+    "ee.vmul.u16   q3, q1, q5       \n"
+    "ee.andq       q0, q0, q7       \n" // R, B
+    "ee.andq       q1, q1, q7       \n"
+    "ee.vadds.s16  q0, q0, q1       \n"
+    "ee.vadds.s16  q2, q2, q3       \n"
+    "ee.vmin.s16   q0, q0, q7       \n"
+    "ee.vmin.s16   q2, q2, q7       \n"
+    "ssai          0                \n"
+    "ee.vmul.u16   q2, q2, q4       \n"
+    "ee.orq        q0, q0, q2       \n"
+    "ee.vst.128.ip q0, %[d], 16     \n"
+    "1:                             \n"
+    : [d] "+r" (dst), [s] "+r" (src)
+    : [n] "r" (blocks), [mask] "r" (&pieMask), [one] "r" (&pieOne), [c256] "r" (&pie256)
+    : "sar", "memory"
+  );
+}
+
+// 16 byte aligned part of a span (dst and src equally aligned), the scalar kernels do the rest
+#define PIE_HEAD(p, n) MIN((unsigned)(((16 - ((uintptr_t)(p) & 15)) & 15) / 4), (n))
+#endif
+
+/*
+ * span versions of the above, operating in place on whole pixel buffers
+ */
+void color_fade_span(uint32_t *c, unsigned n, uint8_t amount, bool video)
+{
+  #if FASTLED_SCALE8_FIXED == 1
+  if (amount == 255) return; // both scale8() and scale8_video() leave colors unchanged
+  #endif
+  unsigned i = 0;
+  #ifdef WLED_PIE_SPANS
+  for (unsigned head = PIE_HEAD(c, n); i < head; i++) c[i] = color_fade(c[i], amount, video);
+  if (n - i >= 4) {
+    #if FASTLED_SCALE8_FIXED == 1
+    uint32_t scale = video ? amount : amount + 1;
+    #else
+    uint32_t scale = amount;
+    #endif
+    pieFadeBlocks(c + i, (n - i) / 4, scale, video && amount);
+    i += (n - i) & ~3U;
+  }
+  #endif
+  for (; i < n; i++) c[i] = color_fade(c[i], amount, video);
+}
+
+void color_blend_span(uint32_t *dst, const uint32_t *src, unsigned n, uint16_t blend, bool b16)
+{
+  if (blend == 0) return;
+  if (blend == (b16 ? 0xFFFF : 0xFF)) { memcpy(dst, src, n * sizeof(uint32_t)); return; }
+  unsigned i = 0;
+  #ifdef WLED_PIE_SPANS
+  if (!b16 && !(((uintptr_t)dst ^ (uintptr_t)src) & 15)) {
+    for (unsigned head = PIE_HEAD(dst, n); i < head; i++) dst[i] = color_blend(dst[i], src[i], blend, false);
+    if (n - i >= 4) {
+      pieBlendBlocks(dst + i, src + i, (n - i) / 4, blend);
+      i += (n - i) & ~3U;
+    }
+  }
+  #endif
+  for (; i < n; i++) dst[i] = color_blend(dst[i], src[i], blend, b16);
+}
+
+void color_add_span(uint32_t *dst, const uint32_t *src, unsigned n, bool fast)
+{
+  unsigned i = 0;
+  #ifdef WLED_PIE_SPANS
+  if (fast && !(((uintptr_t)dst ^ (uintptr_t)src) & 15)) {
+    for (unsigned head = PIE_HEAD(dst, n); i < head; i++) dst[i] = color_add(dst[i], src[i], true);
+    if (n - i >= 4) {
+      pieAddBlocks(dst + i, src + i, (n - i) / 4);
+      i += (n - i) & ~3U;
+    }
+  }
+  #endif
+  for (; i < n; i++) dst[i] = color_add(dst[i], src[i], fast);
+}
+
+/*
+ * copies raw channel bytes applying scale8() to each, four channels at a time
+ * (dst/src need not be aligned, word access is done through memcpy())
+ */
+void scale8_copy(uint8_t *dst, const uint8_t *src, size_t len, uint8_t scale)
+{
+  #if FASTLED_SCALE8_FIXED == 1
+  if (scale == 255) { memcpy(dst, src, len); return; }
+  #endif
+  size_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    uint32_t w;
+    memcpy(&w, src + i, 4);
+    w = color_fade(w, scale);
+    memcpy(dst + i, &w, 4);
+  }
+  for (; i < len; i++) dst[i] = scale8(src[i], scale);
 }
 
 void setRandomColor(byte* rgb)
@@ -254,7 +254,7 @@
 #define TYPE_LPD6803             54
 //Network types (master broadcast) (80-95)
 #define TYPE_NET_DDP_RGB         80            //network DDP RGB bus (master broadcast bus)
-#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus, unused)
+#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGB      82            //network ArtNet RGB bus (master broadcast bus, unused)
 #define TYPE_NET_DDP_RGBW        88            //network DDP RGBW bus (master broadcast bus)
 
@@ -449,6 +449,17 @@
   #define JSON_BUFFER_SIZE 24576
 #endif
 
+// JSON documents available to web requests (first one is the global doc), see acquireJSONArena()
+#ifndef WLED_JSON_ARENAS
+  #if defined(ESP8266)
+    #define WLED_JSON_ARENAS 1
+  #elif defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
+    #define WLED_JSON_ARENAS 4
+  #else
+    #define WLED_JSON_ARENAS 2
+  #endif
+#endif
+
 //#define MIN_HEAP_SIZE (8k for AsyncWebServer)
 #define MIN_HEAP_SIZE 8192
 
@@ -3,11 +3,168 @@
 #define MAX_3_CH_LEDS_PER_UNIVERSE 170
 #define MAX_4_CH_LEDS_PER_UNIVERSE 128
 #define MAX_CHANNELS_PER_UNIVERSE 512
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008 // root vector of synchronization (and discovery) packets
 
 /*
  * E1.31 handler
  */
 
+/*
+ * Multi-universe frame assembly
+ * Universes of a frame are copied into a back buffer by the UDP task (async_udp on ESP32) and the frame
+ * is flipped once it is complete: on E1.31 synchronization / ArtSync packet if the sender used them
+ * within the last 4s, when all expected universes have arrived otherwise, or after realtimeFrameTimeout
+ * if a universe is missing. In multicast mode the group of the synchronization universe is joined. loop() writes the flipped frame to the strip and shows it (handleE131Frame()), so universes
+ * of the next frame never change the strip while a frame waits to be shown.
+ * Three buffers: back (UDP task), ready (flipped, not taken by loop() yet) and shown (loop() only).
+ * A ready frame replaced by a newer one before loop() took it is counted as skipped.
+ */
+typedef struct E131Frame {
+  uint8_t  *data;                             // frameLeds LEDs, channels bytes each
+  uint32_t universes;                         // bit mask of universes in data
+  uint16_t start[E131_MAX_UNIVERSE_COUNT];    // first LED of universe
+  uint16_t count[E131_MAX_UNIVERSE_COUNT];    // LEDs of universe
+  uint8_t  channels;                          // 3 (RGB) or 4 (RGBW)
+  uint8_t  mode;                              // protocol (for statistics)
+} e131frame_t;
+
+static e131frame_t   frames[3];
+static e131frame_t  *frameBack       = &frames[0];
+static e131frame_t  *frameReady      = &frames[1];
+static e131frame_t  *frameShown      = &frames[2];
+static bool          frameReadyValid = false;
+static uint16_t      frameLeds       = 0;     // LEDs the frame buffers hold (allocated by loop())
+static uint16_t      frameLedsWanted = 0;     // LEDs requested by the UDP task
+static uint32_t      frameExpected   = 0;     // bit mask of universes that make up a complete frame
+static unsigned long frameStart      = 0;     // millis() when first universe of the frame arrived
+static uint16_t      frameSyncAddr   = 0;     // E1.31 synchronization universe announced in data packets (0 = none)
+static uint16_t      frameSyncJoined = 0;     // synchronization universe whose multicast group was joined
+static unsigned long lastFrameSync   = 0;     // millis() of last E1.31 synchronization or ArtSync packet (0 = never)
+
+// frame state is changed by the UDP task and loop(), buffers are (re)allocated outside the critical section
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE e131FrameMux = portMUX_INITIALIZER_UNLOCKED;
+#define E131_FRAME_LOCK()   portENTER_CRITICAL(&e131FrameMux)
+#define E131_FRAME_UNLOCK() portEXIT_CRITICAL(&e131FrameMux)
+#else
+#define E131_FRAME_LOCK()   noInterrupts()
+#define E131_FRAME_UNLOCK() interrupts()
+#endif
+
+// call with E131_FRAME_LOCK() held, returns protocol of the flipped frame (0 = nothing to flip)
+static uint8_t e131FrameFlip() {
+  if (!frameBack->universes) return 0;
+  if ((frameBack->universes & frameExpected) == frameExpected) realtimeFramesComplete++;
+  else                                                         realtimeFramesIncomplete++;
+  if (frameReadyValid) realtimeFramesSkipped++;
+  e131frame_t *f = frameReady;
+  frameReady = frameBack;
+  frameBack = f;
+  frameBack->universes = 0;
+  frameReadyValid = true;
+  return frameReady->mode;
+}
+
+static void e131FrameSync() {
+  E131_FRAME_LOCK();
+  lastFrameSync = millis();
+  if (!lastFrameSync) lastFrameSync++;
+  uint8_t flipped = e131FrameFlip();
+  E131_FRAME_UNLOCK();
+  if (flipped) rtStatsFrame(flipped);
+}
+
+static void e131FrameAdd(uint8_t universeIndex, uint8_t universeCount, uint8_t mode, uint16_t start, uint16_t leds, const uint8_t *data, uint8_t channels) {
+  const uint32_t bit = 1UL << universeIndex;
+  const uint16_t totalLen = strip.getLengthTotal();
+  uint8_t flipped = 0;
+  E131_FRAME_LOCK();
+  if (frameLeds != totalLen) { // no buffer (yet) for this strip length, the frame is dropped
+    frameLedsWanted = totalLen;
+    E131_FRAME_UNLOCK();
+    return;
+  }
+  frameExpected = (universeCount >= 32) ? UINT32_MAX : (1UL << universeCount) - 1;
+  if (frameBack->universes & bit) { // universe of next frame arrived before current one was complete
+    realtimeFramesTorn++;
+    flipped = e131FrameFlip();
+  }
+  if (frameBack->universes && frameBack->channels != channels) frameBack->universes = 0; // DMX mode changed
+  if (!frameBack->universes) {
+    frameStart = millis();
+    frameBack->channels = channels;
+  }
+  frameBack->mode = mode;
+  memcpy(frameBack->data + start * channels, data, leds * channels);
+  frameBack->start[universeIndex] = start;
+  frameBack->count[universeIndex] = leds;
+  frameBack->universes |= bit;
+  const bool synced = lastFrameSync && millis() - lastFrameSync < 4000; // sync packets may get lost, e.g. not routed
+  if (!synced && (frameBack->universes & frameExpected) == frameExpected) flipped = e131FrameFlip();
+  E131_FRAME_UNLOCK();
+  if (flipped) rtStatsFrame(flipped);
+}
+
+// called from loop(): (re)allocates the frame buffers
+static void e131FrameAlloc(uint16_t leds) {
+  uint8_t *buf[3] = {nullptr, nullptr, nullptr};
+  for (unsigned i = 0; leds && i < 3; i++) {
+    buf[i] = (uint8_t*) malloc(leds * 4);
+    if (!buf[i]) {
+      DEBUG_PRINTLN(F("E1.31 frame buffer allocation failed"));
+      for (unsigned k = 0; k < i; k++) free(buf[k]);
+      buf[0] = buf[1] = buf[2] = nullptr;
+      leds = 0;
+    }
+  }
+  E131_FRAME_LOCK();
+  for (unsigned i = 0; i < 3; i++) {
+    uint8_t *old = frames[i].data;
+    frames[i].data = buf[i];
+    frames[i].universes = 0;
+    buf[i] = old;
+  }
+  frameReadyValid = false;
+  frameLeds = frameLedsWanted = leds;
+  E131_FRAME_UNLOCK();
+  for (unsigned i = 0; i < 3; i++) free(buf[i]);
+}
+
+// called from loop(): flips a frame with missing universes after timeout, writes the ready frame to the strip and shows it
+void handleE131Frame() {
+  E131_FRAME_LOCK();
+  uint16_t wanted = realtimeMode ? frameLedsWanted : 0; // buffers are freed once realtime mode ends
+  uint16_t syncAddr = frameSyncAddr;
+  E131_FRAME_UNLOCK();
+  if (syncAddr != frameSyncJoined) {
+    e131.setSyncUniverse(syncAddr);
+    frameSyncJoined = syncAddr;
+  }
+  if (wanted != frameLeds) e131FrameAlloc(wanted);
+  if (!frameLeds) return;
+
+  uint8_t flipped = 0;
+  bool show = false;
+  E131_FRAME_LOCK();
+  if (frameBack->universes && millis() - frameStart > realtimeFrameTimeout) flipped = e131FrameFlip();
+  if (frameReadyValid && millis() - strip.getLastShow() > 15) {
+    e131frame_t *f = frameShown;
+    frameShown = frameReady;
+    frameReady = f;
+    frameReadyValid = false;
+    show = true;
+  }
+  E131_FRAME_UNLOCK();
+  if (flipped) rtStatsFrame(flipped);
+  if (!show) return;
+
+  const e131frame_t &f = *frameShown;
+  for (unsigned u = 0; u < E131_MAX_UNIVERSE_COUNT; u++) {
+    if ((f.universes & (1UL << u)) && f.count[u]) setRealtimePixels(f.start[u], f.data + f.start[u] * f.channels, f.count[u], f.channels);
+  }
+  strip.show();
+}
+
 //DDP protocol support, called by handleE131Packet
 //handles RGB data only
 void handleDDPPacket(e131_packet_t* p) {
@@ -18,9 +175,9 @@ void handleDDPPacket(e131_packet_t* p) {
     int sn = p->sequenceNum & 0xF;
     if (sn) {
       if (lastPushSeq > 5) {
-        if (sn > (lastPushSeq -5) && sn < lastPushSeq) return;
+        if (sn > (lastPushSeq -5) && sn < lastPushSeq) { rtStatsDrop(REALTIME_MODE_DDP, true); return; }
       } else {
-        if (sn > (10 + lastPushSeq) || sn < lastPushSeq) return;
+        if (sn > (10 + lastPushSeq) || sn < lastPushSeq) { rtStatsDrop(REALTIME_MODE_DDP, true); return; }
       }
     }
   }
@@ -35,17 +192,16 @@ void handleDDPPacket(e131_packet_t* p) {
   if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
 
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
+  rtStatsPacket(REALTIME_MODE_DDP);
 
   if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
-    for (uint16_t i = start; i < stop; i++) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
-      c += ddpChannelsPerLed;
-    }
+    if (stop > start) setRealtimePixels(start, data + c, stop - start, ddpChannelsPerLed);
   }
 
   bool push = p->flags & DDP_PUSH_FLAG;
   if (push) {
     e131NewData = true;
+    rtStatsFrame(REALTIME_MODE_DDP);
     byte sn = p->sequenceNum & 0xF;
     if (sn) e131LastSequenceNumber[0] = sn;
   }
@@ -64,12 +220,22 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       handleArtnetPollReply(clientIP);
       return;
     }
+    if (p->art_opcode == ARTNET_OPCODE_OPSYNC) {
+      e131FrameSync();
+      return;
+    }
     uni = p->art_universe;
     dmxChannels = htons(p->art_length);
     e131_data = p->art_data;
     seq = p->art_sequence_number;
     mde = REALTIME_MODE_ARTNET;
   } else if (protocol == P_E131) {
+    if (htonl(p->root_vector) == E131_VECTOR_ROOT_EXTENDED) {
+      // synchronization packet: sequence (1 byte) and synchronization address follow frame vector
+      const uint8_t *raw = (const uint8_t*)p;
+      if (frameSyncAddr && ((raw[45] << 8) | raw[46]) == frameSyncAddr) e131FrameSync();
+      return;
+    }
     // Ignore PREVIEW data (E1.31: 6.2.6)
     if ((p->options & 0x80) != 0) return;
     dmxChannels = htons(p->property_value_count) - 1;
@@ -78,6 +244,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     uni = htons(p->universe);
     e131_data = p->property_values;
     seq = p->sequence_number;
+    frameSyncAddr = htons(p->reserved); // synchronization address (E1.31-2016)
     if (e131Priority != 0) {
       if (p->priority < e131Priority ) return;
       // track highest priority & skip all lower priorities
@@ -113,9 +280,11 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       DEBUG_PRINT(F(", universe="));
       DEBUG_PRINT(uni);
       DEBUG_PRINTLN(")");
+      rtStatsDrop(mde, false);
       return;
     }
   e131LastSequenceNumber[previousUniverses] = seq;
+  rtStatsPacket(mde);
 
   // update status info
   realtimeIP = clientIP;
@@ -268,6 +437,11 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
         const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
         uint8_t stripBrightness = bri;
         uint16_t previousLeds, dmxOffset, ledsTotal;
+        const uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
+        const uint16_t ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
+        unsigned universeCount = 1;
+        if (totalLen > ledsInFirstUniverse) universeCount += (totalLen - ledsInFirstUniverse + ledsPerUniverse - 1) / ledsPerUniverse;
+        if (universeCount > E131_MAX_UNIVERSE_COUNT) universeCount = E131_MAX_UNIVERSE_COUNT;
 
         if (previousUniverses == 0) {
           if (availDMXLen < 1) return;
@@ -283,8 +457,6 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
         } else {
           // All subsequent universes start at the first channel.
           dmxOffset = (protocol == P_ARTNET) ? 0 : 1;
-          const uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
-          uint16_t ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
           previousLeds = ledsInFirstUniverse + (previousUniverses - 1) * ledsPerUniverse;
           ledsTotal = previousLeds + (dmxChannels / dmxChannelsPerLed);
         }
@@ -308,18 +480,9 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           }
         }
 
-        if (!is4Chan) {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
-          }
-        }
-        break;
+        // copied to the frame buffer, loop() shows the frame once complete
+        e131FrameAdd(previousUniverses, universeCount, mde, previousLeds, ledsTotal > previousLeds ? ledsTotal - previousLeds : 0, e131_data + dmxOffset, dmxChannelsPerLed);
+        return;
       }
     default:
       DEBUG_PRINTLN(F("unknown E1.31 DMX mode"));
@@ -328,6 +491,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   }
 
   e131NewData = true;
+  rtStatsFrame(mde);
 }
 
 void handleArtnetPollReply(IPAddress ipAddress) {
@@ -49,6 +49,12 @@ bool getJsonValue(const JsonVariant& element, DestType& destination, const Defau
 }
 
 
+//clocksync.cpp
+bool clockSyncFollow(IPAddress ip);
+bool handleClockSyncPacket(const uint8_t *buf, size_t len, IPAddress ip);
+void handleClockSync();
+void serializeClockSync(JsonObject root);
+
 //colors.cpp
 // similar to NeoPixelBus NeoGammaTableMethod but allows dynamic changes (superseded by NPB::NeoGammaDynamicTableMethod)
 class NeoGammaWLEDMethod {
@@ -65,6 +71,10 @@ class NeoGammaWLEDMethod {
 uint32_t color_blend(uint32_t,uint32_t,uint16_t,bool b16=false);
 uint32_t color_add(uint32_t,uint32_t, bool fast=false);
 uint32_t color_fade(uint32_t c1, uint8_t amount, bool video=false);
+void color_fade_span(uint32_t *c, unsigned n, uint8_t amount, bool video=false);
+void color_blend_span(uint32_t *dst, const uint32_t *src, unsigned n, uint16_t blend, bool b16=false);
+void color_add_span(uint32_t *dst, const uint32_t *src, unsigned n, bool fast=false);
+void scale8_copy(uint8_t *dst, const uint8_t *src, size_t len, uint8_t scale);
 inline uint32_t colorFromRgbw(byte* rgbw) { return uint32_t((byte(rgbw[3]) << 24) | (byte(rgbw[0]) << 16) | (byte(rgbw[1]) << 8) | (byte(rgbw[2]))); }
 void colorHStoRGB(uint16_t hue, byte sat, byte* rgb); //hue, sat to rgb
 void colorKtoRGB(uint16_t kelvin, byte* rgb);
@@ -83,6 +93,7 @@ void handleDMX();
 
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleE131Frame();
 void handleArtnetPollReply(IPAddress ipAddress);
 void prepareArtnetPollReply(ArtPollReply* reply);
 void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
@@ -91,6 +102,7 @@ void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t port
 bool handleFileRead(AsyncWebServerRequest*, String path);
 bool writeObjectToFileUsingId(const char* file, uint16_t id, JsonDocument* content);
 bool writeObjectToFile(const char* file, const char* key, JsonDocument* content);
+bool writeObjectToFileAtomic(const char* file, JsonDocument* content);
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest);
 bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest);
 void updateFSInfo();
@@ -153,6 +165,7 @@ void serializeModeData(JsonArray root);
 void serveJson(AsyncWebServerRequest* request);
 #ifdef WLED_ENABLE_JSONLIVE
 bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient = 0);
+void handleLiveLeds();
 #endif
 
 //led.cpp
@@ -171,6 +184,12 @@ void handleTransitions();
 void handleNightlight();
 byte scaledBri(byte in);
 
+//ledmap.cpp
+int8_t readLedmap(uint8_t n, uint16_t* &table, uint16_t &size);
+bool getLedmapName(uint8_t n, char *name, size_t len);
+bool ledmapExists(uint8_t n);
+void removeLedmapCache(const String &fileName);
+
 #ifdef WLED_ENABLE_LOXONE
 //lx_parser.cpp
 bool parseLx(int lxValue, byte* rgbw);
@@ -206,6 +225,7 @@ void unloadPlaylist();
 int16_t loadPlaylist(JsonObject playlistObject, byte presetId = 0);
 void handlePlaylist();
 void serializePlaylist(JsonObject obj);
+byte getPlaylistPreset(byte index);
 
 //presets.cpp
 void initPresetsFile();
@@ -217,6 +237,17 @@ void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = Js
 inline void saveTemporaryPreset() {savePreset(255);};
 void deletePreset(byte index);
 bool getPresetName(byte index, String& name);
+void clearPresetCache();
+
+//presetlog.cpp
+int16_t presetStoreId(const char *file, const char *key);
+int8_t readPresetFromStore(uint8_t id, JsonDocument *dest);
+bool writePresetToStore(uint8_t id, JsonDocument *content);
+bool servePresetsJson(AsyncWebServerRequest *request, const String &contentType);
+void buildPresetIndex();
+void discardPresetLog();
+void handlePresetLog();
+void serializePresetLogInfo(JsonObject root);
 
 //remote.cpp
 void handleRemote();
@@ -226,13 +257,25 @@ bool isAsterisksOnly(const char* str, byte maxLen);
 void handleSettingsSet(AsyncWebServerRequest *request, byte subPage);
 bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=true);
 
+//telemetry.cpp
+void rtStatsPacket(uint8_t mode);
+void rtStatsFrame(uint8_t mode);
+void rtStatsDrop(uint8_t mode, bool late);
+void handleRtStats();
+void resetRtStats();
+void serializeRtStats(JsonObject root);
+size_t rtStatsBinarySize();
+size_t fillRtStatsBinary(uint8_t *buf);
+
 //udp.cpp
+bool beginNotifierUdp();
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false, uint16_t *packets=nullptr);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t i, const byte *data, uint16_t count, uint8_t channels);
 void refreshNodeList();
 void sendSysInfoUDP();
 
@@ -347,6 +390,10 @@ void prepareHostname(char* hostname);
 bool isAsterisksOnly(const char* str, byte maxLen);
 bool requestJSONBufferLock(uint8_t module=255);
 void releaseJSONBufferLock();
+bool lockJSONState(uint8_t module, JsonDocument *arena, unsigned waitMs = 1000);
+JsonDocument* acquireJSONArena(uint8_t module=255);
+void releaseJSONArena(JsonDocument *arena);
+void serializeJSONArenaInfo(JsonObject root);
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen);
 uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxLen, uint8_t *var = nullptr);
 int16_t extractModeDefaults(uint8_t mode, const char *segVar);
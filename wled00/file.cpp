@@ -271,6 +271,9 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
     s = millis();
   #endif
 
+  int16_t presetId = presetStoreId(file, key);
+  if (presetId >= 0) return writePresetToStore(presetId, content); // presets.json is never modified in place
+
   size_t pos = 0;
   f = WLED_FS.open(file, "r+");
   if (!f && !WLED_FS.exists(file)) f = WLED_FS.open(file, "w+");
@@ -325,6 +328,29 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
   return true;
 }
 
+// replaces file as a whole: content is written to a temporary file first which is then renamed
+// (a power cut leaves either the old or the new file, LittleFS rename is atomic)
+bool writeObjectToFileAtomic(const char* file, JsonDocument* content)
+{
+  char tmp[40];
+  snprintf_P(tmp, sizeof(tmp), PSTR("%s.tmp"), file);
+  if (doCloseFile) closeFile();
+  File tf = WLED_FS.open(tmp, "w");
+  if (!tf) return false;
+  size_t len = serializeJson(*content, tf);
+  tf.close();
+  if (len != measureJson(*content)) { // FS full, keep old file
+    WLED_FS.remove(tmp);
+    errorFlag = ERR_FS_GENERAL;
+    return false;
+  }
+  if (!WLED_FS.rename(tmp, file)) {
+    WLED_FS.remove(file);
+    return WLED_FS.rename(tmp, file);
+  }
+  return true;
+}
+
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest)
 {
   char objKey[10];
@@ -340,7 +366,17 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest)
     DEBUGFS_PRINTF("Read from %s with key %s >>>\n", file, (key==nullptr)?"nullptr":key);
     uint32_t s = millis();
   #endif
+  int16_t presetId = presetStoreId(file, key);
+  if (presetId >= 0) {
+    int8_t found = readPresetFromStore(presetId, dest);
+    if (found >= 0) return found; // otherwise search presets.json below
+  }
   f = WLED_FS.open(file, "r");
+  if (!f && key == nullptr) { // power cut during writeObjectToFileAtomic() without atomic rename
+    char tmp[40];
+    snprintf_P(tmp, sizeof(tmp), PSTR("%s.tmp"), file);
+    if (WLED_FS.exists(tmp) && WLED_FS.rename(tmp, file)) f = WLED_FS.open(file, "r");
+  }
   if (!f) return false;
 
   if (key != nullptr && !bufferedFind(key)) //key does not exist in file
@@ -399,6 +435,7 @@ bool handleFileRead(AsyncWebServerRequest* request, String path){
   if(path.endsWith("/")) path += "index.htm";
   if(path.indexOf("sec") > -1) return false;
   String contentType = getContentType(request, path);
+  if (path.endsWith(F("/presets.json")) && servePresetsJson(request, contentType)) return true; // merged with preset log
   /*String pathWithGz = path + ".gz";
   if(WLED_FS.exists(pathWithGz)){
     request->send(WLED_FS, pathWithGz, contentType);
@@ -303,7 +303,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   return true;
 }
 
-// deserializes WLED state (fileDoc points to doc object if called from web server)
+// deserializes WLED state (fileDoc points to doc object or a pool arena if called from web server)
 // presetId is non-0 if called from handlePreset()
 bool deserializeState(JsonObject root, byte callMode, byte presetId)
 {
@@ -648,6 +648,17 @@ void serializeInfo(JsonObject root)
   leds[F("wv")]   = totalLC & 0x02;     // deprecated, true if white slider should be displayed for any segment
   leds["cct"]     = totalLC & 0x04;     // deprecated, use info.leds.lc
 
+  // datagram counters of network (virtual) busses: [sent, failed frames]
+  JsonArray netarr;
+  for (unsigned b = 0; b < busses.getNumBusses(); b++) {
+    Bus *bus = busses.getBus(b);
+    if (!bus || bus->getType() < TYPE_NET_DDP_RGB || bus->getType() >= 96) continue;
+    if (netarr.isNull()) netarr = leds.createNestedArray(F("net"));
+    JsonArray n = netarr.createNestedArray();
+    n.add(static_cast<BusNetwork*>(bus)->getPacketsSent());
+    n.add(static_cast<BusNetwork*>(bus)->getPacketsFailed());
+  }
+
   #ifdef WLED_DEBUG
   JsonArray i2c = root.createNestedArray(F("i2c"));
   i2c.add(i2c_sda);
@@ -684,6 +695,25 @@ void serializeInfo(JsonObject root)
     root[F("lip")] = realtimeIP.toString();
   }
 
+  serializeRtStats(root);
+  serializeClockSync(root);
+  serializeJSONArenaInfo(root);
+
+  // UDP receive queue: [received, coalesced, dropped, depth (last loop), max. depth]
+  JsonArray udprx = root.createNestedArray(F("udprx"));
+  udprx.add(udpRxStats.received);
+  udprx.add(udpRxStats.coalesced);
+  udprx.add(udpRxStats.dropped);
+  udprx.add(udpRxStats.depth);
+  udprx.add(udpRxStats.maxDepth);
+
+  // multi-universe E1.31/Art-Net frames: [complete, incomplete (timed out/synced early), torn, skipped (replaced before shown)]
+  JsonArray rtframes = root.createNestedArray(F("lfrm"));
+  rtframes.add(realtimeFramesComplete);
+  rtframes.add(realtimeFramesIncomplete);
+  rtframes.add(realtimeFramesTorn);
+  rtframes.add(realtimeFramesSkipped);
+
   #ifdef WLED_ENABLE_WEBSOCKETS
   root[F("ws")] = ws.count();
   #else
@@ -716,6 +746,7 @@ void serializeInfo(JsonObject root)
   fs_info["u"] = fsBytesUsed / 1000;
   fs_info["t"] = fsBytesTotal / 1000;
   fs_info[F("pmt")] = presetsModifiedTime;
+  serializePresetLogInfo(fs_info);
 
   root[F("ndc")] = nodeListEnabled ? (int)Nodes.size() : -1;
 
@@ -1022,26 +1053,30 @@ void serializeModeNames(JsonArray arr)
 
 // Global buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
 class LockedJsonResponse: public AsyncJsonResponse {
+  JsonDocument *_arena; // pool arena to return (JSON buffer lock is then already released), nullptr for doc
   bool _holding_lock;
   public:
-  // WARNING: constructor assumes requestJSONBufferLock() was successfully acquired externally/prior to constructing the instance
+  // WARNING: constructor assumes requestJSONBufferLock() (or acquireJSONArena() if pooled) was successfully acquired externally/prior to constructing the instance
   // Not a good practice with C++. Unfortunately AsyncJsonResponse only has 2 constructors - for dynamic buffer or existing buffer,
   // with existing buffer it clears its content during construction
   // if the lock was not acquired (using JSONBufferGuard class) previous implementation still cleared existing buffer
-  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _holding_lock(true) {};
+  inline LockedJsonResponse(JsonDocument* doc, bool isArray, bool pooled = false) : AsyncJsonResponse(doc, isArray), _arena(pooled ? doc : nullptr), _holding_lock(true) {};
 
   virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { 
     size_t result = AsyncJsonResponse::_fillBuffer(buf, maxLen);
     // Release lock as soon as we're done filling content
-    if (((result + _sentLength) >= (_contentLength)) && _holding_lock) {
-      releaseJSONBufferLock();
-      _holding_lock = false;
-    }
+    if (((result + _sentLength) >= (_contentLength)) && _holding_lock) release();
     return result;
   }
 
+  inline void release() {
+    if (_arena) releaseJSONArena(_arena);
+    else        releaseJSONBufferLock();
+    _holding_lock = false;
+  }
+
   // destructor will remove JSON buffer lock when response is destroyed in AsyncWebServer
-  virtual ~LockedJsonResponse() { if (_holding_lock) releaseJSONBufferLock(); };
+  virtual ~LockedJsonResponse() { if (_holding_lock) release(); };
 };
 
 void serveJson(AsyncWebServerRequest* request)
@@ -1074,13 +1109,16 @@ void serveJson(AsyncWebServerRequest* request)
     return;
   }
 
-  if (!requestJSONBufferLock(17)) {
+  // serialize into a pool arena if one is free: the JSON buffer lock is then only held while reading state, not during transfer
+  JsonDocument *arena = acquireJSONArena(17);
+  if (!(arena ? lockJSONState(17, arena) : requestJSONBufferLock(17))) {
+    if (arena) releaseJSONArena(arena);
     request->send(503, "application/json", F("{\"error\":3}"));
     return;
   }
-  // releaseJSONBufferLock() will be called when "response" is destroyed (from AsyncWebServer)
+  // releaseJSONBufferLock() (or releaseJSONArena()) will be called when "response" is destroyed (from AsyncWebServer)
   // make sure you delete "response" if no "request->send(response);" is made
-  LockedJsonResponse *response = new LockedJsonResponse(&doc, subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS); // will clear and convert JsonDocument into JsonArray if necessary
+  LockedJsonResponse *response = new LockedJsonResponse(arena ? arena : &doc, subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS, arena); // will clear and convert JsonDocument into JsonArray if necessary
 
   JsonVariant lDoc = response->getRoot();
 
@@ -1115,6 +1153,7 @@ void serveJson(AsyncWebServerRequest* request)
   }
 
   DEBUG_PRINTF("JSON buffer size: %u for request: %d\n", lDoc.memoryUsage(), subJson);
+  if (arena) releaseJSONBufferLock(); // state is no longer accessed, arena is returned by response
 
   #ifdef WLED_DEBUG
   size_t len =
@@ -1128,15 +1167,135 @@ void serveJson(AsyncWebServerRequest* request)
 #ifdef WLED_ENABLE_JSONLIVE
 #define MAX_LIVE_LEDS 180
 
+/*
+ * HTTP live view is streamed straight into the TCP send buffer. Every LED is a fixed size record
+ * (JSON: [ or , followed by "RRGGBB"; binary: R,G,B) so any byte range can be produced from the
+ * response index without buffering the whole frame as text.
+ * The request is handled by the async_tcp task, the frame is copied by loop() (handleLiveLeds()) between
+ * two show() calls: the response waits for the copy and ends short if the LED count changed meanwhile.
+ */
+struct LiveLedsSnapshot {
+  uint8_t *rgb = nullptr;  // used LEDs, RGB (brightness applied)
+  size_t   used;
+  bool     ready = false;  // set by loop(), rgb == nullptr then means no frame (LED count changed or no memory)
+  ~LiveLedsSnapshot() { free(rgb); }
+};
+static std::shared_ptr<LiveLedsSnapshot> liveLedsRequest; // waiting for loop()
+
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE liveLedsMux = portMUX_INITIALIZER_UNLOCKED;
+#define LIVE_LEDS_LOCK()   portENTER_CRITICAL(&liveLedsMux)
+#define LIVE_LEDS_UNLOCK() portEXIT_CRITICAL(&liveLedsMux)
+#else
+#define LIVE_LEDS_LOCK()   noInterrupts()
+#define LIVE_LEDS_UNLOCK() interrupts()
+#endif
+
+static size_t liveLedsLength(size_t used, bool binary)
+{
+  return binary ? used*3 : 8 + used*9 + (used ? 8 : 9); // {"leds": + records + ],"n":1}
+}
+
+static size_t fillLiveLeds(uint8_t *buf, size_t maxLen, size_t index, const LiveLedsSnapshot &snap, bool binary)
+{
+  static const char hex[] = "0123456789ABCDEF";
+  const size_t used   = snap.used;
+  const size_t head   = binary ? 0 : 8;
+  const size_t recLen = binary ? 3 : 9;
+  const size_t total  = liveLedsLength(used, binary);
+  size_t len = 0;
+
+  while (len < maxLen && index < total) {
+    char rec[10];
+    size_t recSize, off;
+    if (index < head) {
+      memcpy_P(rec, PSTR("{\"leds\":"), 8);
+      recSize = 8;
+      off = index;
+    } else if (index < head + used*recLen) {
+      size_t i = (index - head) / recLen;
+      off = (index - head) % recLen;
+      const uint8_t *rgb = snap.rgb + i*3;
+      if (binary) memcpy(rec, rgb, 3);
+      else {
+        rec[0] = i ? ',' : '[';
+        rec[1] = rec[8] = '"';
+        for (size_t j = 0; j < 3; j++) {
+          rec[2+j*2] = hex[rgb[j] >> 4];
+          rec[3+j*2] = hex[rgb[j] & 0x0F];
+        }
+      }
+      recSize = recLen;
+    } else {
+      strcpy_P(rec, used ? PSTR("],\"n\":1}") : PSTR("[],\"n\":1}"));
+      recSize = strlen(rec);
+      off = index - head - used*recLen;
+    }
+    size_t cnt = MIN(recSize - off, maxLen - len);
+    memcpy(buf + len, rec + off, cnt);
+    len   += cnt;
+    index += cnt;
+  }
+  return len;
+}
+
+// called from loop(): copies the frame for a waiting /json/live response
+void handleLiveLeds()
+{
+  LIVE_LEDS_LOCK();
+  std::shared_ptr<LiveLedsSnapshot> snap = std::move(liveLedsRequest);
+  LIVE_LEDS_UNLOCK();
+  if (!snap || snap.use_count() == 1) return; // response already gone (client disconnected)
+
+  if (snap->used == strip.getLengthTotal()) {
+    uint8_t *rgb = (uint8_t*)malloc(snap->used * 3 + 1);
+    if (rgb) for (size_t i = 0; i < snap->used; i++) {
+      uint32_t c = strip.getPixelColor(i);
+      uint8_t w = W(c);
+      rgb[i*3]   = scale8(qadd8(w, R(c)), strip.getBrightness()); //R, add white channel to RGB channels as a simple RGBW -> RGB map
+      rgb[i*3+1] = scale8(qadd8(w, G(c)), strip.getBrightness()); //G
+      rgb[i*3+2] = scale8(qadd8(w, B(c)), strip.getBrightness()); //B
+    }
+    snap->rgb = rgb;
+  }
+  LIVE_LEDS_LOCK();
+  snap->ready = true;
+  LIVE_LEDS_UNLOCK();
+}
+
 bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
 {
-  #ifdef WLED_ENABLE_WEBSOCKETS
-  AsyncWebSocketClient * wsc = nullptr;
-  if (!request) { //not HTTP, use Websockets
-    wsc = ws.client(wsClient);
-    if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
+  if (request) { // full resolution, JSON or application/octet-stream (/json/live?bin or Accept header) with RGB triplets
+    bool binary = request->hasArg(F("bin")) ||
+                  (request->hasHeader(F("Accept")) && request->getHeader(F("Accept"))->value().indexOf(F("octet-stream")) >= 0);
+    std::shared_ptr<LiveLedsSnapshot> snap = std::make_shared<LiveLedsSnapshot>();
+    snap->used = strip.getLengthTotal();
+    bool busy;
+    LIVE_LEDS_LOCK();
+    busy = (bool)liveLedsRequest; // one frame copy at a time
+    if (!busy) liveLedsRequest = snap;
+    LIVE_LEDS_UNLOCK();
+    if (busy) {
+      request->send(503, "application/json", F("{\"error\":3}"));
+      return true;
+    }
+    AsyncWebServerResponse *response = request->beginResponse(binary ? F("application/octet-stream") : F("application/json"), liveLedsLength(snap->used, binary),
+      [snap, binary](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+        LIVE_LEDS_LOCK();
+        bool ready = snap->ready;
+        LIVE_LEDS_UNLOCK();
+        if (!ready) return RESPONSE_TRY_AGAIN; // loop() has not copied the frame yet
+        if (!snap->rgb) return 0;              // LED count changed or out of memory: response ends short
+        return fillLiveLeds(buf, maxLen, index, *snap, binary);
+      });
+    response->addHeader(F("Cache-Control"), F("no-store"));
+    request->send(response);
+    return true;
   }
-  #endif
+
+  #ifdef WLED_ENABLE_WEBSOCKETS
+  AsyncWebSocketClient * wsc = ws.client(wsClient);
+  if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
 
   uint16_t used = strip.getLengthTotal();
   uint16_t n = (used -1) /MAX_LIVE_LEDS +1; //only serve every n'th LED if count over MAX_LIVE_LEDS
@@ -1161,14 +1320,10 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
   oappend((const char*)F("],\"n\":"));
   oappendi(n);
   oappend("}");
-  if (request) {
-    request->send(200, F("application/json"), buffer);
-  }
-  #ifdef WLED_ENABLE_WEBSOCKETS
-  else {
-    wsc->text(obuf, olen);
-  }
-  #endif
+  wsc->text(obuf, olen);
   return true;
+  #else
+  return false;
+  #endif
 }
 #endif
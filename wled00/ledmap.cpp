@@ -0,0 +1,342 @@
+#include "wled.h"
+
+/*
+ * Custom ledmap loading
+ * ledmapN.json is streamed from the file in small blocks and parsed by a minimal tokenizer that only
+ * looks at the top level "map" array and "n" name, so the size of a map is not limited by the JSON buffer
+ * and loading does not need the JSON buffer lock. After a JSON ledmap was loaded a compact binary copy
+ * (ledmapN.bin) is written which is used on the following loads as long as the JSON file is unchanged.
+ * A ledmapN.bin without source information (e.g. copied from another device) is used on its own.
+ *
+ * Binary format (little endian): 'W','L','M', version, entry count (16), size (32) and last write time (32)
+ * of the source JSON (size 0 = no source), name length (8), name, runs until count entries were decoded.
+ * Run: control byte, bits 0-6 = run length - 1, bit 7 set = linear run: start (16), step (16, mod 65536)
+ *                                               bit 7 clear = literal run: run length entries (16)
+ */
+
+#define LEDMAP_BIN_VERSION 1
+#define LEDMAP_BIN_HDR     15
+#define LEDMAP_MAX_RUN     128
+#define LEDMAP_BUFSIZE     128
+
+static void getLedmapFileName(char *fileName, uint8_t n, bool bin)
+{
+  strcpy_P(fileName, PSTR("/ledmap"));
+  if (n) sprintf(fileName +7, "%d", n);
+  strcat_P(fileName, bin ? PSTR(".bin") : PSTR(".json"));
+}
+
+static uint32_t fileTime(File &f)
+{
+  return (uint32_t)f.getLastWrite();
+}
+
+// streams the top level "map" array and "n" string of a ledmap JSON file
+// table == nullptr only counts the entries, at most capacity entries are stored (map size is 16 bit)
+static bool parseLedmapJson(File &f, uint16_t *table, size_t capacity, size_t &count, char *name, size_t nameLen)
+{
+  uint8_t buf[LEDMAP_BUFSIZE];
+  unsigned depth = 0;         // 1 = top level object
+  bool inString = false, escape = false;
+  bool expectKey = false;     // next string at depth 1 is a key
+  bool isKey = false;         // string being read is a top level key
+  bool isName = false;        // string being read is the value of "n"
+  uint8_t field = 0;          // last top level key: 0 = other, 1 = "map", 2 = "n"
+  char key[4];
+  uint8_t keyLen = 0;
+  bool inMap = false;
+  bool inValue = false, isNumber = false, negative = false, fraction = false;
+  uint32_t value = 0;
+  size_t nLen = 0;
+
+  count = 0;
+  if (name && nameLen) name[0] = '\0';
+  f.seek(0);
+  size_t len;
+  while ((len = f.read(buf, sizeof(buf))) > 0) {
+    for (size_t i = 0; i < len; i++) {
+      char c = buf[i];
+      if (inString) {
+        if (escape) escape = false;
+        else if (c == '\\') { escape = true; continue; }
+        else if (c == '"') {
+          inString = false;
+          if (isKey) {
+            field = 0;
+            if (keyLen == 3 && !strncmp_P(key, PSTR("map"), 3)) field = 1;
+            if (keyLen == 1 && key[0] == 'n')                  field = 2;
+          }
+          if (isName && name && nLen < nameLen) name[nLen] = '\0';
+          continue;
+        }
+        if (isKey) { if (keyLen < sizeof(key)) key[keyLen++] = c; else keyLen = UINT8_MAX; }
+        else if (isName && name && nLen+1 < nameLen) name[nLen++] = c;
+        continue;
+      }
+      if (inMap) {
+        if (c >= '0' && c <= '9') {
+          inValue = isNumber = true;
+          if (!fraction && value <= 0xFFFF) value = value * 10 + (c - '0');
+        } else if (c == '-' && !inValue) {
+          inValue = isNumber = negative = true;
+        } else if (c == ',' || c == ']') {
+          if (inValue) {
+            // negative, out of range and non numeric entries are unused pixels
+            if (count < capacity && table) table[count] = (!isNumber || negative || value > 0xFFFF) ? 0xFFFFU : value;
+            count++;
+          }
+          inValue = isNumber = negative = fraction = false;
+          value = 0;
+          if (c == ']') { inMap = false; depth--; }
+        } else if (c == '.' || c == 'e' || c == 'E' || c == '+') {
+          fraction = true;
+        } else if (c == '[' || c == '{' || c == '"') {
+          return false; // not a flat array
+        } else if (c > ' ') {
+          inValue = true; // null, true, false
+        }
+        continue;
+      }
+      switch (c) {
+        case '"':
+          inString = true;
+          isKey  = depth == 1 && expectKey;
+          isName = depth == 1 && !expectKey && field == 2;
+          keyLen = nLen = 0;
+          break;
+        case '{':
+          if (!depth) expectKey = true;
+          else if (depth == 1) field = 0;
+          depth++;
+          break;
+        case '[':
+          if (!depth) return false;
+          if (depth == 1 && field == 1) inMap = true;
+          depth++;
+          break;
+        case ':':
+          if (depth == 1) expectKey = false;
+          break;
+        case ',':
+          if (depth == 1) { expectKey = true; field = 0; }
+          break;
+        case '}':
+        case ']':
+          if (!depth) return false;
+          if (--depth == 0) return true;
+          break;
+        default:
+          if (!depth && c > ' ') return false;
+          break;
+      }
+    }
+  }
+  return false; // incomplete
+}
+
+static bool readLedmapBinHeader(File &f, uint16_t &count, uint32_t &srcSize, uint32_t &srcTime, char *name, size_t nameLen)
+{
+  uint8_t hdr[LEDMAP_BIN_HDR];
+  if (f.read(hdr, LEDMAP_BIN_HDR) != LEDMAP_BIN_HDR) return false;
+  if (hdr[0] != 'W' || hdr[1] != 'L' || hdr[2] != 'M' || hdr[3] != LEDMAP_BIN_VERSION) return false;
+  count   = hdr[4] | (hdr[5] << 8);
+  srcSize = hdr[6]  | (hdr[7]  << 8) | (hdr[8]  << 16) | ((uint32_t)hdr[9]  << 24);
+  srcTime = hdr[10] | (hdr[11] << 8) | (hdr[12] << 16) | ((uint32_t)hdr[13] << 24);
+  uint8_t len = hdr[14];
+  if (name && nameLen) {
+    size_t n = len < nameLen ? len : nameLen-1;
+    if (f.read((uint8_t*)name, n) != n) return false;
+    name[n] = '\0';
+    len -= n;
+  }
+  return !len || f.seek(len, SeekCur);
+}
+
+// opens ledmapN.bin if it can be used instead of ledmapN.json, positioned after the header
+static File openLedmapBin(uint8_t n, uint16_t &count, char *name, size_t nameLen)
+{
+  char fileName[32];
+  getLedmapFileName(fileName, n, true);
+  if (!WLED_FS.exists(fileName)) return File();
+  File f = WLED_FS.open(fileName, "r");
+  if (!f) return f;
+  uint32_t srcSize, srcTime;
+  bool valid = readLedmapBinHeader(f, count, srcSize, srcTime, name, nameLen);
+  if (valid && srcSize) { // cache of ledmapN.json
+    getLedmapFileName(fileName, n, false);
+    File src = WLED_FS.open(fileName, "r");
+    valid = src && src.size() == srcSize && fileTime(src) == srcTime;
+    src.close();
+  }
+  if (!valid) f.close();
+  return f;
+}
+
+static bool decodeLedmapBin(File &f, uint16_t *table, uint16_t count)
+{
+  size_t pos = 0;
+  while (pos < count) {
+    uint8_t ctl;
+    if (f.read(&ctl, 1) != 1) return false;
+    size_t run = (ctl & 0x7F) + 1;
+    if (pos + run > count) return false;
+    if (ctl & 0x80) {
+      uint8_t b[4];
+      if (f.read(b, 4) != 4) return false;
+      uint16_t v    = b[0] | (b[1] << 8);
+      uint16_t step = b[2] | (b[3] << 8);
+      for (size_t i = 0; i < run; i++, v += step) table[pos++] = v;
+    } else {
+      uint8_t *dst = (uint8_t*)(table + pos);
+      if (f.read(dst, run*2) != run*2) return false;
+      for (size_t i = 0; i < run; i++, pos++) table[pos] = dst[2*i] | (dst[2*i+1] << 8); // each entry from its own bytes
+    }
+  }
+  return !f.available(); // trailing data: not written by us
+}
+
+static bool writeLedmapBin(uint8_t n, const uint16_t *table, uint16_t count, File &src, const char *name)
+{
+  char fileName[32];
+  getLedmapFileName(fileName, n, true);
+  File f = WLED_FS.open(fileName, "w");
+  if (!f) return false;
+
+  uint8_t buf[LEDMAP_BUFSIZE];
+  size_t pos = 0;
+  bool ok = true;
+  auto flush = [&]() { if (pos && f.write(buf, pos) != pos) ok = false; pos = 0; };
+  auto put   = [&](uint8_t b) { if (pos >= sizeof(buf)) flush(); buf[pos++] = b; };
+  auto put16 = [&](uint16_t v) { put(v); put(v >> 8); };
+  auto put32 = [&](uint32_t v) { put16(v); put16(v >> 16); };
+
+  size_t nameLen = name ? strlen(name) : 0;
+  if (nameLen > UINT8_MAX) nameLen = UINT8_MAX;
+  put('W'); put('L'); put('M'); put(LEDMAP_BIN_VERSION);
+  put16(count);
+  put32(src.size());
+  put32(fileTime(src));
+  put(nameLen);
+  for (size_t i = 0; i < nameLen; i++) put(name[i]);
+
+  // linear runs (serpentine rows, unused pixels) of at least 3 entries, everything else as literals
+  size_t i = 0, lit = 0; // literal run starts at i - lit
+  auto flushLiteral = [&]() {
+    for (size_t s = i - lit; lit; ) {
+      size_t run = lit < LEDMAP_MAX_RUN ? lit : LEDMAP_MAX_RUN;
+      put(run - 1);
+      for (size_t k = 0; k < run; k++) put16(table[s++]);
+      lit -= run;
+    }
+  };
+  while (i < count) {
+    size_t run = 1;
+    uint16_t step = i+1 < count ? table[i+1] - table[i] : 0;
+    while (run < LEDMAP_MAX_RUN && i + run < count && (uint16_t)(table[i+run] - table[i+run-1]) == step) run++;
+    if (run < 3) { lit++; i++; continue; }
+    flushLiteral();
+    put(0x80 | (run - 1));
+    put16(table[i]);
+    put16(step);
+    i += run;
+  }
+  flushLiteral();
+  flush();
+  f.close();
+
+  if (!ok) WLED_FS.remove(fileName); // FS full, keep using JSON
+  return ok;
+}
+
+// load ledmapN: returns 1 (table allocated with new[], may be nullptr for an empty map), 0 on error, -1 if there is no such ledmap
+int8_t readLedmap(uint8_t n, uint16_t* &table, uint16_t &size)
+{
+  table = nullptr;
+  size = 0;
+
+  uint16_t count;
+  File f = openLedmapBin(n, count, nullptr, 0);
+  if (f) {
+    DEBUG_PRINTF("Reading LED map %d (bin)\n", n);
+    if (count) table = new uint16_t[count];
+    if (count && !table) { f.close(); return 0; }
+    bool ok = decodeLedmapBin(f, table, count);
+    f.close();
+    if (ok) { size = count; return 1; }
+    delete[] table; // corrupted cache, load JSON and rewrite it
+    table = nullptr;
+  }
+
+  char fileName[32];
+  getLedmapFileName(fileName, n, false);
+  if (!WLED_FS.exists(fileName)) return -1;
+  f = WLED_FS.open(fileName, "r");
+  if (!f) return 0;
+  DEBUG_PRINT(F("Reading LED map from "));
+  DEBUG_PRINTLN(fileName);
+
+  size_t entries;
+  char name[33];
+  if (!parseLedmapJson(f, nullptr, 0, entries, name, sizeof(name))) {
+    DEBUG_PRINTLN(F("Invalid LED map."));
+    f.close();
+    return 0;
+  }
+  if (entries > UINT16_MAX) entries = UINT16_MAX;
+  if (entries) {
+    size_t filled;
+    table = new uint16_t[entries];
+    if (!table || !parseLedmapJson(f, table, entries, filled, nullptr, 0) || MIN(filled, (size_t)UINT16_MAX) != entries) {
+      delete[] table; // out of memory or file changed in between
+      table = nullptr;
+      f.close();
+      return 0;
+    }
+  }
+  size = entries;
+  writeLedmapBin(n, table, size, f, name);
+  f.close();
+  return 1;
+}
+
+// name of ledmapN ("n" member of the JSON file or stored in ledmapN.bin), returns false if there is no such ledmap
+bool getLedmapName(uint8_t n, char *name, size_t len)
+{
+  uint16_t count;
+  File f = openLedmapBin(n, count, name, len);
+  if (f) {
+    f.close();
+    return true;
+  }
+  char fileName[32];
+  getLedmapFileName(fileName, n, false);
+  if (!WLED_FS.exists(fileName)) return false;
+  f = WLED_FS.open(fileName, "r");
+  if (!f) return false;
+  size_t entries;
+  if (!parseLedmapJson(f, nullptr, 0, entries, name, len)) name[0] = '\0';
+  f.close();
+  return true;
+}
+
+bool ledmapExists(uint8_t n)
+{
+  char fileName[32];
+  getLedmapFileName(fileName, n, false);
+  if (WLED_FS.exists(fileName)) return true;
+  uint16_t count;
+  File f = openLedmapBin(n, count, nullptr, 0); // a cache without its JSON file does not count
+  if (!f) return false;
+  f.close();
+  return true;
+}
+
+// an uploaded ledmapN.json replaces its binary copy (the FS editor is covered by the size/time check)
+void removeLedmapCache(const String &fileName)
+{
+  int dot = fileName.lastIndexOf('.');
+  if (dot < 0) return;
+  String bin = fileName.substring(0, dot) + F(".bin");
+  if (bin.charAt(0) != '/') bin = '/' + bin;
+  if (WLED_FS.exists(bin)) WLED_FS.remove(bin);
+}
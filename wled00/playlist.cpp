@@ -49,6 +49,7 @@ void unloadPlaylist() {
   }
   currentPlaylist = playlistIndex = -1;
   playlistLen = playlistEntryDur = playlistOptions = 0;
+  clearPresetCache();
   DEBUG_PRINTLN(F("Playlist unloaded."));
 }
 
@@ -115,6 +116,7 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   if (shuffle) playlistOptions |= PL_OPTION_SHUFFLE;
 
   currentPlaylist = presetId;
+  clearPresetCache(); // (re)fill with presets of this playlist
   DEBUG_PRINTLN(F("Playlist loaded."));
   return currentPlaylist;
 }
@@ -151,6 +153,13 @@ void handlePlaylist() {
 }
 
 
+// preset ID of playlist entry, 0 if there is no such entry
+byte getPlaylistPreset(byte index) {
+  if (playlistEntries == nullptr || index >= playlistLen) return 0;
+  return playlistEntries[index].preset;
+}
+
+
 void serializePlaylist(JsonObject sObj) {
   JsonObject playlist = sObj.createNestedObject(F("playlist"));
   JsonArray ps = playlist.createNestedArray("ps");
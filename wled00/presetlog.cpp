@@ -0,0 +1,576 @@
+#include "wled.h"
+
+/*
+ * Crash safe preset store
+ * presets.json is never modified in place. Saving or deleting a preset appends a CRC protected record
+ * to presets.log, so writing takes the same time regardless of the number of presets and a power cut
+ * can at most lose the record being written. Once no presets were written for a while the log is merged
+ * into a new presets.json (compaction, a few presets per loop) which then replaces the old file by rename.
+ * An in-memory index holds file, position and length of every preset object. While the log is not empty
+ * /presets.json is served as a merged view built from the index (for the UI and backups).
+ *
+ * Log record: 'P', preset id, data length (LE16), CRC16 of id, length and data (LE16), data (JSON object, none = deleted)
+ */
+
+#define PRESETS_FILE     "/presets.json"
+#define PRESETS_LOG      "/presets.log"
+#define PRESETS_TMP      "/presets.tmp"
+#define PRESET_LOG_MAGIC 'P'
+#define PRESET_LOG_HDR   6
+#define PRESET_LOG_IDLE  10000 // ms without preset writes before the log is compacted
+#define PRESET_BUFSIZE   256
+
+typedef struct PresetIndexEntry {
+  uint32_t offset;      // position of the object's '{' (0 = preset does not exist)
+  uint32_t length : 31;
+  uint32_t inLog  : 1;  // offset refers to presets.log
+} presetindexentry_t;
+
+static presetindexentry_t *presetIndex = nullptr;
+static uint16_t presetIndexSize = 0;       // allocated entries (highest id + 1)
+static bool     presetIndexValid = false;
+static size_t   presetsFileSize = 0;       // size of presets.json the index is valid for
+static size_t   presetLogSize = 0;         // size of valid records in presets.log
+static bool     presetLogDamaged = false;  // incomplete record at end of log (power loss or FS full)
+static volatile bool presetLogDiscard = false; // presets.json was replaced (upload)
+static volatile uint8_t presetExports = 0; // merged views being served
+static unsigned long presetLastWrite = 0;
+static uint16_t presetLogRecords = 0;
+static uint16_t presetCompactions = 0;
+
+// compaction state
+static File     compactFile;
+static presetindexentry_t *compactIndex = nullptr;
+static uint16_t compactId = 0;             // next preset to copy
+static bool     compactRunning = false;
+
+static uint16_t crc16Update(uint16_t crc, uint8_t data) {
+  uint8_t x = crc >> 8 ^ data;
+  x ^= x>>4;
+  return (crc << 8) ^ ((uint16_t)(x << 12)) ^ ((uint16_t)(x <<5)) ^ ((uint16_t)x);
+}
+
+// Print that only computes CRC16 (same as crc16()) and length of what is printed
+class CrcPrint : public Print {
+  public:
+    uint16_t crc = 0xFFFF;
+    size_t   len = 0;
+    using Print::write;
+    size_t write(uint8_t c) { crc = crc16Update(crc, c); len++; return 1; }
+};
+
+// bounded, block buffered file reader for deserializeJson() (ArduinoJson reads Streams byte by byte)
+class FileObjectReader {
+  File &_f;
+  size_t _left;
+  size_t _pos = 0, _end = 0;
+  uint8_t _buf[PRESET_BUFSIZE];
+  public:
+    FileObjectReader(File &file, size_t length) : _f(file), _left(length) {}
+    int read() {
+      if (_pos >= _end) {
+        if (!_left) return -1;
+        _end = _f.read(_buf, _left < PRESET_BUFSIZE ? _left : PRESET_BUFSIZE);
+        _pos = 0;
+        if (!_end) { _left = 0; return -1; }
+        _left -= _end;
+      }
+      return _buf[_pos++];
+    }
+    size_t readBytes(char *buffer, size_t length) {
+      size_t n = 0;
+      int c;
+      while (n < length && (c = read()) >= 0) buffer[n++] = c;
+      return n;
+    }
+};
+
+// preset id if file/key refer to a presets.json object, -1 otherwise
+int16_t presetStoreId(const char *file, const char *key)
+{
+  if (!file || !key || strcmp_P(file, PSTR(PRESETS_FILE)) || key[0] != '"') return -1;
+  int id = atoi(key+1);
+  return (id >= 0 && id <= 255) ? id : -1;
+}
+
+static void invalidatePresetIndex()
+{
+  free(presetIndex);
+  presetIndex = nullptr;
+  presetIndexSize = 0;
+  presetIndexValid = false;
+}
+
+static bool setPresetIndex(uint8_t id, size_t offset, size_t length, bool inLog)
+{
+  if (id >= presetIndexSize) {
+    if (!offset) return true; // nothing to remove
+    presetindexentry_t *tmp = (presetindexentry_t*)realloc(presetIndex, (id+1) * sizeof(presetindexentry_t));
+    if (!tmp) { invalidatePresetIndex(); return false; }
+    memset(tmp + presetIndexSize, 0, (id+1 - presetIndexSize) * sizeof(presetindexentry_t));
+    presetIndex = tmp;
+    presetIndexSize = id+1;
+  }
+  presetIndex[id].offset = offset;
+  presetIndex[id].length = length;
+  presetIndex[id].inLog  = inLog;
+  return true;
+}
+
+static inline const presetindexentry_t *getPresetIndex(uint8_t id)
+{
+  return (id < presetIndexSize && presetIndex[id].offset) ? &presetIndex[id] : nullptr;
+}
+
+// indexes objects of presets.json, string aware
+static bool scanPresetsFile(File &pf)
+{
+  byte buf[PRESET_BUFSIZE];
+  size_t pos = 0, objStart = 0;
+  uint16_t depth = 0;
+  bool inStr = false, esc = false, keyDone = false, colon = false;
+  int key = -1, objId = -1;
+
+  size_t bufsize;
+  while ((bufsize = pf.read(buf, PRESET_BUFSIZE)) > 0) {
+    for (size_t i = 0; i < bufsize; i++, pos++) {
+      char c = buf[i];
+      if (inStr) {
+        if (esc)            esc = false;
+        else if (c == '\\') esc = true;
+        else if (c == '"')  { inStr = false; keyDone = (depth == 1 && key >= 0); }
+        else if (depth == 1 && key >= 0) key = (c >= '0' && c <= '9' && key < 256) ? key*10 + (c - '0') : -1;
+        continue;
+      }
+      switch (c) {
+        case '"':
+          inStr = true;
+          key = 0; keyDone = colon = false;
+          break;
+        case ':':
+          colon = keyDone;
+          break;
+        case '{':
+          if (depth == 1 && colon && key <= 255) { objId = key; objStart = pos; }
+          keyDone = colon = false;
+          depth++;
+          break;
+        case '}':
+          if (!depth) break; // malformed
+          if (--depth == 1 && objId >= 0) {
+            // first occurrence wins (same as searching the file)
+            if (!getPresetIndex(objId) && !setPresetIndex(objId, objStart, pos+1 - objStart, false)) return false;
+            objId = -1;
+          }
+          break;
+        case ' ': case '\t': case '\r': case '\n':
+          break;
+        default:
+          keyDone = colon = false;
+          break;
+      }
+    }
+  }
+  return true;
+}
+
+// replays presets.log on top of the index, stops at the first incomplete or corrupted record
+static bool scanPresetLog()
+{
+  presetLogSize = 0;
+  presetLogRecords = 0;
+  presetLogDamaged = false;
+  File lf = WLED_FS.open(PRESETS_LOG, "r");
+  if (!lf) return true;
+
+  uint8_t buf[PRESET_BUFSIZE];
+  size_t size = lf.size(), pos = 0;
+  bool ok = true;
+  while (pos + PRESET_LOG_HDR <= size) {
+    lf.seek(pos);
+    if (lf.read(buf, PRESET_LOG_HDR) != PRESET_LOG_HDR || buf[0] != PRESET_LOG_MAGIC) break;
+    uint8_t  id  = buf[1];
+    size_t   len = buf[2] | (buf[3] << 8);
+    uint16_t crc = buf[4] | (buf[5] << 8);
+    if (pos + PRESET_LOG_HDR + len > size) break;
+    uint16_t c = crc16Update(crc16Update(crc16Update(0xFFFF, id), buf[2]), buf[3]);
+    size_t left = len;
+    while (left) {
+      size_t n = lf.read(buf, MIN(left, sizeof(buf)));
+      if (!n) break;
+      for (size_t i = 0; i < n; i++) c = crc16Update(c, buf[i]);
+      left -= n;
+    }
+    if (left || c != crc) break;
+    if (!setPresetIndex(id, len ? pos + PRESET_LOG_HDR : 0, len, true)) { ok = false; break; }
+    pos += PRESET_LOG_HDR + len;
+    presetLogRecords++;
+  }
+  presetLogDamaged = pos < size;
+  presetLogSize = pos;
+  lf.close();
+  return ok;
+}
+
+static bool loadPresetIndex()
+{
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTLN(F("Build preset index"));
+    uint32_t s = millis();
+  #endif
+  invalidatePresetIndex();
+  File pf = WLED_FS.open(PRESETS_FILE, "r");
+  bool ok = true;
+  presetsFileSize = 0;
+  if (pf) {
+    ok = scanPresetsFile(pf);
+    presetsFileSize = pf.size();
+    pf.close();
+  }
+  presetIndexValid = ok && scanPresetLog();
+  DEBUGFS_PRINTF("Indexed %d entries, log %d bytes, took %d ms\n", presetIndexSize, presetLogSize, millis() - s);
+  return presetIndexValid;
+}
+
+static void abortCompaction()
+{
+  if (!compactRunning) return;
+  compactFile.close();
+  WLED_FS.remove(PRESETS_TMP);
+  free(compactIndex);
+  compactIndex = nullptr;
+  compactRunning = false;
+  DEBUGFS_PRINTLN(F("Preset compaction aborted."));
+}
+
+static void handleDiscard()
+{
+  if (!presetLogDiscard) return;
+  presetLogDiscard = false;
+  abortCompaction();
+  WLED_FS.remove(PRESETS_LOG);
+  invalidatePresetIndex();
+  presetLogSize = 0;
+  presetLogDamaged = false;
+}
+
+// index is valid for the current presets.json (may have been replaced using /edit)
+static bool presetIndexReady()
+{
+  handleDiscard();
+  if (presetIndexValid) {
+    File pf = WLED_FS.open(PRESETS_FILE, "r");
+    size_t size = pf ? pf.size() : 0;
+    if (pf) pf.close();
+    if (size == presetsFileSize) return true;
+    abortCompaction();
+  }
+  return loadPresetIndex();
+}
+
+// checks that the object at the indexed position of presets.json belongs to id
+// ("id":{ with optional whitespace around the colon, like scanPresetsFile() accepts)
+static bool verifyPresetEntry(File &pf, uint8_t id, const presetindexentry_t &e)
+{
+  char buf[32];
+  size_t n = MIN(e.offset, sizeof(buf) - 1);
+  pf.seek(e.offset - n);
+  if (pf.read((uint8_t*)buf, n+1) != n+1 || buf[n] != '{') return false;
+  int i = n - 1;
+  while (i >= 0 && isspace(buf[i])) i--;
+  if (i < 0 || buf[i--] != ':') return false;
+  while (i >= 0 && isspace(buf[i])) i--;
+  if (i < 0 || buf[i--] != '"') return false;
+  unsigned key = 0, mul = 1;
+  int digits = i;
+  for (; i >= 0 && buf[i] >= '0' && buf[i] <= '9' && mul <= 1000; i--, mul *= 10) key += (buf[i] - '0') * mul;
+  return i >= 0 && i < digits && buf[i] == '"' && key == id;
+}
+
+// reads preset into dest, returns 1 if found, 0 if not and -1 if the store can't be used (search presets.json instead)
+int8_t readPresetFromStore(uint8_t id, JsonDocument *dest)
+{
+  if (!presetIndexReady()) return -1;
+  const presetindexentry_t *e = getPresetIndex(id);
+  if (!e) {
+    dest->clear();
+    return 0;
+  }
+  File pf = WLED_FS.open(e->inLog ? PRESETS_LOG : PRESETS_FILE, "r");
+  if (!pf) return -1;
+  if (!e->inLog && !verifyPresetEntry(pf, id, *e)) {
+    DEBUGFS_PRINTLN(F("Preset index stale!"));
+    pf.close();
+    invalidatePresetIndex();
+    return -1;
+  }
+  pf.seek(e->offset);
+  FileObjectReader reader(pf, e->length);
+  deserializeJson(*dest, reader);
+  pf.close();
+  return 1;
+}
+
+static bool compactPresetLog(bool finish);
+
+// saves (or deletes if content is empty) preset by appending a record to presets.log
+bool writePresetToStore(uint8_t id, JsonDocument *content)
+{
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTF("Log preset %d >>>\n", id);
+    uint32_t s = millis();
+  #endif
+  abortCompaction();
+  bool indexed = presetIndexReady();
+  if (presetLogDamaged && !compactPresetLog(true)) return false; // records after a damaged one would be lost
+
+  size_t len = content->isNull() ? 0 : measureJson(*content);
+  if (len > UINT16_MAX) return false;
+  CrcPrint crc;
+  crc.write(id);
+  crc.write(len & 0xFF);
+  crc.write(len >> 8);
+  if (len) serializeJson(*content, crc);
+
+  updateFSInfo();
+  if (presetsFileSize + presetLogSize + len + 9000 > (fsBytesTotal - fsBytesUsed)) { //make sure presets can still be compacted
+    errorFlag = ERR_FS_QUOTA;
+    return false;
+  }
+
+  File lf = WLED_FS.open(PRESETS_LOG, "a");
+  if (!lf) return false;
+  size_t pos = presetLogSize;
+  uint8_t hdr[PRESET_LOG_HDR] = {PRESET_LOG_MAGIC, id, uint8_t(len), uint8_t(len >> 8), uint8_t(crc.crc), uint8_t(crc.crc >> 8)};
+  lf.write(hdr, PRESET_LOG_HDR);
+  if (len) serializeJson(*content, lf);
+  lf.close();
+  lf = WLED_FS.open(PRESETS_LOG, "r"); // size of an open file may not include buffered data
+  size_t end = lf ? lf.size() : 0;
+  if (lf) lf.close();
+
+  presetLastWrite = millis();
+  if (end != pos + PRESET_LOG_HDR + len) { // FS full or log changed behind our back
+    errorFlag = ERR_FS_GENERAL;
+    invalidatePresetIndex(); // rescan will find the damage
+    return false;
+  }
+  presetLogSize = end;
+  presetLogRecords++;
+  if (indexed) setPresetIndex(id, len ? pos + PRESET_LOG_HDR : 0, len, true);
+  DEBUGFS_PRINTF("Logged, took %d ms\n", millis() - s);
+  return true;
+}
+
+// copies len bytes at offset of file to the compaction target
+static bool copyPresetData(const char *file, size_t offset, size_t len)
+{
+  File src = WLED_FS.open(file, "r");
+  if (!src) return false;
+  src.seek(offset);
+  uint8_t buf[PRESET_BUFSIZE];
+  while (len) {
+    size_t n = src.read(buf, MIN(len, sizeof(buf)));
+    if (!n || compactFile.write(buf, n) != n) break;
+    len -= n;
+  }
+  src.close();
+  return !len;
+}
+
+// merges presets.log into a new presets.json, one preset per call unless finish is set
+// returns true once done (or if there was nothing to do)
+static bool compactPresetLog(bool finish)
+{
+  if (!compactRunning) {
+    if (!presetIndexReady()) return false;
+    if (!presetLogSize && !presetLogDamaged) return true;
+    updateFSInfo();
+    if (presetsFileSize + presetLogSize + 4096 > (fsBytesTotal - fsBytesUsed)) { errorFlag = ERR_FS_QUOTA; return false; }
+    compactIndex = (presetindexentry_t*)calloc(presetIndexSize ? presetIndexSize : 1, sizeof(presetindexentry_t));
+    compactFile = WLED_FS.open(PRESETS_TMP, "w");
+    if (!compactIndex || !compactFile) {
+      if (compactFile) compactFile.close();
+      free(compactIndex);
+      compactIndex = nullptr;
+      return false;
+    }
+    compactFile.print(F("{\"0\":{}")); // dummy object, see file.cpp
+    compactId = 1;
+    compactRunning = true;
+    DEBUGFS_PRINTLN(F("Preset compaction started."));
+  }
+
+  do {
+    if (compactId < presetIndexSize) {
+      const presetindexentry_t *e = getPresetIndex(compactId);
+      if (e) {
+        char key[8];
+        sprintf_P(key, PSTR(",\"%d\":"), compactId);
+        compactFile.print(key);
+        compactIndex[compactId].offset = compactFile.position();
+        compactIndex[compactId].length = e->length;
+        if (!copyPresetData(e->inLog ? PRESETS_LOG : PRESETS_FILE, e->offset, e->length)) {
+          errorFlag = ERR_FS_GENERAL;
+          abortCompaction();
+          return false;
+        }
+      }
+      compactId++;
+      continue;
+    }
+
+    // all presets copied
+    if (presetExports) return false; // wait until merged views are sent, log offsets must stay valid
+    compactFile.print('}');
+    size_t size = compactFile.position();
+    compactFile.close();
+    if (!WLED_FS.rename(PRESETS_TMP, PRESETS_FILE)) {
+      // should not happen with LittleFS, tmp file is recovered at boot if power is lost in between
+      WLED_FS.remove(PRESETS_FILE);
+      if (!WLED_FS.rename(PRESETS_TMP, PRESETS_FILE)) { compactRunning = false; errorFlag = ERR_FS_GENERAL; return false; }
+    }
+    WLED_FS.remove(PRESETS_LOG); // a power loss before this replays the log on the new file, which is harmless
+    free(presetIndex);
+    presetIndex = compactIndex;
+    compactIndex = nullptr;
+    presetsFileSize = size;
+    presetLogSize = 0;
+    presetLogRecords = 0;
+    presetLogDamaged = false;
+    compactRunning = false;
+    presetCompactions++;
+    DEBUGFS_PRINTLN(F("Preset compaction done."));
+    return true;
+  } while (finish);
+  return false;
+}
+
+// called once per loop(): compacts presets.log when no presets were written for a while
+void handlePresetLog()
+{
+  handleDiscard();
+  if (!compactRunning && (!presetLogSize || millis() - presetLastWrite < PRESET_LOG_IDLE)) return;
+  if (fileDoc || !requestJSONBufferLock(19)) return; // index must not change while another task uses it
+  compactPresetLog(false);
+  releaseJSONBufferLock();
+}
+
+// called at boot (before presets.json may be created)
+void buildPresetIndex()
+{
+  // power loss during compaction: new presets.json is complete only if the old one was removed
+  if (WLED_FS.exists(PRESETS_TMP)) {
+    if (!WLED_FS.exists(PRESETS_FILE)) WLED_FS.rename(PRESETS_TMP, PRESETS_FILE);
+    else                               WLED_FS.remove(PRESETS_TMP);
+  }
+  if (loadPresetIndex() && presetLogDamaged) {
+    DEBUGFS_PRINTLN(F("Preset log damaged, compacting."));
+    compactPresetLog(true);
+  }
+}
+
+// presets.json was replaced as a whole, records in presets.log are obsolete (processed from loop() or next access)
+void discardPresetLog()
+{
+  presetLogDiscard = true;
+}
+
+// merged view of presets.json and presets.log (built from a snapshot of the index)
+struct PresetExport {
+  presetindexentry_t *entries = nullptr;
+  uint16_t count = 0;
+  uint16_t id = 0;      // preset being sent
+  size_t   sent = 0;    // bytes of it (key included) already sent
+  bool     done = false;
+  File     base, log;
+  ~PresetExport() {
+    free(entries);
+    if (base) base.close();
+    if (log) log.close();
+    presetExports--;
+  }
+
+  size_t keyLen(uint16_t i, char *key) { return sprintf_P(key, PSTR(",\"%d\":"), i); }
+
+  size_t fill(uint8_t *buf, size_t maxLen) {
+    size_t pos = 0;
+    while (pos < maxLen && !done) {
+      if (id == 0) { // opening bracket and dummy object
+        static const char head[] PROGMEM = "{\"0\":{}";
+        size_t l = strlen_P(head);
+        size_t n = MIN(l - sent, maxLen - pos);
+        memcpy_P(buf + pos, head + sent, n);
+        pos += n; sent += n;
+        if (sent == l) { id++; sent = 0; }
+        continue;
+      }
+      if (id >= count) { // closing bracket
+        buf[pos++] = '}';
+        done = true;
+        break;
+      }
+      const presetindexentry_t &e = entries[id];
+      if (!e.offset) { id++; continue; }
+      char key[8];
+      size_t kl = keyLen(id, key);
+      if (sent < kl) {
+        size_t n = MIN(kl - sent, maxLen - pos);
+        memcpy(buf + pos, key + sent, n);
+        pos += n; sent += n;
+        continue;
+      }
+      File &src = e.inLog ? log : base;
+      if (!src) src = WLED_FS.open(e.inLog ? PRESETS_LOG : PRESETS_FILE, "r");
+      if (!src) break;
+      size_t done = sent - kl;
+      src.seek(e.offset + done);
+      size_t n = src.read(buf + pos, MIN(e.length - done, maxLen - pos));
+      if (!n) break;
+      pos += n; sent += n;
+      if (sent == kl + e.length) { id++; sent = 0; }
+    }
+    return pos;
+  }
+};
+
+// serves /presets.json if there are presets in the log, returns false if the file can be sent as is
+bool servePresetsJson(AsyncWebServerRequest *request, const String &contentType)
+{
+  if (!presetLogSize || presetLogDiscard) return false;
+  if (!requestJSONBufferLock(19)) {
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return true;
+  }
+  if (!presetIndexReady() || !presetLogSize) { releaseJSONBufferLock(); return false; }
+  std::shared_ptr<PresetExport> exp = std::make_shared<PresetExport>();
+  presetExports++;
+  exp->count = presetIndexSize;
+  exp->entries = (presetindexentry_t*)malloc(presetIndexSize * sizeof(presetindexentry_t) + 1);
+  if (!exp->entries) {
+    releaseJSONBufferLock();
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return true;
+  }
+  memcpy(exp->entries, presetIndex, presetIndexSize * sizeof(presetindexentry_t));
+  releaseJSONBufferLock();
+
+  size_t len = 8; // {"0":{}}
+  char key[8];
+  for (uint16_t i = 1; i < exp->count; i++) if (exp->entries[i].offset) len += exp->keyLen(i, key) + exp->entries[i].length;
+  AsyncWebServerResponse *response = request->beginResponse(contentType, len, [exp](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+    return exp->fill(buf, maxLen);
+  });
+  response->addHeader(F("Cache-Control"), F("no-store"));
+  request->send(response);
+  return true;
+}
+
+// info.fs.plog: [log bytes, log records, compactions]
+void serializePresetLogInfo(JsonObject root)
+{
+  JsonArray a = root.createNestedArray(F("plog"));
+  a.add(presetLogSize);
+  a.add(presetLogRecords);
+  a.add(presetCompactions);
+}
@@ -20,6 +20,127 @@ static const char *getFileName(bool persist = true) {
   return persist ? "/presets.json" : "/tmp.json";
 }
 
+/*
+ * Cache of the presets used by the active playlist, kept as MessagePack so advancing the playlist
+ * needs neither flash access nor JSON text parsing. Filled from handlePresets() after a playlist
+ * was loaded, least recently used entries are dropped if the memory budget is exceeded.
+ */
+#ifndef WLED_PRESET_CACHE_BYTES
+  #ifdef ESP8266
+    #define WLED_PRESET_CACHE_BYTES 2048
+  #else
+    #define WLED_PRESET_CACHE_BYTES 16384
+  #endif
+#endif
+#define PRESET_CACHE_ENTRIES 16
+#define PRESET_CACHE_PSRAM_BYTES 65536 // budget if PSRAM is available
+
+typedef struct PresetCacheEntry {
+  uint8_t *data;     // MessagePack (nullptr = unused)
+  uint16_t len;
+  uint8_t  preset;
+  uint32_t lastUsed;
+} presetcacheentry_t;
+
+static presetcacheentry_t presetCache[PRESET_CACHE_ENTRIES];
+static size_t        presetCacheBytes = 0;
+static uint32_t      presetCacheTick = 0;
+static unsigned long presetCacheTime = 0;  // presetsModifiedTime the cache is valid for
+static volatile bool presetCacheDirty = false;
+static int16_t       presetCacheFillIdx = -1; // next playlist entry to cache (-1 = done)
+
+static size_t presetCacheBudget() {
+  #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
+  if (psramFound()) return PRESET_CACHE_PSRAM_BYTES;
+  #endif
+  return WLED_PRESET_CACHE_BYTES;
+}
+
+static void freeCachedPreset(presetcacheentry_t &e) {
+  if (!e.data) return;
+  free(e.data);
+  e.data = nullptr;
+  presetCacheBytes -= e.len;
+  e.len = 0;
+}
+
+// drops all cached presets (presets.json changed, playlist loaded or unloaded)
+// may be called from network callbacks, the cache is cleared by handlePresets()
+void clearPresetCache() {
+  presetCacheDirty = true;
+}
+
+static void checkPresetCache() {
+  if (!presetCacheDirty && presetCacheTime == presetsModifiedTime) return;
+  presetCacheDirty = false;
+  for (auto &e : presetCache) freeCachedPreset(e);
+  presetCacheTime = presetsModifiedTime;
+  presetCacheFillIdx = currentPlaylist >= 0 ? 0 : -1;
+}
+
+static presetcacheentry_t *findCachedPreset(uint8_t preset, bool touch = true) {
+  for (auto &e : presetCache) {
+    if (!e.data || e.preset != preset) continue;
+    if (touch) e.lastUsed = ++presetCacheTick;
+    return &e;
+  }
+  return nullptr;
+}
+
+static bool isPlaylistPreset(uint8_t preset) {
+  for (byte i = 0, ps; (ps = getPlaylistPreset(i)); i++) if (ps == preset) return true;
+  return false;
+}
+
+// stores preset object, evicting least recently used entries if allowed
+static bool cachePreset(uint8_t preset, JsonObject obj, bool evict) {
+  if (obj.isNull() || obj["win"]) return false; // HTTP API presets are not worth it
+  size_t len = measureMsgPack(obj);
+  size_t budget = presetCacheBudget();
+  if (len > UINT16_MAX || len > budget/2) return false;
+
+  presetcacheentry_t *slot = nullptr;
+  while (true) {
+    presetcacheentry_t *lru = nullptr;
+    slot = nullptr;
+    for (auto &e : presetCache) {
+      if (!e.data) { if (!slot) slot = &e; continue; }
+      if (!lru || e.lastUsed < lru->lastUsed) lru = &e;
+    }
+    if (slot && presetCacheBytes + len <= budget) break;
+    if (!evict || !lru) return false;
+    DEBUG_PRINT(F("Preset cache evict: ")); DEBUG_PRINTLN(lru->preset);
+    freeCachedPreset(*lru);
+  }
+
+  #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
+  if (psramFound())
+    slot->data = (uint8_t*) ps_malloc(len);
+  else
+  #endif
+    slot->data = (uint8_t*) malloc(len);
+  if (!slot->data) return false;
+  slot->len = serializeMsgPack(obj, slot->data, len);
+  slot->preset = preset;
+  slot->lastUsed = ++presetCacheTick;
+  presetCacheBytes += slot->len;
+  DEBUG_PRINTF("Preset %d cached (%u bytes, %u total).\n", preset, slot->len, presetCacheBytes);
+  return true;
+}
+
+// caches one playlist preset per call (presets are read while loop() is otherwise idle)
+static void fillPresetCache() {
+  uint8_t ps = getPlaylistPreset(presetCacheFillIdx);
+  if (!ps || currentPlaylist < 0) { presetCacheFillIdx = -1; return; }
+  if (ps > 250 || findCachedPreset(ps, false)) { presetCacheFillIdx++; return; }
+
+  if (!requestJSONBufferLock(9)) return;
+  bool full = readObjectFromFileUsingId(getFileName(), ps, fileDoc) && !cachePreset(ps, fileDoc->as<JsonObject>(), false);
+  releaseJSONBufferLock();
+  // stop once the budget is used up, LRU will take over while the playlist runs
+  presetCacheFillIdx = full ? -1 : presetCacheFillIdx + 1;
+}
+
 static void doSaveState() {
   bool persist = (presetToSave < 251);
   const char *filename = getFileName(persist);
@@ -67,7 +188,7 @@ static void doSaveState() {
   #endif
   writeObjectToFileUsingId(filename, presetToSave, fileDoc);
 
-  if (persist) presetsModifiedTime = toki.second(); //unix time
+  if (persist) { presetsModifiedTime = toki.second(); clearPresetCache(); } //unix time
   releaseJSONBufferLock();
   updateFSInfo();
 
@@ -136,7 +257,12 @@ void handlePresets()
     return;
   }
 
-  if (presetToApply == 0 || fileDoc) return; // no preset waiting to apply, or JSON buffer is already allocated, return to loop until free
+  if (fileDoc) return; // JSON buffer is already allocated, return to loop until free
+  checkPresetCache();
+  if (presetToApply == 0) { // no preset waiting to apply
+    if (presetCacheFillIdx >= 0) fillPresetCache();
+    return;
+  }
 
   bool changePreset = false;
   uint8_t tmpPreset = presetToApply; // store temporary since deserializeState() may call applyPreset()
@@ -154,14 +280,20 @@ void handlePresets()
   DEBUG_PRINT(F("Applying preset: "));
   DEBUG_PRINTLN(tmpPreset);
 
+  presetcacheentry_t *cached = tmpPreset < 255 ? findCachedPreset(tmpPreset) : nullptr;
   #ifdef ARDUINO_ARCH_ESP32
   if (tmpPreset==255 && tmpRAMbuffer!=nullptr) {
     deserializeJson(*fileDoc,tmpRAMbuffer);
     errorFlag = ERR_NONE;
   } else
   #endif
+  if (cached) {
+    deserializeMsgPack(*fileDoc, (const uint8_t*)cached->data, cached->len); // copies strings, cache may be cleared by deserializeState()
+    errorFlag = ERR_NONE;
+  } else
   {
   errorFlag = readObjectFromFileUsingId(filename, tmpPreset, fileDoc) ? ERR_NONE : ERR_FS_PLOAD;
+  if (!errorFlag && tmpPreset < 255 && currentPlaylist >= 0 && isPlaylistPreset(tmpPreset)) cachePreset(tmpPreset, fileDoc->as<JsonObject>(), true);
   }
   fdo = fileDoc->as<JsonObject>();
 
@@ -220,7 +352,7 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
   } else {
     // this is a playlist or API call
     if (sObj[F("playlist")].isNull()) {
-      // we will save API call immediately (often causes presets.json corruption)
+      // we will save API call immediately (appended to preset log)
       presetToSave = 0;
       if (index > 250 || !fileDoc) return; // cannot save API calls to temporary preset (255)
       sObj.remove("o");
@@ -232,6 +364,7 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
       initPresetsFile(); // just in case if someone deleted presets.json using /edit
       writeObjectToFileUsingId(getFileName(index<255), index, fileDoc);
       presetsModifiedTime = toki.second(); //unix time
+      clearPresetCache();
       updateFSInfo();
     } else {
       // store playlist
@@ -246,5 +379,6 @@ void deletePreset(byte index) {
   StaticJsonDocument<24> empty;
   writeObjectToFileUsingId(getFileName(), index, &empty);
   presetsModifiedTime = toki.second(); //unix time
+  clearPresetCache();
   updateFSInfo();
 }
\ No newline at end of file
@@ -107,6 +107,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       char aw[4] = "AW"; aw[2] = 48+s; aw[3] = 0; //auto white mode
       char wo[4] = "WO"; wo[2] = 48+s; wo[3] = 0; //channel swap
       char sp[4] = "SP"; sp[2] = 48+s; sp[3] = 0; //bus clock speed (DotStar & PWM)
+      char ma[4] = "MA"; ma[2] = 48+s; ma[3] = 0; //bus max current (own power supply)
       if (!request->hasArg(lp)) {
         DEBUG_PRINT(F("No data for "));
         DEBUG_PRINTLN(s);
@@ -154,7 +155,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       // actual finalization is done in WLED::loop() (removing old busses and adding new)
       // this may happen even before this loop is finished so we do "doInitBusses" after the loop
       if (busConfigs[s] != nullptr) delete busConfigs[s];
-      busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freqHz, useGlobalLedBuffer);
+      busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freqHz, useGlobalLedBuffer, request->arg(ma).toInt());
       busesChanged = true;
     }
     //doInitBusses = busesChanged; // we will do that below to ensure all input data is processed
@@ -249,6 +250,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     fadeTransition = request->hasArg(F("TF"));
     modeBlending = request->hasArg(F("EB"));
+    modeBlendBuffers = request->hasArg(F("EBB"));
     t = request->arg(F("TD")).toInt();
     if (t >= 0) transitionDelayDefault = t;
     strip.paletteFade = request->hasArg(F("PF"));
@@ -303,6 +305,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     receiveNotificationEffects = request->hasArg(F("RX"));
     receiveSegmentOptions = request->hasArg(F("SO"));
     receiveSegmentBounds = request->hasArg(F("SG"));
+    clockSyncEnabled = request->hasArg(F("CK"));
     receiveNotifications = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects || receiveSegmentOptions);
     notifyDirectDefault = request->hasArg(F("SD"));
     notifyDirect = notifyDirectDefault;
@@ -313,6 +316,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     t = request->arg(F("UR")).toInt();
     if ((t>=0) && (t<30)) udpNumRetries = t;
+    notifierDelta = request->hasArg(F("SV"));
 
 
     nodeListEnabled = request->hasArg(F("NL"));
@@ -335,12 +339,29 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     if (t >= 0  && t <= 200) e131Priority = t;
     t = request->arg(F("DM")).toInt();
     if (t >= DMX_MODE_DISABLED && t <= DMX_MODE_PRESET) DMXMode = t;
+    t = request->arg(F("FT")).toInt();
+    if (t >= 5  && t <= 1000) realtimeFrameTimeout = t;
+    t = request->arg(F("EO")).toInt();
+    if (t > 0  && t <= 63999) e131OutUniverse = t;
+    t = request->arg(F("EQ")).toInt();
+    if (t >= 0  && t <= 200) e131OutPriority = t;
+    t = request->arg(F("EY")).toInt();
+    if (t >= 0  && t <= 63999) e131OutSyncUniverse = t;
+    t = request->arg(F("EI")).toInt();
+    if (t >= 0  && t <= 5000) realtimeOutPacing = t;
     t = request->arg(F("ET")).toInt();
     if (t > 99  && t <= 65000) realtimeTimeoutMs = t;
     arlsForceMaxBri = request->hasArg(F("FB"));
     arlsDisableGammaCorrection = request->hasArg(F("RG"));
+    bool stats = request->hasArg(F("TS"));
+    if (stats && !realtimeStats) resetRtStats();
+    realtimeStats = stats;
     t = request->arg(F("WO")).toInt();
     if (t >= -255  && t <= 255) arlsOffset = t;
+    t = request->arg(F("RP")).toInt();
+    if (t > 0  && t <= 255) udpRxMaxPackets = t;
+    t = request->arg(F("RM")).toInt();
+    if (t >= 0  && t <= 100) udpRxBudgetMs = t;
 
     alexaEnabled = request->hasArg(F("AL"));
     strlcpy(alexaInvocationName, request->arg(F("AI")).c_str(), 33);
@@ -41,8 +41,10 @@ ESPAsyncE131::ESPAsyncE131(e131_packet_callback_function callback) {
 bool ESPAsyncE131::begin(bool multicast, uint16_t port, uint16_t universe, uint8_t n) {
   bool success = false;
 
+  _multicast = multicast;
   if (multicast) {
 		success = initMulticast(port, universe, n);
+		if (success && _syncUniverse) setMembership(_syncUniverse, true);
 	} else {
     success = initUnicast(port);
 	}
@@ -50,6 +52,13 @@ bool ESPAsyncE131::begin(bool multicast, uint16_t port, uint16_t universe, uint8
   return success;
 }
 
+void ESPAsyncE131::setSyncUniverse(uint16_t universe) {
+  if (universe == _syncUniverse) return;
+  if (_multicast && _syncUniverse) setMembership(_syncUniverse, false);
+  _syncUniverse = universe;
+  if (_multicast && _syncUniverse) setMembership(_syncUniverse, true);
+}
+
 /////////////////////////////////////////////////////////
 //
 // Private init() members
@@ -91,6 +100,17 @@ bool ESPAsyncE131::initMulticast(uint16_t port, uint16_t universe, uint8_t n) {
   return success;
 }
 
+void ESPAsyncE131::setMembership(uint16_t universe, bool join) {
+  ip4_addr_t ifaddr;
+  ip4_addr_t multicast_addr;
+
+  ifaddr.addr = static_cast<uint32_t>(Network.localIP());
+  multicast_addr.addr = static_cast<uint32_t>(IPAddress(239, 255,
+    ((universe >> 8) & 0xff), ((universe >> 0) & 0xff)));
+  if (join) igmp_joingroup(&ifaddr, &multicast_addr);
+  else      igmp_leavegroup(&ifaddr, &multicast_addr);
+}
+
 /////////////////////////////////////////////////////////
 //
 // Packet parsing - Private
@@ -110,8 +130,11 @@ void ESPAsyncE131::parsePacket(AsyncUDPPacket _packet) {
 	if (protocol == P_ARTNET) {
 		if (memcmp(sbuff->art_id, ESPAsyncE131::ART_ID, sizeof(sbuff->art_id)))
 			error = true; //not "Art-Net"
-		if (sbuff->art_opcode != ARTNET_OPCODE_OPDMX && sbuff->art_opcode != ARTNET_OPCODE_OPPOLL)
-			error = true; //not a DMX or poll packet
+		if (sbuff->art_opcode != ARTNET_OPCODE_OPDMX && sbuff->art_opcode != ARTNET_OPCODE_OPPOLL && sbuff->art_opcode != ARTNET_OPCODE_OPSYNC)
+			error = true; //not a DMX, poll or sync packet
+	} else if (htonl(sbuff->root_vector) == ESPAsyncE131::VECTOR_ROOT_EXTENDED) { //E1.31 synchronization packet
+		if (htonl(sbuff->frame_vector) != ESPAsyncE131::VECTOR_EXTENDED_SYNC)
+			error = true; //universe discovery is not supported
 	} else { //E1.31 error handling
 		if (htonl(sbuff->root_vector) != ESPAsyncE131::VECTOR_ROOT)
 			error = true;
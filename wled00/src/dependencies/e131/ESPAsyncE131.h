@@ -59,6 +59,7 @@ typedef struct ip_addr ip4_addr_t;
 #define ARTNET_OPCODE_OPDMX 0x5000
 #define ARTNET_OPCODE_OPPOLL 0x2000
 #define ARTNET_OPCODE_OPPOLLREPLY 0x2100
+#define ARTNET_OPCODE_OPSYNC 0x5200
 
 #define P_E131   0
 #define P_ARTNET 1
@@ -209,12 +210,17 @@ class ESPAsyncE131 {
     static const uint32_t VECTOR_ROOT = 4;
     static const uint32_t VECTOR_FRAME = 2;
     static const uint8_t VECTOR_DMP = 2;
+    static const uint32_t VECTOR_ROOT_EXTENDED = 8;
+    static const uint32_t VECTOR_EXTENDED_SYNC = 1;
 
     AsyncUDP        udp;        // AsyncUDP
+    bool            _multicast = false;
+    uint16_t        _syncUniverse = 0; // synchronization universe whose multicast group is joined (0 = none)
 
     // Internal Initializers
     bool initUnicast(uint16_t port);
     bool initMulticast(uint16_t port, uint16_t universe, uint8_t n = 1);
+    void setMembership(uint16_t universe, bool join);
 
     // Packet parser callback
     void parsePacket(AsyncUDPPacket _packet);
@@ -226,6 +232,10 @@ class ESPAsyncE131 {
 
     // Generic UDP listener, no physical or IP configuration
     bool begin(bool multicast, uint16_t port = E131_DEFAULT_PORT, uint16_t universe = 1, uint8_t n = 1);
+
+    // Joins the multicast group of the E1.31 synchronization universe (leaving the previous one), 0 = none.
+    // Only has an effect in multicast mode, kept across begin(). Call from loop().
+    void setSyncUniverse(uint16_t universe);
 };
 
 // Class to track e131 package priority
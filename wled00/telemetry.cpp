@@ -0,0 +1,154 @@
+#include "wled.h"
+
+/*
+ * Realtime input telemetry (DDP, E1.31, Art-Net, TPM2, Adalight, Hyperion, UDP)
+ * Counters are indexed by REALTIME_MODE_* of the source. All hooks return immediately if disabled.
+ */
+
+#define RT_STATS_SOURCES     (REALTIME_MODE_DDP +1)
+#define RT_JITTER_BUCKETS    8  // frame interval deviation: <0.5, <1, <2, <4, <8, <16, <32, >=32 ms
+
+typedef struct RealtimeSourceStats {
+  uint32_t packets;          // datagrams (or serial frames) accepted
+  uint32_t frames;           // frames handed to show()
+  uint32_t outOfSequence;    // packets dropped because of sequence number
+  uint32_t late;             // packets/frames dropped because newer data superseded them
+  uint16_t pps, fps;         // rates over the last second
+  uint16_t winPackets, winFrames;
+  uint16_t jitter[RT_JITTER_BUCKETS];
+  uint32_t lastFrameUs;      // micros() of last frame
+  uint32_t meanIntervalUs;   // running mean of frame interval
+  uint32_t pendingMs;        // millis() of first packet not yet shown (valid if bit set in rtStatsPending)
+  uint16_t latencyAvg;       // ingest to show() in ms (running mean)
+  uint16_t latencyMax;
+} rtsourcestats_t;
+
+static rtsourcestats_t rtStats[RT_STATS_SOURCES];
+static unsigned long   rtStatsWindow  = 0;
+static uint16_t        rtStatsPending = 0;  // sources with a packet not yet shown (bit mask)
+
+static const char rtSourceNames[] PROGMEM = "\0\0udp\0hyperion\0e131\0adalight\0artnet\0tpm2\0ddp";
+
+void rtStatsPacket(uint8_t mode) {
+  if (!realtimeStats || mode >= RT_STATS_SOURCES) return;
+  rtsourcestats_t &s = rtStats[mode];
+  s.packets++;
+  s.winPackets++;
+  if (!(rtStatsPending & (1 << mode))) { s.pendingMs = millis(); rtStatsPending |= 1 << mode; }
+}
+
+void rtStatsFrame(uint8_t mode) {
+  if (!realtimeStats || mode >= RT_STATS_SOURCES) return;
+  rtsourcestats_t &s = rtStats[mode];
+  s.frames++;
+  s.winFrames++;
+  uint32_t now = micros();
+  if (s.lastFrameUs) {
+    uint32_t interval = now - s.lastFrameUs;
+    if (!s.meanIntervalUs) s.meanIntervalUs = interval;
+    uint32_t dev = interval > s.meanIntervalUs ? interval - s.meanIntervalUs : s.meanIntervalUs - interval;
+    unsigned b = 0;
+    for (uint32_t limit = 500; b < RT_JITTER_BUCKETS-1 && dev >= limit; limit <<= 1) b++;
+    if (s.jitter[b] < UINT16_MAX) s.jitter[b]++;
+    s.meanIntervalUs = (s.meanIntervalUs * 15 + interval) >> 4;
+  }
+  s.lastFrameUs = now;
+}
+
+void rtStatsDrop(uint8_t mode, bool late) {
+  if (!realtimeStats || mode >= RT_STATS_SOURCES) return;
+  if (late) rtStats[mode].late++;
+  else      rtStats[mode].outOfSequence++;
+}
+
+// called once per loop(): latency sampling and per second rates
+void handleRtStats() {
+  if (!realtimeStats) return;
+  const uint32_t lastShow = strip.getLastShow();
+  for (uint8_t m = 0; rtStatsPending >> m; m++) {
+    rtsourcestats_t &s = rtStats[m];
+    // getLastShow() is taken after the busses were written: a show() stamped in the millisecond of the packet
+    // may have been before it, so only later ones count (latency is never too low, at worst one frame high)
+    if ((rtStatsPending & (1 << m)) && int32_t(lastShow - s.pendingMs) > 0) {
+      uint32_t lat = lastShow - s.pendingMs;
+      if (lat > UINT16_MAX) lat = UINT16_MAX;
+      s.latencyAvg = s.latencyAvg ? (s.latencyAvg * 7 + lat) >> 3 : lat;
+      if (lat > s.latencyMax) s.latencyMax = lat;
+      rtStatsPending &= ~(1 << m);
+    }
+  }
+  if (millis() - rtStatsWindow < 1000) return;
+  rtStatsWindow = millis();
+  for (auto &s : rtStats) {
+    s.pps = s.winPackets; s.winPackets = 0;
+    s.fps = s.winFrames;  s.winFrames  = 0;
+  }
+}
+
+void resetRtStats() {
+  memset(rtStats, 0, sizeof(rtStats));
+  rtStatsPending = 0;
+}
+
+static const char *rtSourceName(uint8_t mode) {
+  const char *n = rtSourceNames;
+  for (uint8_t i = 0; i < mode; i++) n += strlen_P(n) + 1;
+  return n;
+}
+
+// info.rt: {"<source>":[pps,fps,packets,frames,out-of-sequence,late,latency avg,latency max,[jitter histogram]]}
+void serializeRtStats(JsonObject root) {
+  if (!realtimeStats) return;
+  JsonObject rt = root.createNestedObject("rt");
+  for (uint8_t m = REALTIME_MODE_UDP; m < RT_STATS_SOURCES; m++) {
+    const rtsourcestats_t &s = rtStats[m];
+    if (!s.packets && !s.outOfSequence && !s.late) continue;
+    char name[10];
+    strncpy_P(name, rtSourceName(m), sizeof(name)-1);
+    name[sizeof(name)-1] = '\0';
+    JsonArray a = rt.createNestedArray(name);
+    a.add(s.pps);
+    a.add(s.fps);
+    a.add(s.packets);
+    a.add(s.frames);
+    a.add(s.outOfSequence);
+    a.add(s.late);
+    a.add(s.latencyAvg);
+    a.add(s.latencyMax);
+    JsonArray h = a.createNestedArray();
+    for (unsigned b = 0; b < RT_JITTER_BUCKETS; b++) h.add(s.jitter[b]);
+  }
+}
+
+// compact binary form: 'T', version, source count, then per source
+// mode(1) pps(2) fps(2) packets(4) frames(4) oos(4) late(4) latAvg(2) latMax(2) jitter(8*2), little endian
+#define RT_STATS_WS_RECORD (1 + 2*2 + 4*4 + 2*2 + RT_JITTER_BUCKETS*2)
+size_t rtStatsBinarySize() {
+  return 3 + RT_STATS_WS_RECORD * (RT_STATS_SOURCES - REALTIME_MODE_UDP);
+}
+
+size_t fillRtStatsBinary(uint8_t *buf) {
+  size_t pos = 3;
+  uint8_t count = 0;
+  auto put16 = [&](uint16_t v) { buf[pos++] = v; buf[pos++] = v >> 8; };
+  auto put32 = [&](uint32_t v) { put16(v); put16(v >> 16); };
+  for (uint8_t m = REALTIME_MODE_UDP; m < RT_STATS_SOURCES; m++) {
+    const rtsourcestats_t &s = rtStats[m];
+    if (!s.packets && !s.outOfSequence && !s.late) continue;
+    buf[pos++] = m;
+    put16(s.pps);
+    put16(s.fps);
+    put32(s.packets);
+    put32(s.frames);
+    put32(s.outOfSequence);
+    put32(s.late);
+    put16(s.latencyAvg);
+    put16(s.latencyMax);
+    for (unsigned b = 0; b < RT_JITTER_BUCKETS; b++) put16(s.jitter[b]);
+    count++;
+  }
+  buf[0] = 'T';
+  buf[1] = 1; // version
+  buf[2] = count;
+  return pos;
+}
@@ -8,8 +8,21 @@
 #define SEG_OFFSET (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE))
 #define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+0)
 #define UDP_IN_MAXSIZE 1472
+
+// delta notifier (version 13): only changed segment field groups, multicast, coalesced
+#define UDP_DELTA_PROTOCOL 13                 // first byte, legacy receivers only accept 0 (notifier) so they ignore these packets
+#define UDP_DELTA_HDR      23
+#define WLEDDELTASIZE      (UDP_DELTA_HDR+(MAX_NUM_SEGMENTS*(UDP_SEG_SIZE+1)))
+#define NOTIFIER_DELTA_INTERVAL 50            // ms, changes within this interval are sent as one packet
+#define NOTIFIER_DELTA_FULL 30000             // ms, all fields are (re)sent once the last full packet is older (late joiners)
+#define NOTIFIER_MCAST     239, 255, 87, 76   // multicast group of the delta notifier
+
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
 
+static void fillSegmentRecord(byte *rec, Segment &selseg);
+static void syncTimeFromNotifier(uint8_t source, uint32_t sec, uint16_t ms, bool timebaseUpdated);
+static byte notifyDeltaMode = 0; // call mode of coalesced, not yet sent delta notification
+
 void notify(byte callMode, bool followUp)
 {
   if (!udpConnected) return;
@@ -26,6 +39,10 @@ void notify(byte callMode, bool followUp)
     case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
     default: return;
   }
+  if (notifierDelta) { // sent from handleNotifications() once per NOTIFIER_DELTA_INTERVAL
+    notifyDeltaMode = callMode;
+    return;
+  }
   byte udpOut[WLEDPACKETSIZE];
   Segment& mainseg = strip.getMainSegment();
   udpOut[0] = 0; //0: wled notifier protocol 1: WARLS protocol
@@ -97,41 +114,7 @@ void notify(byte callMode, bool followUp)
     if (!selseg.isActive()) continue;
     uint16_t ofs = 41 + s*UDP_SEG_SIZE; //start of segment offset byte
     udpOut[0 +ofs] = s;
-    udpOut[1 +ofs] = selseg.start >> 8;
-    udpOut[2 +ofs] = selseg.start & 0xFF;
-    udpOut[3 +ofs] = selseg.stop >> 8;
-    udpOut[4 +ofs] = selseg.stop & 0xFF;
-    udpOut[5 +ofs] = selseg.grouping;
-    udpOut[6 +ofs] = selseg.spacing;
-    udpOut[7 +ofs] = selseg.offset >> 8;
-    udpOut[8 +ofs] = selseg.offset & 0xFF;
-    udpOut[9 +ofs] = selseg.options & 0x8F; //only take into account selected, mirrored, on, reversed, reverse_y (for 2D); ignore freeze, reset, transitional
-    udpOut[10+ofs] = selseg.opacity;
-    udpOut[11+ofs] = selseg.mode;
-    udpOut[12+ofs] = selseg.speed;
-    udpOut[13+ofs] = selseg.intensity;
-    udpOut[14+ofs] = selseg.palette;
-    udpOut[15+ofs] = R(selseg.colors[0]);
-    udpOut[16+ofs] = G(selseg.colors[0]);
-    udpOut[17+ofs] = B(selseg.colors[0]);
-    udpOut[18+ofs] = W(selseg.colors[0]);
-    udpOut[19+ofs] = R(selseg.colors[1]);
-    udpOut[20+ofs] = G(selseg.colors[1]);
-    udpOut[21+ofs] = B(selseg.colors[1]);
-    udpOut[22+ofs] = W(selseg.colors[1]);
-    udpOut[23+ofs] = R(selseg.colors[2]);
-    udpOut[24+ofs] = G(selseg.colors[2]);
-    udpOut[25+ofs] = B(selseg.colors[2]);
-    udpOut[26+ofs] = W(selseg.colors[2]);
-    udpOut[27+ofs] = selseg.cct;
-    udpOut[28+ofs] = (selseg.options>>8) & 0xFF; //mirror_y, transpose, 2D mapping & sound
-    udpOut[29+ofs] = selseg.custom1;
-    udpOut[30+ofs] = selseg.custom2;
-    udpOut[31+ofs] = selseg.custom3 | (selseg.check1<<5) | (selseg.check2<<6) | (selseg.check3<<7);
-    udpOut[32+ofs] = selseg.startY >> 8;
-    udpOut[33+ofs] = selseg.startY & 0xFF;
-    udpOut[34+ofs] = selseg.stopY >> 8;
-    udpOut[35+ofs] = selseg.stopY & 0xFF;
+    fillSegmentRecord(udpOut + ofs, selseg);
     ++s;
   }
 
@@ -149,6 +132,309 @@ void notify(byte callMode, bool followUp)
   notificationCount = followUp ? notificationCount + 1 : 0;
 }
 
+// segment fields as sent in notifier packets (version 12 layout, rec[0] is set by the caller)
+static void fillSegmentRecord(byte *rec, Segment &selseg)
+{
+  rec[1]  = selseg.start >> 8;
+  rec[2]  = selseg.start & 0xFF;
+  rec[3]  = selseg.stop >> 8;
+  rec[4]  = selseg.stop & 0xFF;
+  rec[5]  = selseg.grouping;
+  rec[6]  = selseg.spacing;
+  rec[7]  = selseg.offset >> 8;
+  rec[8]  = selseg.offset & 0xFF;
+  rec[9]  = selseg.options & 0x8F; //only take into account selected, mirrored, on, reversed, reverse_y (for 2D); ignore freeze, reset, transitional
+  rec[10] = selseg.opacity;
+  rec[11] = selseg.mode;
+  rec[12] = selseg.speed;
+  rec[13] = selseg.intensity;
+  rec[14] = selseg.palette;
+  rec[15] = R(selseg.colors[0]);
+  rec[16] = G(selseg.colors[0]);
+  rec[17] = B(selseg.colors[0]);
+  rec[18] = W(selseg.colors[0]);
+  rec[19] = R(selseg.colors[1]);
+  rec[20] = G(selseg.colors[1]);
+  rec[21] = B(selseg.colors[1]);
+  rec[22] = W(selseg.colors[1]);
+  rec[23] = R(selseg.colors[2]);
+  rec[24] = G(selseg.colors[2]);
+  rec[25] = B(selseg.colors[2]);
+  rec[26] = W(selseg.colors[2]);
+  rec[27] = selseg.cct;
+  rec[28] = (selseg.options>>8) & 0xFF; //mirror_y, transpose, 2D mapping & sound
+  rec[29] = selseg.custom1;
+  rec[30] = selseg.custom2;
+  rec[31] = selseg.custom3 | (selseg.check1<<5) | (selseg.check2<<6) | (selseg.check3<<7);
+  rec[32] = selseg.startY >> 8;
+  rec[33] = selseg.startY & 0xFF;
+  rec[34] = selseg.stopY >> 8;
+  rec[35] = selseg.stopY & 0xFF;
+}
+
+// segment record bytes belonging to each SEG_DIFFERS_* group (delta notifier), 0 terminated
+static const byte deltaGroupBytes[][14] PROGMEM = {
+  {10},                                     // SEG_DIFFERS_BRI
+  {9, 28},                                  // SEG_DIFFERS_OPT
+  {15,16,17,18,19,20,21,22,23,24,25,26,27}, // SEG_DIFFERS_COL (incl. CCT)
+  {11,12,13,14,29,30,31},                   // SEG_DIFFERS_FX
+  {1,2,3,4,32,33,34,35},                    // SEG_DIFFERS_BOUNDS
+  {5,6,7,8}                                 // SEG_DIFFERS_GSO
+};
+#define DELTA_GROUPS (sizeof(deltaGroupBytes)/sizeof(deltaGroupBytes[0]))
+
+static byte *deltaOut  = nullptr; // last delta packet (kept for retransmissions) followed by the segment snapshot
+static size_t deltaLen = 0;
+static bool deltaSnapValid = false;
+static unsigned long deltaLastFull = 0;
+
+// timebase and system time are refreshed for every (re)transmission
+static void fillDeltaTime(byte *out)
+{
+  uint32_t t = millis() + strip.timebase;
+  out[9]  = (t >> 24) & 0xFF;
+  out[10] = (t >> 16) & 0xFF;
+  out[11] = (t >>  8) & 0xFF;
+  out[12] = (t >>  0) & 0xFF;
+  out[13] = toki.getTimeSource();
+  Toki::Time tm = toki.getTime();
+  out[14] = (tm.sec >> 24) & 0xFF;
+  out[15] = (tm.sec >> 16) & 0xFF;
+  out[16] = (tm.sec >>  8) & 0xFF;
+  out[17] = (tm.sec >>  0) & 0xFF;
+  out[18] = (tm.ms >> 8) & 0xFF;
+  out[19] = (tm.ms >> 0) & 0xFF;
+}
+
+/*
+ * Delta notifier packet (version 13):
+ * 0: UDP_DELTA_PROTOCOL, 1: call mode, 2: version, 3: sync groups, 4: brightness, 5-6: nightlight active & delay,
+ * 7-8: transition, 9-12: timebase, 13: time source, 14-17: unix time, 18-19: ms, 20: main segment, 21: flags (bit 0 full, bit 1 no CCT),
+ * 22: number of segment entries, then per segment: id, SEG_DIFFERS_* mask, bytes of the groups in mask (see deltaGroupBytes).
+ */
+static void sendDeltaNotification(byte callMode)
+{
+  if (!deltaOut) deltaOut = (byte*) malloc(WLEDDELTASIZE + MAX_NUM_SEGMENTS*UDP_SEG_SIZE);
+  if (!deltaOut) return;
+  byte *snapshot = deltaOut + WLEDDELTASIZE;
+  bool full = !deltaSnapValid || millis() - deltaLastFull > NOTIFIER_DELTA_FULL;
+
+  deltaOut[0] = UDP_DELTA_PROTOCOL;
+  deltaOut[1] = callMode;
+  deltaOut[2] = 13;
+  deltaOut[3] = syncGroups;
+  deltaOut[4] = bri;
+  deltaOut[5] = nightlightActive;
+  deltaOut[6] = nightlightDelayMins;
+  deltaOut[7] = transitionDelay >> 8;
+  deltaOut[8] = transitionDelay & 0xFF;
+  fillDeltaTime(deltaOut);
+  deltaOut[20] = strip.getMainSegmentId();
+  deltaOut[21] = full | (!strip.hasCCTBus() << 1);
+
+  size_t pos = UDP_DELTA_HDR, entries = 0, nsegs = MIN(strip.getSegmentsNum(), MAX_NUM_SEGMENTS);
+  for (size_t i = 0; i < nsegs; i++) {
+    Segment &selseg = strip.getSegment(i);
+    byte rec[UDP_SEG_SIZE];
+    byte *snap = snapshot + i*UDP_SEG_SIZE;
+    rec[0] = i;
+    fillSegmentRecord(rec, selseg);
+    byte mask = 0;
+    for (size_t g = 0; g < DELTA_GROUPS; g++) {
+      for (const byte *b = deltaGroupBytes[g]; pgm_read_byte(b); b++) {
+        byte o = pgm_read_byte(b);
+        if (full || rec[o] != snap[o]) { mask |= 1 << g; break; }
+      }
+    }
+    memcpy(snap, rec, UDP_SEG_SIZE);
+    if (!mask || (full && !selseg.isActive())) continue; // removed segments are sent once (their bounds changed)
+    deltaOut[pos++] = i;
+    deltaOut[pos++] = mask;
+    for (size_t g = 0; g < DELTA_GROUPS; g++) {
+      if (!(mask & (1 << g))) continue;
+      for (const byte *b = deltaGroupBytes[g]; pgm_read_byte(b); b++) deltaOut[pos++] = rec[pgm_read_byte(b)];
+    }
+    entries++;
+  }
+  deltaOut[22] = entries;
+  deltaLen = pos;
+  deltaSnapValid = true;
+  if (full) deltaLastFull = millis();
+
+  notifierUdp.beginPacket(IPAddress(NOTIFIER_MCAST), udpPort);
+  notifierUdp.write(deltaOut, deltaLen);
+  notifierUdp.endPacket();
+  notificationSentCallMode = callMode;
+  notificationSentTime = millis();
+  notificationCount = 0;
+}
+
+// coalesced delta notifications and their retransmissions
+static void handleDeltaNotifications()
+{
+  if (!udpConnected) return;
+  if (notifyDeltaMode && millis() - notificationSentTime >= NOTIFIER_DELTA_INTERVAL) {
+    sendDeltaNotification(notifyDeltaMode);
+    notifyDeltaMode = 0;
+  } else if (deltaLen && notificationCount < udpNumRetries && millis() - notificationSentTime > 250) {
+    fillDeltaTime(deltaOut);
+    notifierUdp.beginPacket(IPAddress(NOTIFIER_MCAST), udpPort);
+    notifierUdp.write(deltaOut, deltaLen);
+    notifierUdp.endPacket();
+    notificationSentTime = millis();
+    notificationCount++;
+  } else if (deltaSnapValid && millis() - deltaLastFull > NOTIFIER_DELTA_FULL) {
+    sendDeltaNotification(notificationSentCallMode); // periodic full state, also without changes
+  }
+}
+
+//adjust system time, but only if sender is more accurate than self
+static void syncTimeFromNotifier(uint8_t source, uint32_t sec, uint16_t ms, bool timebaseUpdated)
+{
+  Toki::Time tm;
+  tm.sec = sec;
+  tm.ms = ms;
+  if (source > toki.getTimeSource()) { //if sender's time source is more accurate
+    toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
+    uint8_t ts = TOKI_TS_UDP;
+    if (source > 99) ts = TOKI_TS_UDP_NTP;
+    else if (source >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
+    toki.setTime(tm, ts);
+  } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
+    Toki::Time myTime = toki.getTime();
+    uint32_t diff = toki.msDifference(tm, myTime);
+    strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
+    if (toki.isLater(tm, myTime)) {
+      strip.timebase += diff;
+    } else {
+      strip.timebase -= diff;
+    }
+  }
+}
+
+// apply a delta notification; follows the same receive options as the full (version 12) notifier
+static void handleDeltaNotification(const byte *udpIn, size_t len)
+{
+  if (len < UDP_DELTA_HDR || udpIn[1] > 199) return;
+  if (millis() - notificationSentTime < 1000) return; //ignore notification if received within a second after sending a notification ourselves
+  if (!(receiveGroups & udpIn[3])) return;
+
+  bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
+  bool applyEffects = (receiveNotificationEffects || !someSel);
+  bool applyColors  = (receiveNotificationColor || !someSel);
+
+  if (fadeTransition) {
+    jsonTransitionOnce = true;
+    strip.setTransition((udpIn[7] << 8) | udpIn[8]);
+  }
+  if (applyEffects && currentPlaylist >= 0) unloadPlaylist();
+
+  size_t pos = UDP_DELTA_HDR;
+  for (size_t e = 0; e < udpIn[22]; e++) {
+    if (pos + 2 > len) break;
+    byte id = udpIn[pos++];
+    byte mask = udpIn[pos++];
+    bool valid = id < strip.getSegmentsNum();
+    Segment& selseg = strip.getSegment(valid ? id : strip.getMainSegmentId());
+    byte rec[UDP_SEG_SIZE];
+    rec[0] = id;
+    fillSegmentRecord(rec, selseg); // groups not in the packet keep their local values
+    for (size_t g = 0; g < DELTA_GROUPS; g++) {
+      if (!(mask & (1 << g))) continue;
+      for (const byte *b = deltaGroupBytes[g]; pgm_read_byte(b); b++) {
+        if (pos >= len) return; // truncated
+        rec[pgm_read_byte(b)] = udpIn[pos++];
+      }
+    }
+    if (!valid) continue;
+
+    if (!receiveSegmentOptions && !receiveSegmentBounds) {
+      if (id != udpIn[20]) continue; // only the sender's main segment is used
+      if (applyColors && (mask & SEG_DIFFERS_COL)) {
+        strip.setColor(0, RGBW32(rec[15], rec[16], rec[17], rec[18]));
+        strip.setColor(1, RGBW32(rec[19], rec[20], rec[21], rec[22]));
+        strip.setColor(2, RGBW32(rec[23], rec[24], rec[25], rec[26]));
+        if (!(udpIn[21] & 0x02)) strip.setCCT(rec[27]);
+      }
+      if (applyEffects && (mask & SEG_DIFFERS_FX)) {
+        for (size_t i = 0; i < strip.getSegmentsNum(); i++) {
+          Segment& seg = strip.getSegment(i);
+          if (!seg.isActive() || !seg.isSelected()) continue;
+          seg.setMode(rec[11]);
+          seg.speed = rec[12];
+          seg.intensity = rec[13];
+          seg.setPalette(rec[14]);
+        }
+      }
+      continue;
+    }
+
+    if (!selseg.isActive() || !selseg.isSelected()) continue; //do not apply to non selected segments
+    if (receiveSegmentOptions) {
+      // ignore selected as it may be used as indicator of which segments to sync, freeze & reset should never be synced
+      if (mask & SEG_DIFFERS_OPT) selseg.options = (selseg.options & 0b0000000000110001U) | (rec[28]<<8) | (rec[9] & 0b11001110U);
+      if (mask & SEG_DIFFERS_BRI) selseg.setOpacity(rec[10]);
+      if (applyEffects && (mask & SEG_DIFFERS_FX)) {
+        strip.setMode(id,  rec[11]);
+        selseg.speed     = rec[12];
+        selseg.intensity = rec[13];
+        selseg.palette   = rec[14];
+        selseg.custom1   = rec[29];
+        selseg.custom2   = rec[30];
+        selseg.custom3   = rec[31] & 0x1F;
+        selseg.check1    = (rec[31]>>5) & 0x1;
+        selseg.check2    = (rec[31]>>6) & 0x1;
+        selseg.check3    = (rec[31]>>7) & 0x1;
+      }
+      if (applyColors && (mask & SEG_DIFFERS_COL)) {
+        selseg.setColor(0, RGBW32(rec[15], rec[16], rec[17], rec[18]));
+        selseg.setColor(1, RGBW32(rec[19], rec[20], rec[21], rec[22]));
+        selseg.setColor(2, RGBW32(rec[23], rec[24], rec[25], rec[26]));
+        selseg.setCCT(rec[27]);
+      }
+    }
+    if (((mask & SEG_DIFFERS_BOUNDS) && receiveSegmentBounds) || (mask & SEG_DIFFERS_GSO)) {
+      bool bounds = receiveSegmentBounds;
+      bool gso    = receiveSegmentOptions;
+      selseg.setUp(bounds ? (rec[1] << 8 | rec[2])   : selseg.start,
+                   bounds ? (rec[3] << 8 | rec[4])   : selseg.stop,
+                   gso    ? rec[5] : selseg.grouping,
+                   gso    ? rec[6] : selseg.spacing,
+                   bounds ? (rec[7] << 8 | rec[8])   : selseg.offset,
+                   bounds ? (rec[32] << 8 | rec[33]) : selseg.startY,
+                   bounds ? (rec[34] << 8 | rec[35]) : selseg.stopY);
+    }
+  }
+  stateChanged = true;
+
+  bool timebaseUpdated = false;
+  if (applyEffects && !clockSyncFollow(notifierUdp.remoteIP())) {
+    uint32_t t = (udpIn[9] << 24) | (udpIn[10] << 16) | (udpIn[11] << 8) | (udpIn[12]);
+    t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
+    t -= millis();
+    strip.timebase = t;
+    timebaseUpdated = true;
+  }
+  syncTimeFromNotifier(udpIn[13], (udpIn[14] << 24) | (udpIn[15] << 16) | (udpIn[16] << 8) | (udpIn[17]), (udpIn[18] << 8) | (udpIn[19]), timebaseUpdated);
+
+  nightlightActive = udpIn[5];
+  if (nightlightActive) nightlightDelayMins = udpIn[6];
+
+  if (receiveNotificationBrightness || !someSel) bri = udpIn[4];
+  stateUpdated(CALL_MODE_NOTIFICATION);
+}
+
+// notifier socket joins the delta notifier multicast group (still receives broadcasts and unicast of older nodes)
+bool beginNotifierUdp()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  if (notifierUdp.beginMulticast(IPAddress(NOTIFIER_MCAST), udpPort)) return true;
+  #else
+  if (notifierUdp.beginMulticast(Network.localIP(), IPAddress(NOTIFIER_MCAST), udpPort)) return true;
+  #endif
+  return notifierUdp.begin(udpPort);
+}
+
 void realtimeLock(uint32_t timeoutMs, byte md)
 {
   if (!realtimeMode && !realtimeOverride) {
@@ -212,69 +498,25 @@ void sendTPM2Ack() {
 }
 
 
-void handleNotifications()
+// hyperion / raw RGB (always a complete frame)
+static void handleHyperionPacket(uint8_t *lbuf, size_t packetSize)
 {
-  IPAddress localIP;
-
-  //send second notification if enabled
-  if(udpConnected && (notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)){
-    notify(notificationSentCallMode,true);
-  }
-
-  if (e131NewData && millis() - strip.getLastShow() > 15)
-  {
-    e131NewData = false;
-    strip.show();
-  }
-
-  //unlock strip when realtime UDP times out
-  if (realtimeMode && millis() > realtimeTimeout) exitRealtime();
-
-  //receive UDP notifications
-  if (!udpConnected) return;
-
-  bool isSupp = false;
-  size_t packetSize = notifierUdp.parsePacket();
-  if (!packetSize && udp2Connected) {
-    packetSize = notifier2Udp.parsePacket();
-    isSupp = true;
-  }
-
-  //hyperion / raw RGB
-  if (!packetSize && udpRgbConnected) {
-    packetSize = rgbUdp.parsePacket();
-    if (packetSize) {
-      if (!receiveDirect) return;
-      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return;
-      realtimeIP = rgbUdp.remoteIP();
-      DEBUG_PRINTLN(rgbUdp.remoteIP());
-      uint8_t lbuf[packetSize];
-      rgbUdp.read(lbuf, packetSize);
-      realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
-      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      uint16_t id = 0;
-      uint16_t totalLen = strip.getLengthTotal();
-      for (size_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
-      }
-      if (!(realtimeMode && useMainSegmentOnly)) strip.show();
-      return;
-    }
-  }
-
-  if (!(receiveNotifications || receiveDirect)) return;
-
-  localIP = Network.localIP();
-  //notifier and UDP realtime
-  if (!packetSize || packetSize > UDP_IN_MAXSIZE) return;
-  if (!isSupp && notifierUdp.remoteIP() == localIP) return; //don't process broadcasts we send ourselves
+  if (packetSize < 3) return;
+  realtimeIP = rgbUdp.remoteIP();
+  DEBUG_PRINTLN(rgbUdp.remoteIP());
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
+  rtStatsPacket(REALTIME_MODE_HYPERION);
+  if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+  rtStatsFrame(REALTIME_MODE_HYPERION);
+  setRealtimePixels(0, lbuf, MIN(packetSize/3, strip.getLengthTotal()), 3);
+  if (!(realtimeMode && useMainSegmentOnly)) strip.show();
+}
 
-  uint8_t udpIn[packetSize +1];
-  uint16_t len;
-  if (isSupp) len = notifier2Udp.read(udpIn, packetSize);
-  else        len =  notifierUdp.read(udpIn, packetSize);
+// notifier and UDP realtime, udpIn must have room for a terminating 0 (packetSize+1)
+static void handleUdpPacket(uint8_t *udpIn, size_t packetSize, bool isSupp)
+{
+  IPAddress localIP = Network.localIP();
+  uint16_t len = packetSize;
 
   // WLED nodes info notifications
   if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
@@ -307,6 +549,9 @@ void handleNotifications()
     return;
   }
 
+  // effect timebase sync between nodes
+  if (handleClockSyncPacket(udpIn, len, isSupp ? notifier2Udp.remoteIP() : notifierUdp.remoteIP())) return;
+
   //wled notifier, ignore if realtime packets active
   if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
   {
@@ -428,7 +673,7 @@ void handleNotifications()
         stateChanged = true;
       }
 
-      if (applyEffects && version > 5) {
+      if (applyEffects && version > 5 && !clockSyncFollow(isSupp ? notifier2Udp.remoteIP() : notifierUdp.remoteIP())) {
         uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
         t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
         t -= millis();
@@ -440,25 +685,7 @@ void handleNotifications()
     //adjust system time, but only if sender is more accurate than self
     if (version > 7 && version < 200)
     {
-      Toki::Time tm;
-      tm.sec = (udpIn[30] << 24) | (udpIn[31] << 16) | (udpIn[32] << 8) | (udpIn[33]);
-      tm.ms = (udpIn[34] << 8) | (udpIn[35]);
-      if (udpIn[29] > toki.getTimeSource()) { //if sender's time source is more accurate
-        toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
-        uint8_t ts = TOKI_TS_UDP;
-        if (udpIn[29] > 99) ts = TOKI_TS_UDP_NTP;
-        else if (udpIn[29] >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
-        toki.setTime(tm, ts);
-      } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
-        Toki::Time myTime = toki.getTime();
-        uint32_t diff = toki.msDifference(tm, myTime);
-        strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
-        if (toki.isLater(tm, myTime)) {
-          strip.timebase += diff;
-        } else {
-          strip.timebase -= diff;
-        }
-      }
+      syncTimeFromNotifier(udpIn[29], (udpIn[30] << 24) | (udpIn[31] << 16) | (udpIn[32] << 8) | (udpIn[33]), (udpIn[34] << 8) | (udpIn[35]), timebaseUpdated);
     }
 
     nightlightActive = udpIn[6];
@@ -469,6 +696,12 @@ void handleNotifications()
     return;
   }
 
+  //wled delta notifier (version 13)
+  if (udpIn[0] == UDP_DELTA_PROTOCOL && !realtimeMode && receiveNotifications) {
+    handleDeltaNotification(udpIn, len);
+    return;
+  }
+
   if (!receiveDirect) return;
 
   //TPM2.NET
@@ -484,6 +717,7 @@ void handleNotifications()
 
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     realtimeLock(realtimeTimeoutMs, REALTIME_MODE_TPM2NET);
+    rtStatsPacket(REALTIME_MODE_TPM2NET);
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
     tpmPacketCount++; //increment the packet count
@@ -493,18 +727,11 @@ void handleNotifications()
 
     uint16_t id = (tpmPayloadFrameSize/3)*(packetNum-1); //start LED
     uint16_t totalLen = strip.getLengthTotal();
-    for (size_t i = 6; i < tpmPayloadFrameSize + 4U; i += 3)
-    {
-      if (id < totalLen)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-      else break;
-    }
+    if (id < totalLen) setRealtimePixels(id, udpIn + 6, MIN(tpmPayloadFrameSize/3, totalLen - id), 3);
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
+      rtStatsFrame(REALTIME_MODE_TPM2NET);
       strip.show();
     }
     return;
@@ -524,7 +751,9 @@ void handleNotifications()
     } else {
       realtimeLock(udpIn[1]*1000 +1, REALTIME_MODE_UDP);
     }
+    rtStatsPacket(REALTIME_MODE_UDP);
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+    rtStatsFrame(REALTIME_MODE_UDP);
 
     uint16_t totalLen = strip.getLengthTotal();
     if ((udpIn[0] == 1) && (packetSize > 5)) //warls - avoiding infinite "for" loop (unsigned underflow)    
@@ -535,40 +764,18 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2) //drgb
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, udpIn + 2, MIN((packetSize-2)/3, totalLen), 3);
     } else if ((udpIn[0] == 3) && (packetSize > 5)) //drgbw - avoiding infinite "for" loop (unsigned underflow)
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-
-        id++; if (id >= totalLen) break;
-      }
-    } else if (udpIn[0] == 4) //dnrgb
+      setRealtimePixels(0, udpIn + 2, MIN((packetSize-2)/4, totalLen), 4);
+    } else if (udpIn[0] == 4 && packetSize > 4) //dnrgb
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-    } else if (udpIn[0] == 5) //dnrgbw
+      if (id < totalLen) setRealtimePixels(id, udpIn + 4, MIN((packetSize-4)/3, totalLen - id), 3);
+    } else if (udpIn[0] == 5 && packetSize > 4) //dnrgbw
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      if (id < totalLen) setRealtimePixels(id, udpIn + 4, MIN((packetSize-4)/4, totalLen - id), 4);
     }
     strip.show();
     return;
@@ -591,6 +798,93 @@ void handleNotifications()
   }
 }
 
+// drgb & drgbw packets replace the whole strip so only the newest queued one needs to be shown
+static inline bool isFullFrameUdpPacket(const uint8_t *udpIn, size_t len, bool hyperion)
+{
+  return hyperion || (receiveDirect && len > 2 && (udpIn[0] == 2 || udpIn[0] == 3));
+}
+
+static uint8_t *udpRxFrame = nullptr; // newest complete realtime frame of the socket being drained (allocated on first use)
+
+// reads every queued datagram of a socket (within udpRxMaxPackets/udpRxBudgetMs)
+// complete realtime frames are coalesced, everything else is handled in order
+static void drainUdpSocket(WiFiUDP &udp, bool isSupp, bool hyperion, unsigned &budget, unsigned long started)
+{
+  size_t frameLen = 0;
+  const IPAddress localIP = Network.localIP();
+  while (budget && millis() - started <= udpRxBudgetMs) {
+    size_t packetSize = udp.parsePacket();
+    if (!packetSize) break;
+    budget--;
+    udpRxStats.received++;
+    if (packetSize > UDP_IN_MAXSIZE || (!hyperion && !isSupp && udp.remoteIP() == localIP)) { //don't process broadcasts we send ourselves
+      if (packetSize > UDP_IN_MAXSIZE) udpRxStats.dropped++;
+      continue;
+    }
+    if (hyperion ? !receiveDirect : !(receiveNotifications || receiveDirect)) continue;
+
+    uint8_t udpIn[packetSize +1];
+    size_t len = udp.read(udpIn, packetSize);
+    if (isFullFrameUdpPacket(udpIn, len, hyperion)) {
+      if (!udpRxFrame) udpRxFrame = (uint8_t*) malloc(UDP_IN_MAXSIZE +1);
+      if (udpRxFrame) {
+        if (frameLen) { // older frame will never be shown
+          udpRxStats.coalesced++;
+          rtStatsDrop(hyperion ? REALTIME_MODE_HYPERION : REALTIME_MODE_UDP, true);
+        }
+        memcpy(udpRxFrame, udpIn, len);
+        frameLen = len;
+        continue;
+      }
+    }
+    if (frameLen) { // keep order: pending frame first
+      if (hyperion) handleHyperionPacket(udpRxFrame, frameLen);
+      else          handleUdpPacket(udpRxFrame, frameLen, isSupp);
+      frameLen = 0;
+    }
+    if (hyperion) handleHyperionPacket(udpIn, len);
+    else          handleUdpPacket(udpIn, len, isSupp);
+  }
+  if (frameLen) {
+    if (hyperion) handleHyperionPacket(udpRxFrame, frameLen);
+    else          handleUdpPacket(udpRxFrame, frameLen, isSupp);
+  }
+}
+
+void handleNotifications()
+{
+  //send second notification if enabled
+  if (notifierDelta) handleDeltaNotifications();
+  else if(udpConnected && (notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)){
+    notify(notificationSentCallMode,true);
+  }
+
+  handleE131Frame();
+  handleRtStats();
+  handleClockSync();
+  if (e131NewData && millis() - strip.getLastShow() > 15)
+  {
+    e131NewData = false;
+    strip.show();
+  }
+
+  //unlock strip when realtime UDP times out
+  if (realtimeMode && millis() > realtimeTimeout) exitRealtime();
+
+  //receive UDP notifications, realtime & hyperion: drain all sockets within budget
+  if (!udpConnected) return;
+
+  unsigned budget = udpRxMaxPackets;
+  const unsigned long started = millis();
+  drainUdpSocket(notifierUdp, false, false, budget, started);
+  if (udp2Connected)   drainUdpSocket(notifier2Udp, true, false, budget, started);
+  if (udpRgbConnected) drainUdpSocket(rgbUdp, false, true, budget, started);
+
+  const uint16_t depth = udpRxMaxPackets - budget;
+  udpRxStats.depth = depth;
+  if (depth > udpRxStats.maxDepth) udpRxStats.maxDepth = depth;
+}
+
 
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
 {
@@ -611,6 +905,37 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
   }
 }
 
+// bulk version of setRealtimePixel(): count pixels of 3 (RGB) or 4 (RGBW) channels starting at pixel i
+void setRealtimePixels(uint16_t i, const byte *data, uint16_t count, uint8_t channels)
+{
+  int pix = int(i) + arlsOffset;
+  if (pix < 0) { // skip pixels shifted out by negative offset
+    if (count <= -pix) return;
+    data  += -pix * channels;
+    count += pix;
+    pix    = 0;
+  }
+  Segment &seg = strip.getMainSegment();
+  const int limit = useMainSegmentOnly ? seg.length() : strip.getLengthTotal();
+  if (pix >= limit) return;
+  if (count > limit - pix) count = limit - pix;
+
+  const bool gc = !arlsDisableGammaCorrection && gammaCorrectCol;
+  uint32_t buf[64];
+  while (count) {
+    const unsigned n = count > 64 ? 64 : count;
+    for (unsigned k = 0; k < n; k++, data += channels) {
+      byte w = channels > 3 ? data[3] : 0;
+      buf[k] = gc ? RGBW32(gamma8(data[0]), gamma8(data[1]), gamma8(data[2]), gamma8(w))
+                  : RGBW32(data[0], data[1], data[2], w);
+    }
+    if (useMainSegmentOnly) seg.setPixelSpan(pix, n, buf);
+    else                    strip.setPixelColors(pix, n, buf);
+    pix   += n;
+    count -= n;
+  }
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
@@ -690,7 +1015,7 @@ void sendSysInfoUDP()
 
 
 /*********************************************************************************************\
- * Art-Net, DDP, E131 output - work in progress
+ * Art-Net, DDP, E1.31 output
 \*********************************************************************************************/
 
 #define DDP_HEADER_LEN 10
@@ -711,147 +1036,230 @@ void sendSysInfoUDP()
 // 1440 channels per packet
 #define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
 
-//
-// Send real time UDP updates to the specified client
-//
-// type   - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
-// client - the IP address to send to
-// length - the number of pixels
-// buffer - a buffer of at least length*4 bytes long
-// isRGBW - true if the buffer contains 4 components per pixel
-
 static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
 static const size_t ART_NET_HEADER_SIZE = 12;
 static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
+#define ART_NET_DMX_HEADER_LEN  (ART_NET_HEADER_SIZE + 6)
+
+// E1.31 (sACN) output, offsets are defined in ESPAsyncE131.h
+#define E131_SYNC_PACKET_LEN    49
+#define E131_OUT_UNIVERSE_MAX   63999 // highest universe allowed by E1.31, data beyond it is not sent
+#define E131_VECTOR_ROOT_DATA   0x00000004
+#define E131_VECTOR_ROOT_EXT    0x00000008
+#define E131_VECTOR_FRAME_DATA  0x00000002
+#define E131_VECTOR_FRAME_SYNC  0x00000001
+
+static byte    *e131OutSeq      = nullptr; // sequence number of each universe sent, indexed by universe - e131OutSeqStart
+static uint16_t e131OutSeqLen   = 0;       // number of universes e131OutSeq holds
+static uint16_t e131OutSeqStart = 0;       // e131OutUniverse the sequence numbers belong to
+static byte   e131SyncSeq = 0;
+static const byte E131_ACN_ID[] PROGMEM = {0x41,0x53,0x43,0x2d,0x45,0x31,0x2e,0x31,0x37,0x00,0x00,0x00}; // "ASC-E1.17"
+
+// All headers (10 bytes DDP, 18 bytes Art-Net, 126 bytes E1.31) are 2 bytes short of a multiple of 4,
+// so datagrams are assembled 2 bytes into a 32 bit aligned buffer which keeps channel data word aligned.
+#define UDP_OUT_HEADROOM   2
+#define UDP_OUT_PACKET_MAX (DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET) // largest datagram of all protocols
+
+#define UDP_OUT_PACING_MAX 2000 // us, max. time spent waiting for realtimeOutPacing per bus and frame
+
+static WiFiUDP        outUdp;                 // reused for all network bus output
+static uint32_t      *outBuffer  = nullptr;   // datagram assembly buffer, allocated on first use
+static unsigned long  outLastSent = 0;        // micros() of last datagram (for pacing)
+static unsigned       outPacingLeft = 0;      // us of pacing left for the frame being sent
+
+static inline void put16(byte *p, uint16_t v) { p[0] = v >> 8; p[1] = v; }
+static inline void put32(byte *p, uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; }
+
+static byte *getOutPacket() {
+  if (!outBuffer) outBuffer = (uint32_t*) malloc(UDP_OUT_HEADROOM + UDP_OUT_PACKET_MAX);
+  return outBuffer ? (byte*)outBuffer + UDP_OUT_HEADROOM : nullptr;
+}
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
-
-  WiFiUDP ddpUdp;
-
-  switch (type) {
-    case 0: // DDP
-    {
-      // calculate the number of UDP packets we need to send
-      size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
-      size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
-
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
-
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-        if (sequenceNumber > 15) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
-        // the amount of data is AFTER the header in the current packet
-        size_t packetSize = DDP_CHANNELS_PER_PACKET;
-
-        uint8_t flags = DDP_FLAGS1_VER1;
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet, set the push flag
-          // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
-          flags = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
-          if (channelCount % DDP_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
-          }
-        }
-
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
-        // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
-        // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+// one block write per datagram, optionally spaced by realtimeOutPacing microseconds
+// (once the pacing budget of the frame is used up remaining datagrams are sent back to back)
+static bool sendOutPacket(IPAddress client, uint16_t port, const byte *pkt, size_t len) {
+  if (realtimeOutPacing && outPacingLeft) {
+    unsigned long elapsed = micros() - outLastSent;
+    if (elapsed < realtimeOutPacing) {
+      unsigned wait = MIN(realtimeOutPacing - elapsed, outPacingLeft);
+      delayMicroseconds(wait);
+      outPacingLeft -= wait;
+    }
+  }
+  bool ok = outUdp.beginPacket(client, port);
+  if (ok) {
+    outUdp.write(pkt, len);
+    ok = outUdp.endPacket();
+  }
+  outLastSent = micros();
+  if (!ok) DEBUG_PRINTF("Realtime output to port %u failed.\n", (unsigned)port);
+  return ok;
+}
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
+// data packet header, only rebuilt when one of the settings it contains changes
+static byte  e131Header[E131_DMP_DATA + 1];
+static bool  e131HeaderValid    = false;
+static byte  e131HeaderPriority = 0;
+static uint16_t e131HeaderSync  = 0;
+static char  e131HeaderSource[sizeof(serverDescription)];
+
+// preamble, ACN packet identifier and CID (from MAC address) shared by data and sync packets
+static void e131WriteRootHeader(byte *pkt, uint32_t vector) {
+  static byte cid[16] = {0};
+  if (!cid[0]) {
+    memcpy_P(cid, PSTR("WLED-sACN-"), 10);              // last 6 bytes are unique per device
+    WiFi.macAddress(cid + 10);
+  }
+  put16(pkt, 0x0010);                                   // preamble size
+  put16(pkt + E131_ROOT_POSTAMBLE_SIZE, 0x0000);        // postamble size
+  memcpy_P(pkt + E131_ROOT_ID, E131_ACN_ID, sizeof(E131_ACN_ID));
+  put32(pkt + E131_ROOT_VECTOR, vector);
+  memcpy(pkt + E131_ROOT_CID, cid, sizeof(cid));
+}
 
-        channel += packetSize;
-      }
-    } break;
+// fills everything but lengths, sequence number, universe and channel data
+static void e131WriteDataHeader(byte *pkt) {
+  if (!e131HeaderValid || e131HeaderPriority != e131OutPriority || e131HeaderSync != e131OutSyncUniverse
+      || strncmp(e131HeaderSource, serverDescription, sizeof(e131HeaderSource))) {
+    byte *hdr = e131Header;
+    memset(hdr, 0, sizeof(e131Header));
+    e131WriteRootHeader(hdr, E131_VECTOR_ROOT_DATA);
+    put32(hdr + E131_FRAME_VECTOR, E131_VECTOR_FRAME_DATA);
+    strlcpy(e131HeaderSource, serverDescription, sizeof(e131HeaderSource));
+    strncpy((char*)hdr + E131_FRAME_SOURCE, e131HeaderSource, 63);
+    hdr[E131_FRAME_PRIORITY] = e131HeaderPriority = e131OutPriority;
+    put16(hdr + E131_FRAME_RESERVED, e131HeaderSync = e131OutSyncUniverse); // synchronization address (E1.31-2016)
+    hdr[E131_DMP_VECTOR] = 0x02;                        // VECTOR_DMP_SET_PROPERTY
+    hdr[E131_DMP_TYPE]   = 0xA1;                        // address & data type
+    put16(hdr + E131_DMP_ADDR_FIRST, 0x0000);
+    put16(hdr + E131_DMP_ADDR_INC,   0x0001);
+    e131HeaderValid = true;
+  }
+  memcpy(pkt, e131Header, sizeof(e131Header));
+}
 
-    case 1: //E1.31
-    {
-    } break;
+// make room for the sequence numbers of the universes following e131OutUniverse, a new start universe starts new streams
+static bool e131OutSeqReserve(size_t universes) {
+  if (e131OutSeqStart != e131OutUniverse) {
+    if (e131OutSeq) memset(e131OutSeq, 0, e131OutSeqLen);
+    e131OutSeqStart = e131OutUniverse;
+  }
+  if (universes <= e131OutSeqLen) return true;
+  byte *seq = (byte*) realloc(e131OutSeq, universes);
+  if (!seq) return false;
+  memset(seq + e131OutSeqLen, 0, universes - e131OutSeqLen);
+  e131OutSeq    = seq;
+  e131OutSeqLen = universes;
+  return true;
+}
 
-    case 2: //ArtNet
-    {
-      // calculate the number of UDP packets we need to send
-      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
-      const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
-      const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
+static bool e131SendSync(IPAddress client) {
+  byte pkt[E131_SYNC_PACKET_LEN];
+  memset(pkt, 0, sizeof(pkt));
+  e131WriteRootHeader(pkt, E131_VECTOR_ROOT_EXT);
+  put16(pkt + E131_ROOT_FLENGTH, 0x7000 | (E131_SYNC_PACKET_LEN - E131_ROOT_FLENGTH));
+  put16(pkt + E131_FRAME_FLENGTH, 0x7000 | (E131_SYNC_PACKET_LEN - E131_FRAME_FLENGTH));
+  put32(pkt + E131_FRAME_VECTOR, E131_VECTOR_FRAME_SYNC);
+  pkt[44] = e131SyncSeq++;                              // sequence number
+  put16(pkt + 45, e131OutSyncUniverse);                 // synchronization address, 2 reserved bytes follow
+  return sendOutPacket(client, E131_DEFAULT_PORT, pkt, sizeof(pkt));
+}
 
-      uint32_t channel = 0; 
-      size_t bufferOffset = 0;
+//
+// Send real time UDP updates to the specified client
+//
+// type    - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
+// client  - the IP address to send to
+// length  - the number of pixels
+// buffer  - a buffer of at least length*4 bytes long
+// isRGBW  - true if the buffer contains 4 components per pixel
+// packets - if not null, incremented by the number of datagrams sent
+//
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW, uint16_t *packets)  {
+  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
 
-      sequenceNumber++;
+  byte *pkt = getOutPacket();
+  if (!pkt) return 1;
 
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
+  const size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B,(W?) value
+  size_t channelsPerPacket, headerLen;
+  uint16_t port;
+  switch (type) {
+    case 0:  channelsPerPacket = DDP_CHANNELS_PER_PACKET;  headerLen = DDP_HEADER_LEN;          port = DDP_DEFAULT_PORT;    break;
+    case 1:  channelsPerPacket = isRGBW?512:510;           headerLen = E131_DMP_DATA + 1;       port = E131_DEFAULT_PORT;   break; // 128 RGBW or 170 RGB LEDs per universe
+    case 2:  channelsPerPacket = isRGBW?512:510;           headerLen = ART_NET_DMX_HEADER_LEN;  port = ARTNET_DEFAULT_PORT; break;
+    default: return 1;
+  }
+  const size_t packetCount = ((channelCount-1) / channelsPerPacket) + 1;
+  size_t packetsToSend = packetCount;
+  if (type == 1) {
+    if (e131OutUniverse < 1 || e131OutUniverse > E131_OUT_UNIVERSE_MAX) return 1; // invalid start universe
+    packetsToSend = MIN(packetCount, size_t(E131_OUT_UNIVERSE_MAX - e131OutUniverse + 1));
+    if (!e131OutSeqReserve(packetsToSend)) return 1;
+  }
 
-        if (sequenceNumber > 255) sequenceNumber = 0;
+  outPacingLeft = UDP_OUT_PACING_MAX;
+  if (type == 1) e131WriteDataHeader(pkt);
+  if (type == 2) {
+    memcpy_P(pkt, ART_NET_HEADER, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
+    sequenceNumber++;
+    if (sequenceNumber > 255) sequenceNumber = 0;
+  }
 
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
+  uint32_t channel = 0; // TODO: allow specifying the start channel
+  for (size_t currentPacket = 0; currentPacket < packetsToSend; currentPacket++) {
+    // the amount of data is AFTER the header in the current packet
+    size_t packetSize = channelsPerPacket;
+    const bool last = currentPacket == (packetCount - 1U);
+    if (last && (channelCount % channelsPerPacket)) packetSize = channelCount % channelsPerPacket;
 
-        size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
+    switch (type) {
+      case 0: // DDP
+      {
+        if (sequenceNumber > 15) sequenceNumber = 0;
+        // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
+        /*0*/pkt[0] = last ? (DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH) : DDP_FLAGS1_VER1; // last packet, set the push flag
+        /*1*/pkt[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+        /*2*/pkt[2] = isRGBW ? DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+        /*3*/pkt[3] = DDP_ID_DISPLAY;
+        /*4*/put32(pkt + 4, channel); // data offset in bytes, 32-bit number, MSB first
+        /*8*/put16(pkt + 8, packetSize); // data length in bytes, 16-bit number, MSB first
+      } break;
+
+      case 1: // E1.31
+      {
+        const uint16_t universe = e131OutUniverse + currentPacket;
+        const size_t   pktLen   = headerLen + packetSize;
+        put16(pkt + E131_ROOT_FLENGTH,  0x7000 | (pktLen - E131_ROOT_FLENGTH));
+        put16(pkt + E131_FRAME_FLENGTH, 0x7000 | (pktLen - E131_FRAME_FLENGTH));
+        pkt[E131_FRAME_SEQ] = e131OutSeq[currentPacket]++;
+        put16(pkt + E131_FRAME_UNIVERSE, universe);
+        put16(pkt + E131_DMP_FLENGTH,   0x7000 | (pktLen - E131_DMP_FLENGTH));
+        put16(pkt + E131_DMP_COUNT,     packetSize + 1);
+        pkt[E131_DMP_DATA] = 0x00; // DMX start code
+      } break;
+
+      case 2: // Art-Net
+      {
+        pkt[12] = sequenceNumber & 0xFF;  // sequence number. 1..255
+        pkt[13] = 0x00;                   // physical - more an FYI, not really used for anything. 0..3
+        pkt[14] = currentPacket & 0xFF;   // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
+        pkt[15] = 0x00;                   // Universe MSB, unused.
+        put16(pkt + 16, packetSize);      // 16-bit length of channel data, MSB first
+      } break;
+    }
 
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet
-          if (channelCount % ARTNET_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % ARTNET_CHANNELS_PER_PACKET;
-          }
-        }
+    scale8_copy(pkt + headerLen, buffer + channel, packetSize, bri);
 
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+    if (!sendOutPacket(client, port, pkt, headerLen + packetSize)) return 1; // problem
+    if (packets) (*packets)++;
+    channel += packetSize;
+  }
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
-          return 1; // borked
-        }
-        channel += packetSize;
-      }
-    } break;
+  // tell E1.31 receivers to output all universes of this frame at once
+  if (type == 1 && e131OutSyncUniverse) {
+    if (!e131SendSync(client)) return 1;
+    if (packets) (*packets)++;
   }
   return 0;
 }
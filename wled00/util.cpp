@@ -198,16 +198,42 @@ bool isAsterisksOnly(const char* str, byte maxLen)
 
 
 //threading/network callback details: https://github.com/Aircoookie/WLED/pull/2336#discussion_r762276994
-bool requestJSONBufferLock(uint8_t module)
+// The JSON buffer lock serializes access to WLED state (and the global doc). Requests that only need
+// memory to parse or serialize JSON take an arena from the pool below and hold the lock just while
+// reading or applying state, so concurrent HTTP/WS requests no longer wait for each other's transfers.
+static JsonDocument    *jsonArenas[WLED_JSON_ARENAS] = {nullptr}; // [0] is doc (legacy lock), others are allocated on first use
+static volatile uint8_t jsonArenaOwner[WLED_JSON_ARENAS] = {0};
+
+static uint32_t jsonLocks = 0;         // locks taken
+static uint32_t jsonLockWaits = 0;     // locks that had to wait
+static uint32_t jsonLockWaitMs = 0;    // total wait time
+static uint16_t jsonLockMaxWaitMs = 0;
+static uint16_t jsonLockFailures = 0;  // lock timeouts
+static uint16_t jsonArenaFailures = 0; // no free (or allocatable) arena, legacy path used
+static uint8_t  jsonArenasInUse = 0;
+static uint8_t  jsonArenasMaxInUse = 0;
+
+// arenas are claimed from loop() and from the async_tcp task, owner and counters change in a critical section
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE jsonArenaMux = portMUX_INITIALIZER_UNLOCKED;
+#define JSON_ARENA_LOCK()   portENTER_CRITICAL(&jsonArenaMux)
+#define JSON_ARENA_UNLOCK() portEXIT_CRITICAL(&jsonArenaMux)
+#else
+#define JSON_ARENA_LOCK()   noInterrupts()
+#define JSON_ARENA_UNLOCK() interrupts()
+#endif
+
+static bool lockJSONBuffer(uint8_t module, JsonDocument *target, unsigned waitMs)
 {
   unsigned long now = millis();
 
-  while (jsonBufferLock && millis()-now < 1000) delay(1); // wait for a second for buffer lock
+  while (jsonBufferLock && millis()-now < waitMs) delay(1); // wait for buffer lock
 
-  if (millis()-now >= 1000) {
+  if (jsonBufferLock) {
     DEBUG_PRINT(F("ERROR: Locking JSON buffer failed! ("));
     DEBUG_PRINT(jsonBufferLock);
     DEBUG_PRINTLN(")");
+    jsonLockFailures++;
     return false; // waiting time-outed
   }
 
@@ -215,11 +241,30 @@ bool requestJSONBufferLock(uint8_t module)
   DEBUG_PRINT(F("JSON buffer locked. ("));
   DEBUG_PRINT(jsonBufferLock);
   DEBUG_PRINTLN(")");
-  fileDoc = &doc;  // used for applying presets (presets.cpp)
+  unsigned long waited = millis()-now;
+  jsonLocks++;
+  if (waited) {
+    jsonLockWaits++;
+    jsonLockWaitMs += waited;
+    if (waited > jsonLockMaxWaitMs) jsonLockMaxWaitMs = MIN(waited, UINT16_MAX);
+  }
+  fileDoc = target;  // used for applying presets (presets.cpp)
+  return true;
+}
+
+bool requestJSONBufferLock(uint8_t module)
+{
+  if (!lockJSONBuffer(module, &doc, 1000)) return false;
   doc.clear();
   return true;
 }
 
+// takes the JSON buffer lock (state access) without using doc, fileDoc will point to arena
+bool lockJSONState(uint8_t module, JsonDocument *arena, unsigned waitMs)
+{
+  return lockJSONBuffer(module, arena, waitMs);
+}
+
 
 void releaseJSONBufferLock()
 {
@@ -231,6 +276,76 @@ void releaseJSONBufferLock()
 }
 
 
+static bool canAllocateJSONArena()
+{
+  #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
+  if (psramFound()) return true;
+  #endif
+  return ESP.getFreeHeap() > 2*JSON_BUFFER_SIZE; // leave enough heap for web server & effects
+}
+
+// returns an empty JSON document from the pool without waiting, nullptr if none is available
+// (caller then falls back to requestJSONBufferLock())
+JsonDocument* acquireJSONArena(uint8_t module)
+{
+  size_t i = 1;
+  JSON_ARENA_LOCK();
+  while (i < WLED_JSON_ARENAS && jsonArenaOwner[i]) i++;
+  if (i < WLED_JSON_ARENAS) jsonArenaOwner[i] = module ? module : 255; // claimed, allocated outside the critical section
+  JSON_ARENA_UNLOCK();
+
+  if (i < WLED_JSON_ARENAS && !jsonArenas[i] && canAllocateJSONArena()) {
+    PSRAMDynamicJsonDocument *d = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+    if (d && !d->capacity()) { delete d; d = nullptr; } // JsonDocument has no public destructor
+    jsonArenas[i] = d;
+  }
+  JsonDocument *arena = i < WLED_JSON_ARENAS ? jsonArenas[i] : nullptr;
+  if (arena) arena->clear();
+
+  JSON_ARENA_LOCK();
+  if (arena) {
+    if (++jsonArenasInUse > jsonArenasMaxInUse) jsonArenasMaxInUse = jsonArenasInUse;
+  } else {
+    if (i < WLED_JSON_ARENAS) jsonArenaOwner[i] = 0;
+    if (WLED_JSON_ARENAS > 1) jsonArenaFailures++;
+  }
+  JSON_ARENA_UNLOCK();
+  DEBUG_PRINT(F("JSON arena acquired: ")); DEBUG_PRINTLN(arena ? (int)i : -1);
+  return arena;
+}
+
+void releaseJSONArena(JsonDocument *arena)
+{
+  for (size_t i = 1; i < WLED_JSON_ARENAS; i++) {
+    if (arena != jsonArenas[i] || !jsonArenaOwner[i]) continue;
+    arena->clear(); // still owned, nobody else touches it
+    JSON_ARENA_LOCK();
+    jsonArenaOwner[i] = 0;
+    if (jsonArenasInUse) jsonArenasInUse--;
+    JSON_ARENA_UNLOCK();
+    DEBUG_PRINT(F("JSON arena released: ")); DEBUG_PRINTLN(i);
+    return;
+  }
+}
+
+// info.json: [arenas (incl. doc), allocated, max pool arenas in use, locks, waited, avg wait (ms), max wait (ms), lock failures, arena failures]
+void serializeJSONArenaInfo(JsonObject root)
+{
+  uint8_t allocated = 1;
+  for (size_t i = 1; i < WLED_JSON_ARENAS; i++) if (jsonArenas[i]) allocated++;
+  JsonArray a = root.createNestedArray(F("json"));
+  a.add(WLED_JSON_ARENAS);
+  a.add(allocated);
+  a.add(jsonArenasMaxInUse);
+  a.add(jsonLocks);
+  a.add(jsonLockWaits);
+  a.add(jsonLockWaits ? jsonLockWaitMs / jsonLockWaits : 0);
+  a.add(jsonLockMaxWaitMs);
+  a.add(jsonLockFailures);
+  a.add(jsonArenaFailures);
+}
+
+
 // extracts effect mode (or palette) name from names serialized string
 // caller must provide large enough buffer for name (including SR extensions)!
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen)
@@ -527,50 +642,26 @@ um_data_t* simulateSound(uint8_t simulationId)
 }
 
 
-// enumerate all ledmapX.json files on FS and extract ledmap names if existing
+// enumerate all ledmapX.json (or .bin) files on FS and extract ledmap names if existing
 void enumerateLedmaps() {
   ledMaps = 1;
   for (size_t i=1; i<WLED_MAX_LEDMAPS; i++) {
-    char fileName[33];
-    sprintf_P(fileName, PSTR("/ledmap%d.json"), i);
-    bool isFile = WLED_FS.exists(fileName);
-
     #ifndef ESP8266
     if (ledmapNames[i-1]) { //clear old name
       delete[] ledmapNames[i-1];
       ledmapNames[i-1] = nullptr;
     }
-    #endif
 
-    if (isFile) {
+    char name[33];
+    if (getLedmapName(i, name, sizeof(name))) { // streamed, large maps do not fit the JSON buffer
       ledMaps |= 1 << i;
-
-      #ifndef ESP8266
-      if (requestJSONBufferLock(21)) {
-        if (readObjectFromFile(fileName, nullptr, &doc)) {
-          size_t len = 0;
-          if (!doc["n"].isNull()) {
-            // name field exists
-            const char *name = doc["n"].as<const char*>();
-            if (name != nullptr) len = strlen(name);
-            if (len > 0 && len < 33) {
-              ledmapNames[i-1] = new char[len+1];
-              if (ledmapNames[i-1]) strlcpy(ledmapNames[i-1], name, 33);
-            }
-          }
-          if (!ledmapNames[i-1]) {
-            char tmp[33];
-            snprintf_P(tmp, 32, PSTR("ledmap%d.json"), i);
-            len = strlen(tmp);
-            ledmapNames[i-1] = new char[len+1];
-            if (ledmapNames[i-1]) strlcpy(ledmapNames[i-1], tmp, 33);
-          }
-        }
-        releaseJSONBufferLock();
-      }
-      #endif
+      if (!name[0]) snprintf_P(name, sizeof(name), PSTR("ledmap%d.json"), i);
+      ledmapNames[i-1] = new char[strlen(name)+1];
+      if (ledmapNames[i-1]) strcpy(ledmapNames[i-1], name);
     }
-
+    #else
+    if (ledmapExists(i)) ledMaps |= 1 << i;
+    #endif
   }
 }
 
@@ -109,6 +109,7 @@ void WLED::loop()
     #endif
 
     handlePresets();
+    handlePresetLog();
     yield();
 
     if (!offMode || strip.isOffRefreshRequired())
@@ -189,6 +190,9 @@ void WLED::loop()
 
   yield();
   handleWs();
+  #ifdef WLED_ENABLE_JSONLIVE
+  handleLiveLeds();
+  #endif
   handleStatusLED();
 
   toki.resetTick();
@@ -408,9 +412,9 @@ pinManager.allocateMultiplePins(pins, sizeof(pins)/sizeof(managed_pin_type), Pin
   if (!fsinit) {
     DEBUGFS_PRINTLN(F("FS failed!"));
     errorFlag = ERR_FS_BEGIN;
-  }
+  } else buildPresetIndex(); // before presets.json may be created: recovers from power loss during compaction
 #ifdef WLED_ADD_EEPROM_SUPPORT
-  else deEEP();
+  if (fsinit) deEEP();
 #else
   initPresetsFile();
 #endif
@@ -555,7 +559,7 @@ void WLED::initAP(bool resetAP)
     DEBUG_PRINTLN(F("Init AP interfaces"));
     server.begin();
     if (udpPort > 0 && udpPort != ntpLocalPort) {
-      udpConnected = notifierUdp.begin(udpPort);
+      udpConnected = beginNotifierUdp();
     }
     if (udpRgbPort > 0 && udpRgbPort != ntpLocalPort && udpRgbPort != udpPort) {
       udpRgbConnected = rgbUdp.begin(udpRgbPort);
@@ -773,7 +777,7 @@ void WLED::initInterfaces()
   server.begin();
 
   if (udpPort > 0 && udpPort != ntpLocalPort) {
-    udpConnected = notifierUdp.begin(udpPort);
+    udpConnected = beginNotifierUdp();
     if (udpConnected && udpRgbPort != udpPort)
       udpRgbConnected = rgbUdp.begin(udpRgbPort);
     if (udpConnected && udpPort2 != udpPort && udpPort2 != udpRgbPort)
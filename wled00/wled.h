@@ -388,12 +388,14 @@ WLED_GLOBAL bool receiveNotificationColor      _INIT(true);       // apply color
 WLED_GLOBAL bool receiveNotificationEffects    _INIT(true);       // apply effects setup
 WLED_GLOBAL bool receiveSegmentOptions         _INIT(false);      // apply segment options
 WLED_GLOBAL bool receiveSegmentBounds          _INIT(false);      // apply segment bounds (start, stop, offset)
+WLED_GLOBAL bool clockSyncEnabled              _INIT(false);      // track the effect timebase of the notification sender (clock offset & drift estimation)
 WLED_GLOBAL bool notifyDirect _INIT(false);                       // send notification if change via UI or HTTP API
 WLED_GLOBAL bool notifyButton _INIT(false);                       // send if updated by button or infrared remote
 WLED_GLOBAL bool notifyAlexa  _INIT(false);                       // send notification if updated via Alexa
 WLED_GLOBAL bool notifyMacro  _INIT(false);                       // send notification for macro
 WLED_GLOBAL bool notifyHue    _INIT(true);                        // send notification if Hue light changes
 WLED_GLOBAL uint8_t udpNumRetries _INIT(0);                       // Number of times a UDP sync message is retransmitted. Increase to increase reliability
+WLED_GLOBAL bool notifierDelta _INIT(false);                      // send only changed segment fields (notifier v13) via multicast, coalesced; older nodes cannot receive these
 
 WLED_GLOBAL bool alexaEnabled _INIT(false);                       // enable device discovery by Amazon Echo
 WLED_GLOBAL char alexaInvocationName[33] _INIT("Light");          // speech control name of device. Choose something voice-to-text can understand
@@ -423,6 +425,16 @@ WLED_GLOBAL uint16_t DMXSegmentSpacing _INIT(0);                  // Number of v
 WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+WLED_GLOBAL uint16_t realtimeFrameTimeout _INIT(25);              // ms to wait for missing universes before an incomplete E1.31/Art-Net frame is shown
+WLED_GLOBAL uint32_t realtimeFramesComplete _INIT(0);             // multi-universe frame assembly statistics
+WLED_GLOBAL uint32_t realtimeFramesIncomplete _INIT(0);
+WLED_GLOBAL uint32_t realtimeFramesTorn _INIT(0);
+WLED_GLOBAL uint32_t realtimeFramesSkipped _INIT(0);
+WLED_GLOBAL bool realtimeStats _INIT(false);                      // collect realtime input telemetry (info.rt, WS 'T' messages)
+WLED_GLOBAL uint16_t e131OutUniverse _INIT(1);                    // first universe sent by E1.31 (sACN) network busses
+WLED_GLOBAL byte e131OutPriority _INIT(100);                      // E1.31 output priority (0-200)
+WLED_GLOBAL uint16_t e131OutSyncUniverse _INIT(0);                // E1.31 synchronization universe (0 = do not send sync packets)
+WLED_GLOBAL uint16_t realtimeOutPacing _INIT(0);                  // min. microseconds between network bus datagrams (0 = no pacing)
 WLED_GLOBAL uint16_t pollReplyCount _INIT(0);                     // count number of replies for ArtPoll node report
 
 // mqtt
@@ -528,6 +540,7 @@ WLED_GLOBAL byte lastRandomIndex _INIT(0);        // used to save last random co
 // transitions
 WLED_GLOBAL bool          fadeTransition          _INIT(true);    // enable crossfading brightness/color
 WLED_GLOBAL bool          modeBlending            _INIT(true);    // enable effect blending
+WLED_GLOBAL bool          modeBlendBuffers        _INIT(false);   // blended effects render into separate buffers (uses extra RAM)
 WLED_GLOBAL bool          transitionActive        _INIT(false);
 WLED_GLOBAL uint16_t      transitionDelay         _INIT(750);     // global transition duration
 WLED_GLOBAL uint16_t      transitionDelayDefault  _INIT(750);     // default transition time (stored in cfg.json)
@@ -579,6 +592,16 @@ WLED_GLOBAL bool stateChanged _INIT(false);
 
 // network
 WLED_GLOBAL bool udpConnected _INIT(false), udp2Connected _INIT(false), udpRgbConnected _INIT(false);
+WLED_GLOBAL byte udpRxMaxPackets _INIT(16);                       // max. UDP datagrams handled per loop() (all sockets)
+WLED_GLOBAL byte udpRxBudgetMs _INIT(8);                          // max. time spent receiving UDP per loop()
+struct UdpRxStats {
+  uint32_t received;   // datagrams read
+  uint32_t coalesced;  // stale realtime frames replaced by a newer queued one
+  uint32_t dropped;    // oversized datagrams
+  uint16_t depth;      // datagrams drained in last loop()
+  uint16_t maxDepth;
+};
+WLED_GLOBAL UdpRxStats udpRxStats;
 
 // ui style
 WLED_GLOBAL bool showWelcomePage _INIT(false);
@@ -186,6 +186,8 @@ void handleSerial()
         if (--count > 0) state = AdaState::Data_Red;
         else {
           realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
+          rtStatsPacket(REALTIME_MODE_ADALIGHT);
+          rtStatsFrame(REALTIME_MODE_ADALIGHT);
 
           if (!realtimeOverride) strip.show();
           state = AdaState::Header_A;
@@ -52,18 +52,26 @@ void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t
     request->_tempFile = WLED_FS.open(finalname, "w");
     DEBUG_PRINT(F("Uploading "));
     DEBUG_PRINTLN(finalname);
-    if (finalname.equals("/presets.json")) presetsModifiedTime = toki.second();
+    if (finalname.equals("/presets.json")) {
+      presetsModifiedTime = toki.second();
+      discardPresetLog(); // uploaded file replaces all presets (also stops compaction)
+    }
   }
   if (len) {
     request->_tempFile.write(data,len);
   }
   if (final) {
     request->_tempFile.close();
+    if (filename.indexOf(F("presets.json")) >= 0) {
+      discardPresetLog(); // index is rebuilt on next access
+      clearPresetCache();
+    }
     if (filename.indexOf(F("cfg.json")) >= 0) { // check for filename with or without slash
       doReboot = true;
       request->send(200, "text/plain", F("Configuration restore successful.\nRebooting..."));
     } else {
       if (filename.indexOf(F("palette")) >= 0 && filename.indexOf(F(".json")) >= 0) strip.loadCustomPalettes();
+      if (filename.indexOf(F("ledmap")) >= 0 && filename.indexOf(F(".json")) >= 0) removeLedmapCache(filename);
       request->send(200, "text/plain", F("File Uploaded!"));
     }
     cacheInvalidate++;
@@ -177,15 +185,25 @@ void initServer()
     bool verboseResponse = false;
     bool isConfig = false;
 
-    if (!requestJSONBufferLock(14)) return;
+    // parse into a pool arena without holding the JSON buffer lock, lock is only taken to apply it
+    JsonDocument *arena = acquireJSONArena(14);
+    if (!arena && !requestJSONBufferLock(14)) return;
+    JsonDocument &reqDoc = arena ? *arena : doc;
+    auto release = [arena]() { releaseJSONBufferLock(); if (arena) releaseJSONArena(arena); };
 
-    DeserializationError error = deserializeJson(doc, (uint8_t*)(request->_tempObject));
-    JsonObject root = doc.as<JsonObject>();
+    DeserializationError error = deserializeJson(reqDoc, (uint8_t*)(request->_tempObject));
+    JsonObject root = reqDoc.as<JsonObject>();
     if (error || root.isNull()) {
-      releaseJSONBufferLock();
+      if (arena) releaseJSONArena(arena);
+      else       releaseJSONBufferLock();
       request->send(400, "application/json", F("{\"error\":9}")); // ERR_JSON
       return;
     }
+    if (arena && !lockJSONState(14, arena)) {
+      releaseJSONArena(arena);
+      request->send(503, "application/json", F("{\"error\":3}"));
+      return;
+    }
     if (root.containsKey("pin")) checkSettingsPIN(root["pin"].as<const char*>());
 
     const String& url = request->url();
@@ -202,12 +220,12 @@ void initServer()
     } else {
       if (!correctPIN && strlen(settingsPIN)>0) {
         request->send(401, "application/json", F("{\"error\":1}")); // ERR_DENIED
-        releaseJSONBufferLock();
+        release();
         return;
       }
       verboseResponse = deserializeConfig(root); //use verboseResponse to determine whether cfg change should be saved immediately
     }
-    releaseJSONBufferLock();
+    release();
 
     if (verboseResponse) {
       if (!isConfig) {
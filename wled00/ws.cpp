@@ -7,9 +7,116 @@
 
 uint16_t wsLiveClientId = 0;
 unsigned long wsLastLiveTime = 0;
+uint16_t wsRtStatsClientId = 0;
+unsigned long wsLastRtStatsTime = 0;
 //uint8_t* wsFrameBuffer = nullptr;
 
 #define WS_LIVE_INTERVAL 40
+#define WS_RTSTATS_INTERVAL 1000
+
+// live view protocol version 3 (full resolution, XOR/RLE deltas against the last acknowledged frame)
+#define WS_LIVE_KEYFRAME    64    // force a keyframe after this many deltas
+#define WS_LIVE_ACK_TIMEOUT 1000  // resend a keyframe if no acknowledgement within this time (ms)
+#define WS_LIVE_MAX_INTERVAL 1000
+
+static bool     wsLiveDelta = false;       // client requested version 3
+static uint8_t *wsLiveRef = nullptr;       // RGB of the last frame acknowledged by the client
+static uint8_t *wsLivePending = nullptr;   // RGB of the frame in flight
+static size_t   wsLiveCount = 0;           // pixels in above buffers
+static bool     wsLiveHasRef = false;
+static bool     wsLiveAwaitAck = false;
+static uint8_t  wsLiveSeq = 0;
+static uint8_t  wsLiveSinceKey = 0;
+static uint16_t wsLiveInterval = WS_LIVE_INTERVAL;
+// set from wsEvent() (async_tcp task on ESP32), buffers are only touched by handleWs() (loop)
+static volatile bool    wsLiveResetReq = false; // client (un)subscribed or disconnected, free buffers
+static volatile int16_t wsLiveAckReq = -1;      // sequence number acknowledged by the client (-1 = none)
+
+static void freeLiveDelta()
+{
+  free(wsLiveRef);
+  free(wsLivePending);
+  wsLiveRef = wsLivePending = nullptr;
+  wsLiveCount = 0;
+  wsLiveHasRef = wsLiveAwaitAck = false;
+  wsLiveInterval = WS_LIVE_INTERVAL;
+}
+
+// client acknowledged frame seq: it becomes the reference for the next delta (loop only)
+static void ackLiveDelta(uint8_t seq)
+{
+  if (!wsLiveAwaitAck || seq != wsLiveSeq) return;
+  std::swap(wsLiveRef, wsLivePending);
+  wsLiveHasRef = true;
+  wsLiveAwaitAck = false;
+  if (wsLiveInterval > WS_LIVE_INTERVAL) wsLiveInterval -= (wsLiveInterval - WS_LIVE_INTERVAL +7) >> 3; // speed up again
+}
+
+// incoming messages that could not be applied immediately because state was locked (parsed into pool arenas)
+// ring buffer: filled from wsEvent() (async_tcp task on ESP32), emptied by handleWs() (loop)
+static JsonDocument     *wsPending[WLED_JSON_ARENAS];
+static uint32_t          wsPendingClient[WLED_JSON_ARENAS];
+static volatile uint8_t  wsPendingHead = 0, wsPendingTail = 0;
+
+static inline bool wsQueueEmpty() { return wsPendingHead == wsPendingTail; }
+
+static bool queueWsMessage(JsonDocument *arena, uint32_t clientId)
+{
+  uint8_t tail = wsPendingTail;
+  if (uint8_t(tail - wsPendingHead) >= WLED_JSON_ARENAS) return false;
+  wsPending[tail % WLED_JSON_ARENAS] = arena;
+  wsPendingClient[tail % WLED_JSON_ARENAS] = clientId;
+  wsPendingTail = tail + 1;
+  DEBUG_PRINTLN(F("WS message queued."));
+  return true;
+}
+
+// applies received JSON (JSON buffer lock must be held), releases lock and arena (if any) and answers the client
+static void applyWsMessage(AsyncWebSocketClient * client, JsonObject root, JsonDocument *arena)
+{
+  bool verboseResponse = false;
+  if (root["v"] && root.size() == 1) {
+    //if the received value is just "{"v":true}", send only to this client
+    verboseResponse = true;
+  } else if (!client) {
+    // client disconnected while the message was queued, subscriptions are void
+    if (!root.containsKey("lv") && !root.containsKey("rt")) deserializeState(root);
+  } else if (root.containsKey("lv")) {
+    wsLiveResetReq = true;
+    wsLiveDelta = root["lv"].is<int>() && root["lv"].as<int>() >= 3;
+    wsLiveClientId = root["lv"] ? client->id() : 0;
+  } else if (root.containsKey("rt")) {
+    wsRtStatsClientId = root["rt"] ? client->id() : 0;
+  } else {
+    verboseResponse = deserializeState(root);
+  }
+  releaseJSONBufferLock(); // will clean fileDoc
+  if (arena) releaseJSONArena(arena);
+
+  if (client && !interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
+    if (verboseResponse) {
+      sendDataWs(client);
+    } else {
+      // we have to send something back otherwise WS connection closes
+      client->text(F("{\"success\":true}"));
+    }
+    // force broadcast in 500ms after updating client
+    //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
+  }
+}
+
+// called from handleWs(): apply queued messages in order of arrival
+static void handleWsQueue()
+{
+  while (!wsQueueEmpty()) {
+    uint8_t head = wsPendingHead;
+    JsonDocument *arena = wsPending[head % WLED_JSON_ARENAS];
+    if (!lockJSONState(11, arena, 0)) return; // try again next loop
+    AsyncWebSocketClient * client = ws.client(wsPendingClient[head % WLED_JSON_ARENAS]);
+    wsPendingHead = head + 1;
+    applyWsMessage(client, arena->as<JsonObject>(), arena);
+  }
+}
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
@@ -19,7 +126,8 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
-    if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    if (client->id() == wsLiveClientId) { wsLiveClientId = 0; wsLiveResetReq = true; }
+    if (client->id() == wsRtStatsClientId) wsRtStatsClientId = 0;
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
@@ -35,35 +143,28 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           return;
         }
 
-        bool verboseResponse = false;
-        if (!requestJSONBufferLock(11)) return;
+        // parse into a pool arena without holding the JSON buffer lock (legacy: parse into doc while locked)
+        JsonDocument *arena = acquireJSONArena(11);
+        if (!arena && !requestJSONBufferLock(11)) return;
+        JsonDocument &wsDoc = arena ? *arena : doc;
 
-        DeserializationError error = deserializeJson(doc, data, len);
-        JsonObject root = doc.as<JsonObject>();
+        DeserializationError error = deserializeJson(wsDoc, data, len);
+        JsonObject root = wsDoc.as<JsonObject>();
         if (error || root.isNull()) {
-          releaseJSONBufferLock();
+          if (arena) releaseJSONArena(arena);
+          else       releaseJSONBufferLock();
           return;
         }
-        if (root["v"] && root.size() == 1) {
-          //if the received value is just "{"v":true}", send only to this client
-          verboseResponse = true;
-        } else if (root.containsKey("lv")) {
-          wsLiveClientId = root["lv"] ? client->id() : 0;
-        } else {
-          verboseResponse = deserializeState(root);
-        }
-        releaseJSONBufferLock(); // will clean fileDoc
-
-        if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
-          if (verboseResponse) {
-            sendDataWs(client);
-          } else {
-            // we have to send something back otherwise WS connection closes
-            client->text(F("{\"success\":true}"));
+        if (arena) {
+          // state is busy (i.e. loop() applying a preset): hand message over to handleWs() instead of waiting here
+          if (!wsQueueEmpty() || !lockJSONState(11, arena, 0)) {
+            if (queueWsMessage(arena, client->id())) return;
+            if (!lockJSONState(11, arena)) { releaseJSONArena(arena); return; }
           }
-          // force broadcast in 500ms after updating client
-          //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
         }
+        applyWsMessage(client, root, arena);
+      } else if (info->opcode == WS_BINARY && len == 2 && data[0] == 'A' && client->id() == wsLiveClientId) {
+        wsLiveAckReq = data[1]; // live view (version 3) frame acknowledgement, applied by handleWs()
       }
     } else {
       //message is comprised of multiple frames or the frame is split into multiple packets
@@ -101,20 +202,29 @@ void sendDataWs(AsyncWebSocketClient * client)
   if (!ws.count()) return;
   AsyncWebSocketMessageBuffer * buffer;
 
-  if (!requestJSONBufferLock(12)) return;
+  // serialize into a pool arena if one is free, JSON buffer lock is then released as soon as state was read
+  JsonDocument *arena = acquireJSONArena(12);
+  if (!(arena ? lockJSONState(12, arena) : requestJSONBufferLock(12))) {
+    if (arena) releaseJSONArena(arena);
+    return;
+  }
+  JsonDocument &wsDoc = arena ? *arena : doc;
+  auto release = [arena]() { if (arena) releaseJSONArena(arena); else releaseJSONBufferLock(); };
 
-  JsonObject state = doc.createNestedObject("state");
+  JsonObject state = wsDoc.createNestedObject("state");
   serializeState(state);
-  JsonObject info  = doc.createNestedObject("info");
+  JsonObject info  = wsDoc.createNestedObject("info");
   serializeInfo(info);
+  if (arena) releaseJSONBufferLock();
 
-  size_t len = measureJson(doc);
-  DEBUG_PRINTF("JSON buffer size: %u for WS request (%u).\n", doc.memoryUsage(), len);
+  size_t len = measureJson(wsDoc);
+  DEBUG_PRINTF("JSON buffer size: %u for WS request (%u).\n", wsDoc.memoryUsage(), len);
 
   size_t heap1 = ESP.getFreeHeap();
   DEBUG_PRINT(F("heap ")); DEBUG_PRINTLN(ESP.getFreeHeap());
   #ifdef ESP8266
   if (len>heap1) {
+    release();
     DEBUG_PRINTLN(F("Out of memory (WS)!"));
     return;
   }
@@ -127,7 +237,7 @@ void sendDataWs(AsyncWebSocketClient * client)
   size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
   #endif
   if (!buffer || heap1-heap2<len) {
-    releaseJSONBufferLock();
+    release();
     DEBUG_PRINTLN(F("WS buffer allocation failed."));
     ws.closeAll(1013); //code 1013 = temporary overload, try again later
     ws.cleanupClients(0); //disconnect all clients to release memory
@@ -136,7 +246,8 @@ void sendDataWs(AsyncWebSocketClient * client)
   }
 
   buffer->lock();
-  serializeJson(doc, (char *)buffer->get(), len);
+  serializeJson(wsDoc, (char *)buffer->get(), len);
+  release();
 
   DEBUG_PRINT(F("Sending WS data "));
   if (client) {
@@ -148,8 +259,6 @@ void sendDataWs(AsyncWebSocketClient * client)
   }
   buffer->unlock();
   ws._cleanBuffers();
-
-  releaseJSONBufferLock();
 }
 
 bool sendLiveLedsWs(uint32_t wsClient)
@@ -212,8 +321,130 @@ bool sendLiveLedsWs(uint32_t wsClient)
   return true;
 }
 
+/*
+ * Encodes cur as XOR/RLE delta against ref (nullptr = all black, i.e. keyframe). Control byte:
+ * 0x00-0x7F: skip (n+1) unchanged pixels, 0x80-0xFF: (n&0x7F)+1 pixels follow as 3 XOR bytes each.
+ * Returns encoded length; if out is nullptr only the length is computed.
+ */
+static size_t encodeLiveDelta(const uint8_t *cur, const uint8_t *ref, size_t count, uint8_t *out)
+{
+  auto unchanged = [&](size_t i) {
+    const uint8_t *c = cur + i*3;
+    return ref ? (c[0] == ref[i*3] && c[1] == ref[i*3+1] && c[2] == ref[i*3+2]) : !(c[0] | c[1] | c[2]);
+  };
+  size_t len = 0;
+  for (size_t i = 0; i < count; ) {
+    bool same = unchanged(i);
+    size_t run = 1;
+    while (run < 128 && i + run < count && unchanged(i + run) == same) run++;
+    if (out) out[len] = same ? run -1 : 0x80 | (run -1);
+    len++;
+    if (!same) {
+      if (out) for (size_t j = 0; j < run*3; j++) out[len + j] = cur[i*3 + j] ^ (ref ? ref[i*3 + j] : 0);
+      len += run*3;
+    }
+    i += run;
+  }
+  return len;
+}
+
+// live view version 3: 'L', 3, flags (bit 0: keyframe), seq, width (LE16), height (LE16), delta (see above)
+// the client acknowledges each frame with binary ['A', seq]; only one frame is in flight at any time
+bool sendLiveDeltaWs(uint32_t wsClient)
+{
+  static unsigned long lastSent = 0;
+  AsyncWebSocketClient * wsc = ws.client(wsClient);
+  if (!wsc) return false;
+  if (millis() - lastSent < wsLiveInterval) return true;
+  if (wsLiveAwaitAck) {
+    if (millis() - lastSent < WS_LIVE_ACK_TIMEOUT) return true;
+    wsLiveHasRef = wsLiveAwaitAck = false; // frame (or its acknowledgement) was lost, start over
+  }
+  if (wsc->queueLength() > 0) { // client or network cannot keep up, slow down
+    wsLiveInterval = MIN(wsLiveInterval * 2, WS_LIVE_MAX_INTERVAL);
+    lastSent = millis();
+    return true;
+  }
+
+  size_t width = strip.getLengthTotal(), height = 1;
+#ifndef WLED_DISABLE_2D
+  if (strip.isMatrix) {
+    width  = Segment::maxWidth;
+    height = Segment::maxHeight;
+  }
+#endif
+  size_t count = width * height;
+  if (count != wsLiveCount) {
+    freeLiveDelta();
+    wsLiveRef     = (uint8_t*)malloc(count*3);
+    wsLivePending = (uint8_t*)malloc(count*3);
+    if (!wsLiveRef || !wsLivePending) { freeLiveDelta(); wsLiveDelta = false; return false; } // fall back to subsampled view
+    wsLiveCount = count;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t c = strip.getPixelColor(i);
+    uint8_t w = W(c);
+    wsLivePending[i*3]   = scale8(qadd8(w, R(c)), strip.getBrightness()); //R, add white channel to RGB channels as a simple RGBW -> RGB map
+    wsLivePending[i*3+1] = scale8(qadd8(w, G(c)), strip.getBrightness()); //G
+    wsLivePending[i*3+2] = scale8(qadd8(w, B(c)), strip.getBrightness()); //B
+  }
+
+  bool key = !wsLiveHasRef || wsLiveSinceKey >= WS_LIVE_KEYFRAME;
+  size_t len = encodeLiveDelta(wsLivePending, key ? nullptr : wsLiveRef, count, nullptr);
+  if (!key) {
+    size_t keyLen = encodeLiveDelta(wsLivePending, nullptr, count, nullptr);
+    if (keyLen <= len) { key = true; len = keyLen; }
+  }
+
+  AsyncWebSocketMessageBuffer * wsBuf = ws.makeBuffer(8 + len);
+  if (!wsBuf) return false; //out of memory
+  uint8_t* buffer = wsBuf->get();
+  buffer[0] = 'L';
+  buffer[1] = 3; //version
+  buffer[2] = key;
+  buffer[3] = ++wsLiveSeq;
+  buffer[4] = width;
+  buffer[5] = width >> 8;
+  buffer[6] = height;
+  buffer[7] = height >> 8;
+  encodeLiveDelta(wsLivePending, key ? nullptr : wsLiveRef, count, buffer + 8);
+  wsc->binary(wsBuf);
+
+  wsLiveSinceKey = key ? 0 : wsLiveSinceKey + 1;
+  wsLiveAwaitAck = true;
+  lastSent = millis();
+  return true;
+}
+
+// binary realtime statistics message (see fillRtStatsBinary())
+bool sendRtStatsWs(uint32_t wsClient)
+{
+  AsyncWebSocketClient * wsc = ws.client(wsClient);
+  if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
+
+  uint8_t buffer[rtStatsBinarySize()];
+  size_t len = fillRtStatsBinary(buffer);
+  AsyncWebSocketMessageBuffer * wsBuf = ws.makeBuffer(len);
+  if (!wsBuf) return false; //out of memory
+  memcpy(wsBuf->get(), buffer, len);
+  wsc->binary(wsBuf);
+  return true;
+}
+
 void handleWs()
 {
+  handleWsQueue();
+  if (wsLiveResetReq) {
+    wsLiveResetReq = false;
+    wsLiveAckReq = -1;
+    freeLiveDelta();
+  }
+  int16_t ack = wsLiveAckReq;
+  if (ack >= 0) {
+    wsLiveAckReq = -1;
+    ackLiveDelta(ack);
+  }
   if (millis() - wsLastLiveTime > WS_LIVE_INTERVAL)
   {
     #ifdef ESP8266
@@ -222,10 +453,14 @@ void handleWs()
     ws.cleanupClients();
     #endif
     bool success = true;
-    if (wsLiveClientId) success = sendLiveLedsWs(wsLiveClientId);
+    if (wsLiveClientId) success = wsLiveDelta ? sendLiveDeltaWs(wsLiveClientId) : sendLiveLedsWs(wsLiveClientId);
     wsLastLiveTime = millis();
     if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
   }
+  if (wsRtStatsClientId && realtimeStats && millis() - wsLastRtStatsTime > WS_RTSTATS_INTERVAL)
+  {
+    if (sendRtStatsWs(wsRtStatsClientId)) wsLastRtStatsTime = millis();
+  }
 }
 
 #else
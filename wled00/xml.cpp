@@ -372,6 +372,7 @@ void getSettingsJS(byte subPage, char* dest)
       char aw[4] = "AW"; aw[2] = 48+s; aw[3] = 0; //auto white mode
       char wo[4] = "WO"; wo[2] = 48+s; wo[3] = 0; //swap channels
       char sp[4] = "SP"; sp[2] = 48+s; sp[3] = 0; //bus clock speed
+      char ma[4] = "MA"; ma[2] = 48+s; ma[3] = 0; //bus max current
       oappend(SET_F("addLEDs(1);"));
       uint8_t pins[5];
       uint8_t nPins = bus->getPins(pins);
@@ -388,6 +389,7 @@ void getSettingsJS(byte subPage, char* dest)
       sappend('c',rf,bus->isOffRefreshRequired());
       sappend('v',aw,bus->getAutoWhiteMode());
       sappend('v',wo,bus->getColorOrder() >> 4);
+      sappend('v',ma,bus->getMaxCurrent());
       uint16_t speed = bus->getFrequency();
       if (bus->getType() > TYPE_ONOFF && bus->getType() < 48) {
         switch (speed) {
@@ -443,6 +445,7 @@ void getSettingsJS(byte subPage, char* dest)
     dtostrf(gammaCorrectVal,3,1,nS); sappends('s',SET_F("GV"),nS);
     sappend('c',SET_F("TF"),fadeTransition);
     sappend('c',SET_F("EB"),modeBlending);
+    sappend('c',SET_F("EBB"),modeBlendBuffers);
     sappend('v',SET_F("TD"),transitionDelayDefault);
     sappend('c',SET_F("PF"),strip.paletteFade);
     sappend('v',SET_F("TP"),randomPaletteChangeTime);
@@ -491,11 +494,13 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('c',SET_F("RX"),receiveNotificationEffects);
     sappend('c',SET_F("SO"),receiveSegmentOptions);
     sappend('c',SET_F("SG"),receiveSegmentBounds);
+    sappend('c',SET_F("CK"),clockSyncEnabled);
     sappend('c',SET_F("SD"),notifyDirectDefault);
     sappend('c',SET_F("SB"),notifyButton);
     sappend('c',SET_F("SH"),notifyHue);
     sappend('c',SET_F("SM"),notifyMacro);
     sappend('v',SET_F("UR"),udpNumRetries);
+    sappend('c',SET_F("SV"),notifierDelta);
 
     sappend('c',SET_F("NL"),nodeListEnabled);
     sappend('c',SET_F("NB"),nodeBroadcastEnabled);
@@ -510,10 +515,18 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('v',SET_F("XX"),DMXSegmentSpacing);
     sappend('v',SET_F("PY"),e131Priority);
     sappend('v',SET_F("DM"),DMXMode);
+    sappend('v',SET_F("FT"),realtimeFrameTimeout);
+    sappend('v',SET_F("EO"),e131OutUniverse);
+    sappend('v',SET_F("EQ"),e131OutPriority);
+    sappend('v',SET_F("EY"),e131OutSyncUniverse);
+    sappend('v',SET_F("EI"),realtimeOutPacing);
     sappend('v',SET_F("ET"),realtimeTimeoutMs);
     sappend('c',SET_F("FB"),arlsForceMaxBri);
     sappend('c',SET_F("RG"),arlsDisableGammaCorrection);
+    sappend('c',SET_F("TS"),realtimeStats);
     sappend('v',SET_F("WO"),arlsOffset);
+    sappend('v',SET_F("RP"),udpRxMaxPackets);
+    sappend('v',SET_F("RM"),udpRxBudgetMs);
     sappend('c',SET_F("AL"),alexaEnabled);
     sappends('s',SET_F("AI"),alexaInvocationName);
     sappend('c',SET_F("SA"),notifyAlexa);